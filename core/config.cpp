@@ -4,6 +4,9 @@
 
 #include <unistd.h>
 
+#include <algorithm>
+#include <fstream>
+
 #include "fmt/format.h"
 
 void Config::init(const std::string f) {
@@ -19,7 +22,68 @@ void Config::init(const std::string f) {
     exit_on_error();
   }
 
-  data = toml::parse(filename);
+  table.clear();
+
+  if (load_snapshot(filename)) {
+    return;
+  }
+
+  resolve_all(toml::parse(filename));
+}
+
+Config::Value Config::resolve(const toml::value& v) {
+  Value val;
+
+  if (v.is_boolean()) {
+    val.kind = Value::Kind::boolean;
+    val.b    = v.as_boolean();
+  } else if (v.is_integer()) {
+    val.kind = Value::Kind::integer;
+    val.i    = v.as_integer();
+  } else if (v.is_floating()) {
+    val.kind = Value::Kind::floating;
+    val.d    = v.as_floating();
+  } else if (v.is_string()) {
+    val.kind = Value::Kind::string;
+    val.s    = v.as_string();
+  } else if (v.is_array()) {
+    val.kind = Value::Kind::array;
+    for (const auto& e : v.as_array()) {
+      val.array.emplace_back(resolve(e));
+    }
+  }
+
+  return val;
+}
+
+void Config::resolve_all(const toml::value& root) {
+  if (!root.is_table()) {
+    return;
+  }
+
+  for (const auto& [block, sec] : root.as_table()) {
+    auto& fields = table[block];
+    if (!sec.is_table()) {
+      continue;
+    }
+    for (const auto& [name, v] : sec.as_table()) {
+      fields[name] = resolve(v);
+    }
+  }
+}
+
+const Config::Value* Config::find(const std::string& block, const std::string& name) {
+  auto it = table.find(block);
+  if (it == table.end()) {
+    return nullptr;
+  }
+
+  auto it2 = it->second.find(name);
+  if (it2 == it->second.end()) {
+    return nullptr;
+  }
+
+  return &it2->second;
 }
 
 void Config::exit_on_error() {
@@ -42,13 +106,13 @@ bool Config::check(const std::string& block, const std::string& name) {
     return false;
   }
 
-  if (!data.contains(block)) {
+  auto it = table.find(block);
+  if (it == table.end()) {
     errors.emplace_back(fmt::format("section [{}] not found -- add a [{}] section to '{}'", block, block, filename));
     return false;
   }
 
-  auto sec = toml::find(data, block);
-  if (!sec.contains(name)) {
+  if (!it->second.contains(name)) {
     errors.emplace_back(fmt::format("section [{}] is missing field '{}' -- add '{} = <value>' to [{}] in '{}'",
                                     block,
                                     name,
@@ -79,13 +143,13 @@ std::string Config::get_string(const std::string& block, const std::string& name
   }
 
   if (!env_used) {
-    auto ent = toml::find(data, block, name);
+    const auto& ent = *find(block, name);
     if (!ent.is_string()) {
       errors.emplace_back(fmt::format("conf:{} section:{} field:{} is not a string\n", filename, block, name));
       return "INVALID";
     }
 
-    val = ent.as_string();
+    val = ent.s;
     if (!allowed.empty()) {
       for (auto e : allowed) {
         auto same = std::equal(e.cbegin(), e.cend(), val.cbegin(), val.cend(), [](auto c1, auto c2) {
@@ -153,13 +217,17 @@ std::string Config::get_string(const std::string& block, const std::string& name
     }
   }
 
-  auto ent = toml::find(data, block2, name2);
+  if (block2.empty() || !check(block2, name2)) {
+    return "INVALID";
+  }
+
+  const auto& ent = *find(block2, name2);
   if (!ent.is_string()) {
     errors.emplace_back(fmt::format("conf:{} section:{} field:{} is not a string\n", filename, block, name));
     return "INVALID";
   }
 
-  std::string val{ent.as_string()};
+  std::string val{ent.s};
   if (!allowed.empty()) {
     for (auto e : allowed) {
       auto same = std::equal(e.cbegin(), e.cend(), val.cbegin(), val.cend(), [](auto c1, auto c2) {
@@ -202,17 +270,13 @@ int Config::get_integer(const std::string& block, const std::string& name, int f
   }
 
   if (!env_used) {
-    auto ent = toml::find(data, block, name);
-    if (!ent.is_integer() && !ent.is_floating()) {
+    const auto& ent = *find(block, name);
+    if (!ent.is_number()) {
       errors.emplace_back(fmt::format("conf:{} section:{} field:{} is not a integer\n", filename, block, name));
       return 0;
     }
 
-    if (ent.is_integer()) {
-      val = ent.as_integer();
-    } else {
-      val = ent.as_floating();
-    }
+    val = ent.as_integer();
   }
 
   if (val < from || val > to) {
@@ -250,17 +314,17 @@ int Config::get_integer(const std::string& block, const std::string& name, size_
   }
 
   if (!env_used) {
-    auto ent2 = toml::find(data, block2, name2);
-    if (!ent2.is_integer() && !ent2.is_floating()) {
-      errors.emplace_back(fmt::format("conf:{} section:{} field:{} is not a integer\n", filename, block2, name2));
+    if (!check(block2, name2)) {
       return 0;
     }
 
-    if (ent2.is_integer()) {
-      val = ent2.as_integer();
-    } else {
-      val = ent2.as_floating();
+    const auto& ent2 = *find(block2, name2);
+    if (!ent2.is_number()) {
+      errors.emplace_back(fmt::format("conf:{} section:{} field:{} is not a integer\n", filename, block2, name2));
+      return 0;
     }
+
+    val = ent2.as_integer();
   }
 
   if (val < from || val > to) {
@@ -284,13 +348,13 @@ size_t Config::get_array_size(const std::string& block, const std::string& name,
     return 0;
   }
 
-  auto ent = toml::find(data, block, name);
+  const auto& ent = *find(block, name);
   if (!ent.is_array()) {
     errors.emplace_back(fmt::format("conf:{} section:{} field:{} is not an array\n", filename, block, name));
     return 0;
   }
 
-  auto i = ent.as_array().size();
+  auto i = ent.array.size();
   if (i > max_size) {
     errors.emplace_back(fmt::format("conf:{} section:{} field:{} has too many entries\n", filename, block, name));
     return max_size;
@@ -304,31 +368,26 @@ int Config::get_array_integer(const std::string& block, const std::string& name,
     return 0;
   }
 
-  auto ent = toml::find(data, block, name);
+  const auto& ent = *find(block, name);
   if (!ent.is_array()) {
     errors.emplace_back(fmt::format("conf:{} section:{} field:{} is not an array\n", filename, block, name));
     return 0;
   }
 
-  if (ent.as_array().size() <= pos) {
+  if (ent.array.size() <= pos) {
     errors.emplace_back(
-        fmt::format("conf:{} section:{} out of bounds {} array of size {}\n", filename, block, name, ent.as_array().size(), pos));
+        fmt::format("conf:{} section:{} out of bounds {} array of size {}\n", filename, block, name, ent.array.size(), pos));
     return 0;
   }
 
-  auto arr = ent.as_array();
+  const auto& arr = ent.array;
 
-  if (!arr[pos].is_integer() && !arr[pos].is_floating()) {
+  if (!arr[pos].is_number()) {
     errors.emplace_back(fmt::format("conf:{} section:{} array entry is not integer\n", filename, block, name));
     return 0;
   }
 
-  int val;
-  if (arr[pos].is_integer()) {
-    val = arr[pos].as_integer();
-  } else {
-    val = arr[pos].as_floating();
-  }
+  int val = arr[pos].as_integer();
 
   add_used(block, name, pos, fmt::format("{}", val), true);
   return val;
@@ -339,26 +398,26 @@ std::string Config::get_array_string(const std::string& block, const std::string
     return "INVALID";
   }
 
-  auto ent = toml::find(data, block, name);
+  const auto& ent = *find(block, name);
   if (!ent.is_array()) {
     errors.emplace_back(fmt::format("conf:{} section:{} field:{} is not an array\n", filename, block, name));
     return "INVALID";
   }
 
-  if (ent.as_array().size() <= pos) {
+  if (ent.array.size() <= pos) {
     errors.emplace_back(
-        fmt::format("conf:{} section:{} out of bounds {} array of size {}\n", filename, block, name, ent.as_array().size(), pos));
+        fmt::format("conf:{} section:{} out of bounds {} array of size {}\n", filename, block, name, ent.array.size(), pos));
     return "INVALID";
   }
 
-  auto arr = ent.as_array();
+  const auto& arr = ent.array;
 
   if (!arr[pos].is_string()) {
     errors.emplace_back(fmt::format("conf:{} section:{} array entry is not string\n", filename, block, name));
     return "INVALID";
   }
 
-  std::string val = arr[pos].as_string();
+  std::string val = arr[pos].s;
   std::transform(val.begin(), val.end(), val.begin(), [](unsigned char c) { return std::tolower(c); });
 
   add_used(block, name, pos, val, true);
@@ -366,44 +425,75 @@ std::string Config::get_array_string(const std::string& block, const std::string
   return val;
 }
 
-void Config::add_error(const std::string& err) { errors.emplace_back(err); }
+double Config::get_array_double(const std::string& block, const std::string& name, size_t pos) {
+  if (!check(block, name)) {
+    return 0;
+  }
 
-bool Config::has_entry(const std::string& block, const std::string& name) {
-  if (block.empty()) {
-    return false;
+  const auto& ent = *find(block, name);
+  if (!ent.is_array()) {
+    errors.emplace_back(fmt::format("conf:{} section:{} field:{} is not an array\n", filename, block, name));
+    return 0;
   }
 
-  if (!data.contains(block)) {
-    return false;
+  if (ent.array.size() <= pos) {
+    errors.emplace_back(
+        fmt::format("conf:{} section:{} out of bounds {} array of size {}\n", filename, block, name, ent.array.size(), pos));
+    return 0;
+  }
+
+  const auto& arr = ent.array;
+
+  if (!arr[pos].is_number()) {
+    errors.emplace_back(fmt::format("conf:{} section:{} array entry is not a number\n", filename, block, name));
+    return 0;
   }
 
-  auto sec = toml::find(data, block);
-  return sec.contains(name);
+  double val = arr[pos].as_double();
+
+  add_used(block, name, pos, fmt::format("{}", val), true);
+  return val;
 }
 
-bool Config::has_entry(const std::string& block, const std::string& name, size_t pos, const std::string& name2) {
-  if (!has_entry(block, name)) {
+void Config::set_string(const std::string& block, const std::string& name, const std::string& val) {
+  auto it = table.find(block);
+  if (it == table.end()) {
+    errors.emplace_back(fmt::format("section [{}] not found, could not set field '{}' in '{}'", block, name, filename));
+    return;
+  }
+
+  auto& ent = it->second[name];
+  ent       = Value();
+  ent.kind  = Value::Kind::string;
+  ent.s     = val;
+}
+
+void Config::add_error(const std::string& err) { errors.emplace_back(err); }
+
+bool Config::has_entry(const std::string& block, const std::string& name) {
+  if (block.empty()) {
     return false;
   }
 
-  auto ent = toml::find(data, block, name);
-  if (!ent.is_array()) {
+  return find(block, name) != nullptr;
+}
+
+bool Config::has_entry(const std::string& block, const std::string& name, size_t pos, const std::string& name2) {
+  const auto* ent = find(block, name);
+  if (ent == nullptr || !ent->is_array()) {
     return false;
   }
 
-  auto ent_array = ent.as_array();
-  if (ent_array.size() <= pos) {
+  if (ent->array.size() <= pos) {
     return false;
   }
 
-  const auto t_block2 = ent_array[pos];
+  const auto& t_block2 = ent->array[pos];
   if (!t_block2.is_string()) {
     return false;
   }
 
-  auto ent2 = toml::find(data, t_block2.as_string());
-
-  return ent2.contains(name2);
+  return find(t_block2.s, name2) != nullptr;
 }
 
 bool Config::get_bool(const std::string& block, const std::string& name) {
@@ -425,13 +515,13 @@ bool Config::get_bool(const std::string& block, const std::string& name) {
   }
 
   if (!env_used) {
-    auto ent = toml::find(data, block, name);
+    const auto& ent = *find(block, name);
     if (!ent.is_boolean()) {
       errors.emplace_back(fmt::format("conf:{} section:{} field:{} is not a boolean\n", filename, block, name));
       return false;
     }
 
-    val = ent.as_boolean();
+    val = ent.b;
   }
 
   add_used(block, name, 0, val ? "true" : "false");
@@ -444,27 +534,27 @@ bool Config::get_bool(const std::string& block, const std::string& name, size_t
     return false;
   }
 
-  auto ent = toml::find(data, block, name);
+  const auto& ent = *find(block, name);
   if (!ent.is_array()) {
     errors.emplace_back(
         fmt::format("conf:{} section:{} field:{} is not a array needed to chain to {}\n", filename, block, name, name2));
     return false;
   }
 
-  auto ent_array = ent.as_array();
+  const auto& ent_array = ent.array;
 
   if (ent_array.size() <= pos) {
     errors.emplace_back(fmt::format("conf:{} section:{} field:{} out-of-bounds array access {}\n", filename, block, name, pos));
     return false;
   }
 
-  const auto t_block2 = ent_array[pos];
+  const auto& t_block2 = ent_array[pos];
   if (!t_block2.is_string()) {
     errors.emplace_back(fmt::format("conf:{} section:{} field:{} should point to a section\n", filename, block, name));
     return false;
   }
 
-  std::string block2{t_block2.as_string()};
+  std::string block2{t_block2.s};
 
   bool env_used = false;
   bool val      = false;
@@ -479,13 +569,17 @@ bool Config::get_bool(const std::string& block, const std::string& name, size_t
   }
 
   if (!env_used) {
-    auto ent2 = toml::find(data, block2, name2);
+    if (!check(block2, name2)) {
+      return false;
+    }
+
+    const auto& ent2 = *find(block2, name2);
     if (!ent2.is_boolean()) {
       errors.emplace_back(fmt::format("conf:{} section:{} field:{} is not a boolean\n", filename, block2, name2));
       return false;
     }
 
-    val = ent2.as_boolean();
+    val = ent2.b;
   }
 
   add_used(block2, name2, pos, val ? "true" : "false");
@@ -515,26 +609,26 @@ std::string Config::get_block2(const std::string& block, const std::string& name
     return "";
   }
 
-  auto ent = toml::find(data, block, name);
+  const auto& ent = *find(block, name);
   if (!ent.is_array()) {
     errors.emplace_back(fmt::format("conf:{} section:{} field:{} is not a array needed to chain\n", filename, block, name));
     return "";
   }
 
-  auto ent_array = ent.as_array();
+  const auto& ent_array = ent.array;
 
   if (ent_array.size() <= pos) {
     errors.emplace_back(fmt::format("conf:{} section:{} field:{} out-of-bounds array access {}\n", filename, block, name, pos));
     return "";
   }
 
-  const auto t_block2 = ent_array[pos];
+  const auto& t_block2 = ent_array[pos];
   if (!t_block2.is_string()) {
     errors.emplace_back(fmt::format("conf:{} section:{} field:{} should point to a section\n", filename, block, name));
     return "";
   }
 
-  auto val = t_block2.as_string();
+  const auto& val = t_block2.s;
 
   add_used(block, name, pos, val, true);
 
@@ -609,3 +703,148 @@ int Config::get_power2(const std::string& block, const std::string& name, size_t
 
   return check_power2(block, name, v);
 }
+
+/* snapshot {{{1 */
+//
+// Little endian binary copy of the resolved table:
+//
+//   header:  snapshot_magic, uint32 version, uint32 nsections
+//   section: string name, uint32 nfields, nfields * (string name, value)
+//   value:   uint8 kind, then bool as uint8, int64, double, string, or
+//            uint32 n + n values for arrays
+//   string:  uint32 size + bytes
+
+template <typename T>
+static void snap_put(std::ofstream& ofs, T v) {
+  ofs.write(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+static void snap_put_string(std::ofstream& ofs, const std::string& s) {
+  snap_put<uint32_t>(ofs, s.size());
+  ofs.write(s.data(), s.size());
+}
+
+template <typename T>
+static bool snap_get(std::ifstream& ifs, T& v) {
+  return static_cast<bool>(ifs.read(reinterpret_cast<char*>(&v), sizeof(v)));
+}
+
+static bool snap_get_string(std::ifstream& ifs, std::string& s) {
+  uint32_t sz;
+  if (!snap_get(ifs, sz)) {
+    return false;
+  }
+  s.resize(sz);
+  return static_cast<bool>(ifs.read(s.data(), sz));
+}
+
+static void snap_put_value(std::ofstream& ofs, const Config::Value& v) {
+  snap_put<uint8_t>(ofs, static_cast<uint8_t>(v.kind));
+  switch (v.kind) {
+    case Config::Value::Kind::boolean: snap_put<uint8_t>(ofs, v.b); break;
+    case Config::Value::Kind::integer: snap_put<int64_t>(ofs, v.i); break;
+    case Config::Value::Kind::floating: snap_put<double>(ofs, v.d); break;
+    case Config::Value::Kind::string: snap_put_string(ofs, v.s); break;
+    case Config::Value::Kind::array:
+      snap_put<uint32_t>(ofs, v.array.size());
+      for (const auto& e : v.array) {
+        snap_put_value(ofs, e);
+      }
+      break;
+    default: break;
+  }
+}
+
+static bool snap_get_value(std::ifstream& ifs, Config::Value& v) {
+  uint8_t kind;
+  if (!snap_get(ifs, kind) || kind > static_cast<uint8_t>(Config::Value::Kind::other)) {
+    return false;
+  }
+  v.kind = static_cast<Config::Value::Kind>(kind);
+
+  switch (v.kind) {
+    case Config::Value::Kind::boolean: {
+      uint8_t b;
+      if (!snap_get(ifs, b)) {
+        return false;
+      }
+      v.b = b != 0;
+    } break;
+    case Config::Value::Kind::integer: return snap_get(ifs, v.i);
+    case Config::Value::Kind::floating: return snap_get(ifs, v.d);
+    case Config::Value::Kind::string: return snap_get_string(ifs, v.s);
+    case Config::Value::Kind::array: {
+      uint32_t n;
+      if (!snap_get(ifs, n)) {
+        return false;
+      }
+      v.array.resize(n);
+      for (auto& e : v.array) {
+        if (!snap_get_value(ifs, e)) {
+          return false;
+        }
+      }
+    } break;
+    default: break;
+  }
+
+  return true;
+}
+
+bool Config::save_snapshot(const std::string& f) {
+  std::ofstream ofs(f, std::ios::binary);
+  if (!ofs) {
+    errors.emplace_back(fmt::format("could not write configuration snapshot {}", f));
+    return false;
+  }
+
+  ofs.write(snapshot_magic, sizeof(snapshot_magic));
+  snap_put<uint32_t>(ofs, snapshot_version);
+  snap_put<uint32_t>(ofs, table.size());
+  for (const auto& [block, sec] : table) {
+    snap_put_string(ofs, block);
+    snap_put<uint32_t>(ofs, sec.size());
+    for (const auto& [name, v] : sec) {
+      snap_put_string(ofs, name);
+      snap_put_value(ofs, v);
+    }
+  }
+
+  return static_cast<bool>(ofs);
+}
+
+bool Config::load_snapshot(const std::string& f) {
+  std::ifstream ifs(f, std::ios::binary);
+
+  char magic[sizeof(snapshot_magic)];
+  if (!ifs.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), snapshot_magic)) {
+    return false;  // not a snapshot, parse it as TOML
+  }
+
+  uint32_t version;
+  uint32_t nsections;
+  if (!snap_get(ifs, version) || version != snapshot_version || !snap_get(ifs, nsections)) {
+    errors.emplace_back(fmt::format("configuration snapshot {} has an unsupported version", f));
+    exit_on_error();
+  }
+
+  for (uint32_t i = 0; i < nsections; ++i) {
+    std::string block;
+    uint32_t    nfields;
+    if (!snap_get_string(ifs, block) || !snap_get(ifs, nfields)) {
+      errors.emplace_back(fmt::format("configuration snapshot {} is truncated", f));
+      exit_on_error();
+    }
+    auto& sec = table[block];
+    for (uint32_t j = 0; j < nfields; ++j) {
+      std::string name;
+      if (!snap_get_string(ifs, name) || !snap_get_value(ifs, sec[name])) {
+        errors.emplace_back(fmt::format("configuration snapshot {} is truncated", f));
+        exit_on_error();
+      }
+    }
+  }
+
+  return true;
+}
+/* }}} */
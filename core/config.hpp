@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <cstdlib>
 #include <filesystem>
 #include <limits>
@@ -11,10 +12,44 @@
 #include "absl/container/flat_hash_map.h"
 #include "toml.hpp"
 
+// The configuration is resolved once at init: every field of every TOML
+// section becomes a typed Value in a section/field table, so the getters do
+// two string-keyed hash reads instead of walking (and copying) the TOML tree.
+// The resolved table can be saved as a binary snapshot (save_snapshot), and
+// init loads a snapshot directly when the file is one, skipping the TOML
+// parse. DESESC_section_field environment overrides still apply on top.
 class Config {
+public:
+  class Value {
+  public:
+    enum class Kind : uint8_t { boolean, integer, floating, string, array, other };
+
+    Kind               kind = Kind::other;
+    bool               b    = false;
+    int64_t            i    = 0;
+    double             d    = 0;
+    std::string        s;
+    std::vector<Value> array;
+
+    [[nodiscard]] bool is_number() const { return kind == Kind::integer || kind == Kind::floating; }
+    [[nodiscard]] bool is_string() const { return kind == Kind::string; }
+    [[nodiscard]] bool is_array() const { return kind == Kind::array; }
+    [[nodiscard]] bool is_boolean() const { return kind == Kind::boolean; }
+
+    // integer entries as is, floating ones truncated like the TOML getters
+    [[nodiscard]] int64_t as_integer() const { return kind == Kind::integer ? i : static_cast<int64_t>(d); }
+    [[nodiscard]] double  as_double() const { return kind == Kind::integer ? static_cast<double>(i) : d; }
+  };
+
+  using Section = absl::flat_hash_map<std::string, Value>;
+
+  static constexpr char     snapshot_magic[8] = {'D', 'E', 'S', 'E', 'S', 'C', 'C', 'F'};
+  static constexpr uint32_t snapshot_version  = 1;
+
 private:
   static inline std::string filename;
-  static inline toml::value data;
+
+  static inline absl::flat_hash_map<std::string, Section> table;
 
   static inline std::vector<std::string>                                                                     errors;
   static inline absl::flat_hash_map<std::string, absl::flat_hash_map<std::string, std::vector<std::string>>> used;
@@ -29,6 +64,13 @@ private:
 
   static std::string get_block2(const std::string& block, const std::string& name, size_t pos);
 
+  static Value resolve(const toml::value& v);
+  static void  resolve_all(const toml::value& root);
+
+  static const Value* find(const std::string& block, const std::string& name);
+
+  static bool load_snapshot(const std::string& f);
+
 protected:
 public:
   Config() = delete;  // No object instance. All methods are static
@@ -52,6 +94,10 @@ public:
   static size_t      get_array_size(const std::string& block, const std::string& name, size_t max_size = 1024);
   static int         get_array_integer(const std::string& block, const std::string& name, size_t pos);
   static std::string get_array_string(const std::string& block, const std::string& name, size_t pos);
+  static double      get_array_double(const std::string& block, const std::string& name, size_t pos);
+
+  // Replace (or add) a string field after init. Used by batch runs to retarget the same parsed configuration
+  static void set_string(const std::string& block, const std::string& name, const std::string& val);
 
   static void add_error(const std::string& err);
 
@@ -68,4 +114,7 @@ public:
 
   static bool has_errors() { return !errors.empty(); }
   static void dump(int fd);
+
+  // Binary copy of the resolved table, loaded by init() in place of a TOML file
+  static bool save_snapshot(const std::string& f);
 };
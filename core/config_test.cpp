@@ -22,6 +22,7 @@ protected:
     file << "[sec2]\n";
     file << "vfoo1 = [1,2,3]\n";
     file << "vfoo2 = [\"a\",\"b\"]\n";
+    file << "vfoo3 = [0.25, 1, 2.5]\n";
 
     file << "[sec3]\n";
     file << "vfoo1 = \"PoTaTo\"\n";
@@ -81,3 +82,37 @@ TEST_F(Config_test, indirect) {
   EXPECT_EQ(Config::get_string("base", "a", 0, "str"), "foo");
   EXPECT_EQ(Config::get_string("base", "a", 1, "str"), "bar");
 }
+
+TEST_F(Config_test, doubles_and_set) {
+  Config::init("config_test_sample.toml");
+
+  EXPECT_DOUBLE_EQ(Config::get_array_double("sec2", "vfoo3", 0), 0.25);
+  EXPECT_DOUBLE_EQ(Config::get_array_double("sec2", "vfoo3", 1), 1.0);
+  EXPECT_DOUBLE_EQ(Config::get_array_double("sec2", "vfoo3", 2), 2.5);
+
+  Config::set_string("sec1", "foo", "other");
+  EXPECT_EQ(Config::get_string("sec1", "foo"), "other");
+
+  Config::set_string("sec1", "new_field", "added");
+  EXPECT_TRUE(Config::has_entry("sec1", "new_field"));
+  EXPECT_EQ(Config::get_string("sec1", "new_field"), "added");
+}
+
+TEST_F(Config_test, snapshot) {
+  Config::init("config_test_sample.toml");
+  Config::set_string("sec1", "foo", "Snap");
+
+  EXPECT_TRUE(Config::save_snapshot("config_test_sample.snap"));
+
+  Config::init("config_test_sample.snap");
+
+  EXPECT_EQ(Config::get_string("sec1", "foo"), "snap");
+  EXPECT_EQ(Config::get_array_size("sec2", "vfoo1"), 3);
+  EXPECT_EQ(Config::get_array_integer("sec2", "vfoo1", 2), 3);
+  EXPECT_EQ(Config::get_array_string("sec2", "vfoo2", 1), "b");
+  EXPECT_DOUBLE_EQ(Config::get_array_double("sec2", "vfoo3", 2), 2.5);
+  EXPECT_EQ(Config::get_integer("int_test", "a"), -33);
+  EXPECT_EQ(Config::get_integer("base", "a", 1, "v"), 4);
+  EXPECT_EQ(Config::get_string("base", "a", 0, "str"), "foo");
+  EXPECT_FALSE(Config::has_entry("sec3", "vfoo_not"));
+}
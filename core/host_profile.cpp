@@ -0,0 +1,99 @@
+// See LICENSE for details.
+
+#include "host_profile.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include "config.hpp"
+#include "fmt/format.h"
+#include "report.hpp"
+
+std::deque<Host_profile::Slot>& Host_profile::slots() {
+  static std::deque<Slot> s;  // function static: slots are created during static init
+  return s;
+}
+
+Host_profile::Slot& Host_profile::get(const std::string& name) {
+  auto& s  = slots();
+  auto  it = std::find_if(s.begin(), s.end(), [&name](const Slot& e) { return e.name == name; });
+  if (it != s.end()) {
+    return *it;
+  }
+  s.emplace_back();
+  s.back().name = name;
+  return s.back();
+}
+
+void Host_profile::start() {
+  start_ns     = now_ns();
+  last_beat_ns = start_ns;
+
+  heartbeat_ns = 0;
+  if (Config::has_entry("soc", "heartbeat")) {
+    heartbeat_ns = static_cast<uint64_t>(Config::get_integer("soc", "heartbeat", 0, 86400)) * 1000000000ULL;
+  }
+
+  for (auto& e : slots()) {
+    e.calls      = 0;
+    e.sampled    = 0;
+    e.sampled_ns = 0;
+  }
+}
+
+void Host_profile::heartbeat(uint64_t clock, uint64_t insts_left) {
+  if (heartbeat_ns == 0) {
+    return;
+  }
+  auto now = now_ns();
+  if (now - last_beat_ns < heartbeat_ns) {
+    return;
+  }
+  last_beat_ns = now;
+
+  double secs  = 1e-9 * (now - start_ns);
+  auto   insts = get_insts();
+  double kips  = insts / secs / 1000;
+
+  std::string eta = "?";
+  if (kips > 0 && insts_left) {
+    auto left = static_cast<uint64_t>(insts_left / kips / 1000);
+    eta       = fmt::format("{}:{:02}:{:02}", left / 3600, (left / 60) % 60, left % 60);
+  }
+
+  fmt::print(stderr,
+             "heartbeat: {:.0f}s clock:{} insts:{} KIPS:{:.1f} KCPS:{:.1f} ETA:{}\n",
+             secs,
+             clock,
+             insts,
+             kips,
+             clock / secs / 1000,
+             eta);
+}
+
+void Host_profile::report(uint64_t clock) {
+  double secs = 1e-9 * (now_ns() - start_ns);
+  if (secs <= 0) {
+    return;
+  }
+
+  Report::field(fmt::format("OSSim:kcps={:.3f}", clock / secs / 1000));
+
+#ifndef DISABLE_HOST_PROFILE
+  Report::field(fmt::format("OSSim:kips={:.3f}", get_insts() / secs / 1000));
+
+  std::vector<const Slot*> sorted;
+  for (const auto& e : slots()) {
+    if (e.calls) {
+      sorted.push_back(&e);
+    }
+  }
+  std::sort(sorted.begin(), sorted.end(), [](const Slot* a, const Slot* b) { return a->get_msecs() > b->get_msecs(); });
+
+  for (const auto* e : sorted) {
+    Report::field(fmt::format("OSSim:host:{}:msecs={:.3f}", e->name, e->get_msecs()));
+    Report::field(fmt::format("OSSim:host:{}:calls={}", e->name, e->calls));
+  }
+#endif
+}
@@ -0,0 +1,81 @@
+// See LICENSE for details.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <string>
+
+// Host time spent in each simulator component (emulator, cores, event queue,
+// memory objects). A Host_scope reads the host clock in one of every
+// 2^sample_bits entries and scales the sampled time by the number of
+// entries, so most calls only increment a counter. Times are inclusive: a
+// core clock includes the emulator calls and the memory requests that it
+// starts inline.
+//
+// The report has the estimated msecs and calls per component, and the
+// simulated KIPS/KCPS. [soc] heartbeat = N prints the progress every N
+// seconds to stderr, with an ETA from the instructions left in the emuls.
+//
+// Build with -DDISABLE_HOST_PROFILE to compile the probes out.
+class Host_profile {
+public:
+  static constexpr uint32_t sample_bits = 6;
+  static constexpr uint64_t sample_mask = (1ULL << sample_bits) - 1;
+
+  class Slot {
+  public:
+    std::string name;
+    uint64_t    calls      = 0;
+    uint64_t    sampled    = 0;
+    uint64_t    sampled_ns = 0;
+
+    [[nodiscard]] double get_msecs() const { return sampled ? 1e-6 * sampled_ns * calls / sampled : 0; }
+  };
+
+  // Same slot for the same name. Slots never move, so callers keep the reference
+  static Slot& get(const std::string& name);
+
+  static uint64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  static void start();
+  static void heartbeat(uint64_t clock, uint64_t insts_left);
+  static void report(uint64_t clock);
+
+  static uint64_t get_insts() { return get("emul:execute").calls; }
+
+private:
+  static std::deque<Slot>& slots();
+
+  static inline uint64_t start_ns{0};
+  static inline uint64_t heartbeat_ns{0};  // 0 disables the heartbeat
+  static inline uint64_t last_beat_ns{0};
+};
+
+class Host_scope {
+#ifndef DISABLE_HOST_PROFILE
+private:
+  Host_profile::Slot& slot;
+  uint64_t            t0;
+  bool                sampled;
+
+public:
+  explicit Host_scope(Host_profile::Slot& s) : slot(s), t0(0), sampled((s.calls++ & Host_profile::sample_mask) == 0) {
+    if (sampled) {
+      t0 = Host_profile::now_ns();
+    }
+  }
+  ~Host_scope() {
+    if (sampled) {
+      slot.sampled++;
+      slot.sampled_ns += Host_profile::now_ns() - t0;
+    }
+  }
+#else
+public:
+  explicit Host_scope(Host_profile::Slot& s) { (void)s; }
+#endif
+};
@@ -8,10 +8,19 @@
 #include <unistd.h>
 
 #include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <thread>
 #include <vector>
 
+#include "callback.hpp"
+#include "config.hpp"
+#include "dinst.hpp"
 #include "iassert.hpp"
+#include "memobj.hpp"
+#include "memrequest.hpp"
 #include "pool.hpp"
+#include "report.hpp"
 #include "snippets.hpp"
 #include "threadsafefifo.hpp"
 
@@ -171,6 +180,209 @@ void tspool_test() {
   fprintf(stderr, "Total = %lld (135510418?)\n", total);
 }
 
+// Old pool backend: one ::new per object. The small allocations in between
+// mimic the rest of the simulator heap (strings, shared_ptrs) interleaved with
+// the pool reproduction.
+template <class Ttype>
+class heappool {
+  class Holder : public Ttype {
+  public:
+    Holder* holderNext;
+  };
+  Holder*            first;
+  const int32_t      Size;
+  std::vector<void*> noise;
+
+  void reproduce() {
+    for (int32_t i = 0; i < Size; i++) {
+      Holder* h     = ::new Holder;
+      h->holderNext = first;
+      first         = h;
+      noise.push_back(std::malloc(16 + (i * 7919) % 200));
+    }
+  }
+
+public:
+  heappool(int32_t s) : first(nullptr), Size(s) { reproduce(); }
+  ~heappool() {
+    while (first) {
+      Holder* h = first;
+      first     = first->holderNext;
+      ::delete h;
+    }
+    for (auto* n : noise) {
+      std::free(n);
+    }
+  }
+
+  void in(Ttype* data) {
+    Holder* h     = static_cast<Holder*>(data);
+    h->holderNext = first;
+    first         = h;
+  }
+  Ttype* out() {
+    if (first == nullptr) {
+      reproduce();
+    }
+    Holder* h = first;
+    first     = first->holderNext;
+    return h;
+  }
+};
+
+// Window of in flight objects released out of order (squashes, misses
+// completing out of order), so the free list gets shuffled over time. Every
+// few allocations all the in flight objects are dereferenced (select/retire
+// walks), which is where the object density matters. alloc/release/touch use
+// the real object API.
+template <class Ttype, class Alloc, class Release, class Touch>
+long long inflight_test(const char* str, Alloc alloc, Release release, Touch touch, int32_t window, int32_t niters) {
+  std::vector<Ttype*> inflight;
+  long long           total = 0;
+  uint32_t            rnd   = 12345;
+
+  start();
+  for (int32_t i = 0; i < niters; i++) {
+    inflight.push_back(alloc(i));
+
+    if (static_cast<int32_t>(inflight.size()) > window) {
+      rnd       = rnd * 1103515245 + 12345;
+      auto pos  = (rnd >> 8) % inflight.size();
+      release(inflight[pos]);
+      inflight[pos] = inflight.back();
+      inflight.pop_back();
+    }
+    if ((i & 63) == 0) {
+      for (const auto* x : inflight) {
+        total += touch(x);
+      }
+    }
+  }
+  finish(str, niters);
+
+  for (auto* o : inflight) {
+    release(o);
+  }
+  return total;
+}
+
+static Instruction bench_inst() {
+  return Instruction(Opcode::iLALU_LD, RegType::LREG_R1, RegType::LREG_R2, RegType::LREG_R3, RegType::LREG_R4);
+}
+
+// Dinst through its own pool (create/scrap), and through the three pool
+// backends to compare them with the real object layout
+void dinst_test() {
+  const int32_t window = 4096;
+  const int32_t niters = 8000000;
+
+  fprintf(stderr, "poolBench: sizeof(Dinst) = %zu\n", sizeof(Dinst));
+
+  auto touch = [](const Dinst* d) -> long long { return d->getPC() + d->getAddr(); };
+  inflight_test<Dinst>(
+      "Dinst create/scrap",
+      [](int32_t i) { return Dinst::create(bench_inst(), 0x1000 + 4 * i, 0x8000 + 64 * i, 0, true); },
+      [](Dinst* d) { d->scrap(); },
+      touch,
+      window,
+      niters);
+
+  auto issued = [](const Dinst* d) -> long long { return d->getIssuedTime(); };
+  auto mark   = [](Dinst* d) {
+    d->markIssuedTransient();
+    return d;
+  };
+  {
+    heappool<Dinst> p(32768);
+    inflight_test<Dinst>(
+        "Dinst heap", [&p, &mark](int32_t) { return mark(p.out()); }, [&p](Dinst* d) { p.in(d); }, issued, window, niters);
+  }
+  {
+    pool<Dinst> p(32768);
+    inflight_test<Dinst>(
+        "Dinst slab", [&p, &mark](int32_t) { return mark(p.out()); }, [&p](Dinst* d) { p.in(d); }, issued, window, niters);
+  }
+  {
+    mtpool<Dinst> p(32768);
+    inflight_test<Dinst>(
+        "Dinst mtpool", [&p, &mark](int32_t) { return mark(p.out()); }, [&p](Dinst* d) { p.in(d); }, issued, window, niters);
+  }
+}
+
+// MemRequest only through its own pool: the constructor is private to it
+void memrequest_test(MemObj* mobj) {
+  fprintf(stderr, "poolBench: sizeof(MemRequest) = %zu\n", sizeof(MemRequest));
+
+  inflight_test<MemRequest>(
+      "MemRequest create/destroy",
+      [mobj](int32_t i) { return MemRequest::createReqRead(mobj, true, 0x8000 + 64 * i, 0x1000); },
+      [](MemRequest* m) { m->destroy(); },
+      [](const MemRequest* m) -> long long { return m->getAddr(); },
+      256,
+      8000000);
+}
+
+void mtpool_threaded_test() {
+  mtpool<Dinst> p(2048);
+
+  const int32_t nthreads = 4;
+  const int32_t niters   = 4000000;
+
+  std::vector<std::thread> th;
+  start();
+  for (int32_t t = 0; t < nthreads; t++) {
+    th.emplace_back([&p]() {
+      std::deque<Dinst*> v;
+      for (int32_t i = 0; i < niters; i++) {
+        auto* o = p.out();
+        o->markIssuedTransient();
+        v.push_back(o);
+        if (v.size() > 64) {
+          p.in(v.front());
+          v.pop_front();
+        }
+      }
+      for (auto* o : v) {
+        p.in(o);
+      }
+    });
+  }
+  for (auto& t : th) {
+    t.join();
+  }
+  finish("Dinst mtpool 4 threads", nthreads * niters);
+}
+
+class CBTarget {
+public:
+  int64_t n = 0;
+  void    tick() { n++; }
+  using tickCB = CallbackMember0<CBTarget, &CBTarget::tick>;
+};
+
+void callback_test() {
+  CBTarget obj;
+
+  const int32_t window = 256;
+  const int32_t niters = 8000000;
+
+  std::deque<CBTarget::tickCB*> inflight;
+  start();
+  for (int32_t i = 0; i < niters; i++) {
+    inflight.push_back(CBTarget::tickCB::create(&obj));
+    if (static_cast<int32_t>(inflight.size()) > window) {
+      inflight.front()->call();
+      inflight.pop_front();
+    }
+  }
+  finish("CallbackMember0", niters);
+
+  for (auto* cb : inflight) {
+    cb->call();
+  }
+  fprintf(stderr, "Callbacks = %lld\n", (long long)obj.n);
+}
+
 ThreadSafeFIFO<DummyObjTest2> tsfifo;
 
 extern "C" void* bootstrap(void* threadargs) {
@@ -223,5 +435,19 @@ int main() {
   pool_test();
   test_tspool_threaded();
 
+  std::ofstream file("pool_bench.toml");
+  file << "[bench_obj]\n"
+          "type        = \"void\"\n"
+          "lower_level = \"\"\n";
+  file.close();
+  Report::init();
+  Config::init("pool_bench.toml");
+  DummyMemObj mobj("bench_obj", "bench_obj");
+
+  dinst_test();
+  memrequest_test(&mobj);
+  mtpool_threaded_test();
+  callback_test();
+
   return 0;
 }
@@ -0,0 +1,240 @@
+// See LICENSE for details.
+
+#include "pprof.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include "fmt/format.h"
+
+Pprof::Pprof(const std::string& sample_type, const std::string& sample_unit, std::vector<std::string> cause_names)
+    : type(sample_type), unit(sample_unit), causes(std::move(cause_names)) {}
+
+/* ELF symbols {{{1 */
+
+template <typename T>
+static T elf_read(const std::string& buf, uint64_t pos) {
+  T v{};
+  if (pos + sizeof(T) <= buf.size()) {
+    memcpy(&v, buf.data() + pos, sizeof(T));
+  }
+  return v;
+}
+
+bool Pprof::load_symbols(const std::string& elf) {
+  std::ifstream ifs(elf, std::ios::binary);
+  if (!ifs) {
+    return false;
+  }
+  std::string buf{std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>()};
+
+  // ELF64 little endian only (RISC-V 64 binaries)
+  if (buf.size() < 64 || buf.compare(0, 4, "\x7f" "ELF") != 0 || buf[4] != 2 || buf[5] != 1) {
+    return false;
+  }
+
+  auto shoff     = elf_read<uint64_t>(buf, 0x28);
+  auto shentsize = elf_read<uint16_t>(buf, 0x3A);
+  auto shnum     = elf_read<uint16_t>(buf, 0x3C);
+  if (shentsize < 64) {
+    return false;
+  }
+
+  constexpr uint32_t sht_symtab = 2;
+  constexpr uint32_t sht_dynsym = 11;
+  constexpr uint8_t  stt_func   = 2;
+
+  symbols.clear();
+  for (auto want : {sht_symtab, sht_dynsym}) {
+    for (uint16_t s = 0; s < shnum; ++s) {
+      uint64_t sh = shoff + static_cast<uint64_t>(s) * shentsize;
+      if (elf_read<uint32_t>(buf, sh + 4) != want) {
+        continue;
+      }
+      auto offset  = elf_read<uint64_t>(buf, sh + 24);
+      auto size    = elf_read<uint64_t>(buf, sh + 32);
+      auto link    = elf_read<uint32_t>(buf, sh + 40);
+      auto entsize = elf_read<uint64_t>(buf, sh + 56);
+      auto strtab  = elf_read<uint64_t>(buf, shoff + static_cast<uint64_t>(link) * shentsize + 24);
+      if (entsize < 24) {
+        continue;
+      }
+
+      for (uint64_t e = offset; e + entsize <= offset + size && e + entsize <= buf.size(); e += entsize) {
+        auto info  = elf_read<uint8_t>(buf, e + 4);
+        auto value = elf_read<uint64_t>(buf, e + 8);
+        if ((info & 0xF) != stt_func || value == 0) {
+          continue;
+        }
+        auto name = strtab + elf_read<uint32_t>(buf, e);
+        if (name >= buf.size()) {
+          continue;
+        }
+        symbols.emplace_back(Symbol{value, elf_read<uint64_t>(buf, e + 16), std::string(buf.c_str() + name)});
+      }
+    }
+    if (!symbols.empty()) {
+      break;  // the dynamic symbols only when the binary is stripped
+    }
+  }
+
+  std::sort(symbols.begin(), symbols.end(), [](const Symbol& a, const Symbol& b) { return a.start < b.start; });
+
+  return !symbols.empty();
+}
+
+std::string_view Pprof::get_symbol(uint64_t pc) const {
+  auto it = std::upper_bound(symbols.begin(), symbols.end(), pc, [](uint64_t a, const Symbol& s) { return a < s.start; });
+  if (it == symbols.begin()) {
+    return {};
+  }
+  --it;
+
+  // Symbols without size cover up to the next one
+  auto end = it->size ? it->start + it->size : (std::next(it) != symbols.end() ? std::next(it)->start : it->start + 1);
+  if (pc >= end) {
+    return {};
+  }
+
+  return it->name;
+}
+/* }}} */
+
+/* profile.proto encoding {{{1 */
+
+static void pb_varint(std::string& out, uint64_t v) {
+  while (v >= 0x80) {
+    out.push_back(static_cast<char>(v | 0x80));
+    v >>= 7;
+  }
+  out.push_back(static_cast<char>(v));
+}
+
+static void pb_int(std::string& out, uint32_t field, uint64_t v) {
+  pb_varint(out, field << 3);
+  pb_varint(out, v);
+}
+
+static void pb_bytes(std::string& out, uint32_t field, std::string_view v) {
+  pb_varint(out, (field << 3) | 2);
+  pb_varint(out, v.size());
+  out.append(v);
+}
+
+bool Pprof::write(const std::string& file) const {
+  // Profile fields
+  constexpr uint32_t f_sample_type  = 1;
+  constexpr uint32_t f_sample       = 2;
+  constexpr uint32_t f_location     = 4;
+  constexpr uint32_t f_function     = 5;
+  constexpr uint32_t f_string_table = 6;
+  constexpr uint32_t f_period_type  = 11;
+  constexpr uint32_t f_period       = 12;
+
+  std::vector<std::string_view>                    strings{""};
+  absl::flat_hash_map<std::string_view, uint64_t>  string_id{{"", 0}};
+  std::vector<std::string>                         addr_names;  // names of the PCs without symbol
+  absl::flat_hash_map<std::string_view, uint64_t>  function_id;
+  absl::flat_hash_map<uint64_t, uint64_t>          pc_location;
+  std::string                                      out;
+  std::string                                      msg;
+
+  auto intern = [&](std::string_view s) -> uint64_t {
+    auto [it, inserted] = string_id.try_emplace(s, strings.size());
+    if (inserted) {
+      strings.push_back(s);
+    }
+    return it->second;
+  };
+
+  auto value_type = [&](uint32_t field) {
+    msg.clear();
+    pb_int(msg, 1, intern(type));
+    pb_int(msg, 2, intern(unit));
+    pb_bytes(out, field, msg);
+  };
+
+  auto add_function = [&](std::string_view name) -> uint64_t {
+    auto [it, inserted] = function_id.try_emplace(name, function_id.size() + 1);
+    if (inserted) {
+      msg.clear();
+      pb_int(msg, 1, it->second);
+      pb_int(msg, 2, intern(name));
+      pb_int(msg, 3, intern(name));
+      pb_bytes(out, f_function, msg);
+    }
+    return it->second;
+  };
+
+  // locations 1..causes.size() are the cause frames, then one per PC
+  auto add_location = [&](uint64_t id, uint64_t address, uint64_t func) {
+    std::string line;
+    pb_int(line, 1, func);
+    msg.clear();
+    pb_int(msg, 1, id);
+    if (address) {
+      pb_int(msg, 3, address);
+    }
+    pb_bytes(msg, 4, line);
+    pb_bytes(out, f_location, msg);
+  };
+
+  value_type(f_sample_type);
+
+  for (size_t c = 0; c < causes.size(); ++c) {
+    add_location(c + 1, 0, add_function(causes[c]));
+  }
+
+  addr_names.reserve(samples.size());
+  for (const auto& [key, n] : samples) {
+    auto pc = key.second;
+    if (pc == 0 || pc_location.contains(pc)) {
+      continue;
+    }
+    auto name = get_symbol(pc);
+    if (name.empty()) {
+      addr_names.emplace_back(fmt::format("{:#x}", pc));
+      name = addr_names.back();
+    }
+    auto id = causes.size() + pc_location.size() + 1;
+    pc_location[pc] = id;
+    add_location(id, pc, add_function(name));
+  }
+
+  for (const auto& [key, n] : samples) {
+    if (key.first >= causes.size() || n == 0) {
+      continue;
+    }
+    std::string ids;
+    if (key.second) {
+      pb_varint(ids, pc_location[key.second]);  // leaf first
+    }
+    pb_varint(ids, key.first + 1);
+
+    std::string values;
+    pb_varint(values, static_cast<uint64_t>(n));
+
+    msg.clear();
+    pb_bytes(msg, 1, ids);
+    pb_bytes(msg, 2, values);
+    pb_bytes(out, f_sample, msg);
+  }
+
+  value_type(f_period_type);
+  pb_int(out, f_period, 1);
+
+  for (auto s : strings) {
+    pb_bytes(out, f_string_table, s);
+  }
+
+  std::ofstream ofs(file, std::ios::binary);
+  if (!ofs) {
+    return false;
+  }
+  ofs.write(out.data(), out.size());
+
+  return static_cast<bool>(ofs);
+}
+/* }}} */
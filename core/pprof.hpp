@@ -0,0 +1,51 @@
+// See LICENSE for details.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+
+// Profile of counts charged to a PC and a cause, written in the pprof format
+// (profile.proto) without gzip, which pprof reads as is. Each sample is a two
+// frame stack: the root frame is the cause (one of the names given at
+// construction) and the leaf frame the PC, so the top-down view splits the
+// count by cause and the flat view by PC. A sample with PC 0 has only the
+// cause frame.
+//
+// load_symbols() reads the function symbols of an ELF64 binary. Then each PC
+// is reported in its function (pprof -addresses still lists the PCs), and PCs
+// without symbol get a function named by their address.
+class Pprof {
+public:
+  Pprof(const std::string& sample_type, const std::string& sample_unit, std::vector<std::string> cause_names);
+
+  void add(size_t cause, uint64_t pc, int64_t n) { samples[{cause, pc}] += n; }
+
+  bool                           load_symbols(const std::string& elf);
+  [[nodiscard]] std::string_view get_symbol(uint64_t pc) const;  // empty if none
+  [[nodiscard]] size_t           get_num_symbols() const { return symbols.size(); }
+
+  [[nodiscard]] size_t get_num_samples() const { return samples.size(); }
+
+  bool write(const std::string& file) const;
+
+private:
+  class Symbol {
+  public:
+    uint64_t    start;
+    uint64_t    size;
+    std::string name;
+  };
+
+  const std::string        type;
+  const std::string        unit;
+  std::vector<std::string> causes;
+  std::vector<Symbol>      symbols;  // sorted by start
+
+  absl::flat_hash_map<std::pair<size_t, uint64_t>, int64_t> samples;
+};
@@ -0,0 +1,103 @@
+// This file is distributed under the BSD 3-Clause License. See LICENSE for details.
+
+#include "pprof.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+class Pprof_test : public ::testing::Test {
+protected:
+  // Top level fields of a profile.proto message: field number and payload
+  static std::vector<std::pair<uint32_t, std::string>> decode(const std::string& file) {
+    std::ifstream ifs(file, std::ios::binary);
+    std::string   buf{std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>()};
+
+    std::vector<std::pair<uint32_t, std::string>> fields;
+
+    size_t pos    = 0;
+    auto   varint = [&]() {
+      uint64_t v     = 0;
+      int      shift = 0;
+      while (pos < buf.size()) {
+        auto b = static_cast<uint8_t>(buf[pos++]);
+        v |= static_cast<uint64_t>(b & 0x7F) << shift;
+        if ((b & 0x80) == 0) {
+          break;
+        }
+        shift += 7;
+      }
+      return v;
+    };
+
+    while (pos < buf.size()) {
+      auto key = varint();
+      if ((key & 7) == 2) {
+        auto sz = varint();
+        fields.emplace_back(key >> 3, buf.substr(pos, sz));
+        pos += sz;
+      } else {
+        fields.emplace_back(key >> 3, std::to_string(varint()));
+      }
+    }
+
+    return fields;
+  }
+};
+
+TEST_F(Pprof_test, write) {
+  Pprof prof("slots", "count", {"Retire", "SmallROBStall", "Frontend"});
+
+  prof.add(0, 0x80000000, 3);
+  prof.add(0, 0x80000004, 1);
+  prof.add(1, 0x80000004, 2);
+  prof.add(2, 0, 5);
+  prof.add(0, 0x80000000, 1);
+
+  EXPECT_EQ(prof.get_num_samples(), 4);
+  EXPECT_TRUE(prof.get_symbol(0x80000000).empty());
+
+  ASSERT_TRUE(prof.write("pprof_test.pb"));
+
+  int                      nsamples   = 0;
+  int                      nlocations = 0;
+  int                      nfunctions = 0;
+  std::vector<std::string> strings;
+  for (const auto& [field, payload] : decode("pprof_test.pb")) {
+    switch (field) {
+      case 2: nsamples++; break;
+      case 4: nlocations++; break;
+      case 5: nfunctions++; break;
+      case 6: strings.push_back(payload); break;
+      default: break;
+    }
+  }
+
+  EXPECT_EQ(nsamples, 4);
+  EXPECT_EQ(nlocations, 5);  // 3 causes + 2 PCs
+  EXPECT_EQ(nfunctions, 5);
+  ASSERT_FALSE(strings.empty());
+  EXPECT_EQ(strings[0], "");
+  EXPECT_NE(std::find(strings.begin(), strings.end(), "SmallROBStall"), strings.end());
+  EXPECT_NE(std::find(strings.begin(), strings.end(), "0x80000004"), strings.end());
+  EXPECT_NE(std::find(strings.begin(), strings.end(), "slots"), strings.end());
+}
+
+TEST_F(Pprof_test, symbols) {
+  Pprof prof("slots", "count", {"Retire"});
+
+  EXPECT_FALSE(prof.load_symbols("pprof_test_missing.elf"));
+
+  std::ofstream ofs("pprof_test_not.elf");
+  ofs << "not an elf file";
+  ofs.close();
+  EXPECT_FALSE(prof.load_symbols("pprof_test_not.elf"));
+
+  // The test binary itself is an unstripped ELF64
+  EXPECT_TRUE(prof.load_symbols("/proc/self/exe"));
+  EXPECT_GT(prof.get_num_symbols(), 0);
+}
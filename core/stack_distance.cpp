@@ -0,0 +1,111 @@
+// See LICENSE for details.
+
+#include "stack_distance.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+/*********************** Stack_distance */
+
+Stack_distance::Stack_distance(size_t initial_window) : min_window(std::bit_ceil(std::max<size_t>(initial_window, 16))), now(0) {
+  tree.resize(min_window + 1, 0);
+}
+
+void Stack_distance::tree_add(uint64_t pos, int32_t v) {
+  for (auto i = pos + 1; i < tree.size(); i += i & (~i + 1)) {
+    tree[i] += v;
+  }
+}
+
+uint64_t Stack_distance::tree_prefix(uint64_t pos) const {
+  uint64_t total = 0;
+  for (auto i = pos + 1; i > 0; i -= i & (~i + 1)) {
+    total += tree[i];
+  }
+  return total;
+}
+
+void Stack_distance::compact() {
+  // Renumber the live lines 0..n-1 (keeping the LRU order) and restart the clock
+  std::vector<std::pair<uint64_t, uint64_t>> order;  // time, line
+  order.reserve(last.size());
+  for (const auto& [line, t] : last) {
+    order.emplace_back(t, line);
+  }
+  std::sort(order.begin(), order.end());
+
+  auto window = std::max(min_window, std::bit_ceil(2 * order.size() + 1));
+  tree.assign(window + 1, 0);
+
+  for (auto i = 0u; i < order.size(); ++i) {
+    last[order[i].second] = i;
+    tree[i + 1]           = 1;
+  }
+  // O(n) Fenwick construction
+  for (auto i = 1u; i < tree.size(); ++i) {
+    auto parent = i + (i & (~i + 1));
+    if (parent < tree.size()) {
+      tree[parent] += tree[i];
+    }
+  }
+
+  now = order.size();
+}
+
+uint64_t Stack_distance::access(uint64_t line) {
+  if (now + 1 >= tree.size()) {
+    compact();
+  }
+
+  uint64_t dist = COLD;
+
+  auto it = last.find(line);
+  if (it != last.end()) {
+    auto prev = it->second;
+    dist      = last.size() - tree_prefix(prev);
+    tree_add(prev, -1);
+    it->second = now;
+  } else {
+    last[line] = now;
+  }
+  tree_add(now, 1);
+  ++now;
+
+  return dist;
+}
+
+/*********************** Set_stack_distance */
+
+Set_stack_distance::Set_stack_distance(uint32_t nsets, uint32_t _max_assoc) : set_mask(nsets - 1), max_assoc(_max_assoc) {
+  I(nsets && (nsets & (nsets - 1)) == 0);
+  I(max_assoc > 0);
+
+  stacks.resize(static_cast<size_t>(nsets) * max_assoc, 0);
+  fill.resize(nsets, 0);
+}
+
+uint32_t Set_stack_distance::access(uint64_t line) {
+  auto  set   = line & set_mask;
+  auto* stack = &stacks[set * max_assoc];
+  auto& n     = fill[set];
+
+  uint32_t pos = 0;
+  while (pos < n && stack[pos] != line) {
+    ++pos;
+  }
+
+  auto dist = pos;
+  if (pos == n) {
+    dist = max_assoc;
+    if (n < max_assoc) {
+      ++n;
+    }
+    pos = n - 1;  // LRU entry is evicted if full
+  }
+
+  std::move_backward(stack, stack + pos, stack + pos + 1);
+  stack[0] = line;
+
+  return dist;
+}
@@ -0,0 +1,57 @@
+// See LICENSE for details.
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "iassert.hpp"
+
+// LRU stack distance (Mattson) for a fully associative cache. Each line keeps
+// its last access time in a hash, and a Fenwick tree counts the lines still
+// "live" at each time. The distance of an access is the number of distinct
+// lines touched since the previous access to the same line, O(log footprint).
+class Stack_distance {
+public:
+  static constexpr uint64_t COLD = std::numeric_limits<uint64_t>::max();
+
+  explicit Stack_distance(size_t initial_window = 1 << 16);
+
+  // Returns 0 for an MRU hit, COLD for the first access to a line
+  uint64_t access(uint64_t line);
+
+  [[nodiscard]] size_t footprint() const { return last.size(); }
+
+private:
+  absl::flat_hash_map<uint64_t, uint64_t> last;  // line -> last access time
+
+  std::vector<uint32_t> tree;  // Fenwick tree, 1-indexed over [0..window)
+  const size_t          min_window;
+  uint64_t              now;
+
+  void     tree_add(uint64_t pos, int32_t v);
+  uint64_t tree_prefix(uint64_t pos) const;  // number of live entries in [0..pos]
+  void     compact();
+};
+
+// Per set bounded LRU stacks. All the set-associative configurations with the
+// same number of sets share one instance: an access hits in a cache with A ways
+// iff the returned distance is smaller than A.
+class Set_stack_distance {
+public:
+  Set_stack_distance(uint32_t nsets, uint32_t max_assoc);
+
+  // Returns [0..max_assoc) on hit, max_assoc if it misses even with max_assoc ways
+  uint32_t access(uint64_t line);
+
+  [[nodiscard]] uint32_t get_nsets() const { return set_mask + 1; }
+
+private:
+  const uint64_t set_mask;
+  const uint32_t max_assoc;
+
+  std::vector<uint64_t> stacks;  // nsets x max_assoc, MRU first
+  std::vector<uint32_t> fill;
+};
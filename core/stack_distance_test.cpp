@@ -0,0 +1,73 @@
+// This file is distributed under the BSD 3-Clause License. See LICENSE for details.
+
+#include "stack_distance.hpp"
+
+#include <algorithm>
+#include <list>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+class Stack_distance_test : public ::testing::Test {
+protected:
+  // Reference LRU stack: distance is the position in the list
+  static uint64_t ref_access(std::list<uint64_t>& stack, uint64_t line) {
+    auto     it   = std::find(stack.begin(), stack.end(), line);
+    uint64_t dist = Stack_distance::COLD;
+    if (it != stack.end()) {
+      dist = std::distance(stack.begin(), it);
+      stack.erase(it);
+    }
+    stack.push_front(line);
+    return dist;
+  }
+};
+
+TEST_F(Stack_distance_test, simple) {
+  Stack_distance sd;
+
+  EXPECT_EQ(sd.access(1), Stack_distance::COLD);
+  EXPECT_EQ(sd.access(2), Stack_distance::COLD);
+  EXPECT_EQ(sd.access(3), Stack_distance::COLD);
+  EXPECT_EQ(sd.access(3), 0);
+  EXPECT_EQ(sd.access(1), 2);
+  EXPECT_EQ(sd.access(2), 2);
+  EXPECT_EQ(sd.footprint(), 3);
+}
+
+TEST_F(Stack_distance_test, random_vs_reference) {
+  Stack_distance      sd(16);  // tiny window to force many compactions
+  std::list<uint64_t> ref;
+
+  std::mt19937                            gen(33);
+  std::uniform_int_distribution<uint64_t> dist(0, 300);
+
+  for (int i = 0; i < 20000; ++i) {
+    auto line = dist(gen);
+    EXPECT_EQ(sd.access(line), ref_access(ref, line));
+  }
+}
+
+TEST_F(Stack_distance_test, set_associative) {
+  constexpr uint32_t NSETS = 4;
+  constexpr uint32_t ASSOC = 8;
+
+  Set_stack_distance               ssd(NSETS, ASSOC);
+  std::vector<std::list<uint64_t>> ref(NSETS);
+
+  std::mt19937                            gen(7);
+  std::uniform_int_distribution<uint64_t> dist(0, 100);
+
+  for (int i = 0; i < 20000; ++i) {
+    auto line     = dist(gen);
+    auto expected = ref_access(ref[line % NSETS], line);
+    if (expected >= ASSOC) {
+      expected = ASSOC;
+    }
+    if (ref[line % NSETS].size() > ASSOC) {
+      ref[line % NSETS].pop_back();
+    }
+    EXPECT_EQ(ssd.access(line), expected);
+  }
+}
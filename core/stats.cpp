@@ -5,6 +5,7 @@
 #include "config.hpp"
 #include "fmt/format.h"
 #include "report.hpp"
+#include "stats_mirror.hpp"
 
 /*********************** Stats */
 
@@ -28,6 +29,11 @@ void Stats::unsubscribe() {
   if (it != store.end()) {
     store.erase(it);
   }
+
+  if (mirror_pos >= 0) {
+    Stats_mirror::forget(mirror_pos);
+    mirror_pos = -1;
+  }
 }
 
 void Stats::report_all() {
@@ -40,6 +46,20 @@ void Stats::report_all() {
   Report::field(fmt::format("#END Stats"));
 }
 
+double Stats::get_cntr(const std::string& str) {
+  auto it = store.find(str);
+  if (it == store.end()) {
+    return 0;
+  }
+
+  const auto* cntr = dynamic_cast<const Stats_cntr*>(it->second);
+  if (cntr == nullptr) {
+    return 0;
+  }
+
+  return cntr->get_value();
+}
+
 void Stats::reset_all() {
   for (auto& e : store) {
     e.second->reset();
@@ -15,6 +15,10 @@ class Stats {
 private:
   static inline absl::flat_hash_map<std::string, Stats*> store;
 
+  int32_t mirror_pos{-1};  // entry in Stats_mirror, -1 if not mirrored
+
+  friend class Stats_mirror;
+
 protected:
   const std::string name;
 
@@ -28,8 +32,14 @@ public:
   static void report_all();
   static void reset_all();
 
+  // Value of a registered Stats_cntr (0 if not found). Used to summarize runs without parsing the report
+  static double get_cntr(const std::string& name);
+
   virtual void report() const = 0;
   virtual void reset()        = 0;
+
+  // Single value for Stats_mirror
+  [[nodiscard]] virtual double get_value() const { return 0; }
 };
 
 class Stats_pwr : public Stats {
@@ -46,6 +56,8 @@ public:
     cntr_real += transient ? 0 : 1;
   }
 
+  [[nodiscard]] double get_value() const final { return cntr_real; }
+
   void report() const final;
   void reset() final;
 };
@@ -68,6 +80,8 @@ public:
 
   void dec(bool en) { data -= en ? 1 : 0; }
 
+  [[nodiscard]] double get_value() const final { return data; }
+
   void report() const final;
   void reset() final;
 };
@@ -84,6 +98,8 @@ public:
   void sample(const double v, bool en);
   void sample(bool en, const double v) = delete;
 
+  [[nodiscard]] double get_value() const final { return nData ? data / nData : 0; }
+
   void report() const final;
   void reset() final;
 };
@@ -100,6 +116,8 @@ public:
   void sample(const double v, bool en);
   void sample(bool en, const double v) = delete;
 
+  [[nodiscard]] double get_value() const final { return maxValue; }
+
   void report() const final;
   void reset() final;
 };
@@ -118,6 +136,8 @@ public:
   void sample(int32_t key, bool enable, double weight = 1);
   void sample(bool enable, uint32_t key, double weight = 1) = delete;
 
+  [[nodiscard]] double get_value() const final { return numSample ? cumulative / numSample : 0; }
+
   void report() const final;
   void reset() final;
 };
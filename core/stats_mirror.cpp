@@ -0,0 +1,208 @@
+// See LICENSE for details.
+
+#include "stats_mirror.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#include "config.hpp"
+#include "fmt/format.h"
+#include "host_profile.hpp"
+#include "stats.hpp"
+
+bool Stats_mirror::open(const std::string& path) {
+  close();
+
+  entries.clear();
+  for (const auto& e : Stats::store) {
+    entries.push_back(e.second);
+  }
+  std::sort(entries.begin(), entries.end(), [](const Stats* a, const Stats* b) { return a->name < b->name; });
+
+  uint64_t names_size = 0;
+  for (const auto* e : entries) {
+    names_size += e->name.size() + 1;
+  }
+  uint64_t names_offset  = (sizeof(Header) + 63) & ~63ULL;
+  uint64_t values_offset = (names_offset + names_size + 7) & ~7ULL;
+  uint64_t size          = values_offset + entries.size() * sizeof(double);
+
+  int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    return false;
+  }
+  if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+    ::close(fd);
+    return false;
+  }
+  void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (base == MAP_FAILED) {
+    return false;
+  }
+
+  auto* names = static_cast<char*>(base) + names_offset;
+  for (size_t i = 0; i < entries.size(); ++i) {
+    const auto& n = entries[i]->name;
+    memcpy(names, n.c_str(), n.size() + 1);
+    names += n.size() + 1;
+    entries[i]->mirror_pos = static_cast<int32_t>(i);
+  }
+
+  values = reinterpret_cast<double*>(static_cast<char*>(base) + values_offset);
+  for (size_t i = 0; i < entries.size(); ++i) {
+    values[i] = entries[i]->get_value();
+  }
+
+  header = new (base) Header{};
+  header->nstats        = static_cast<uint32_t>(entries.size());
+  header->names_offset  = names_offset;
+  header->values_offset = values_offset;
+  header->size          = size;
+  header->pid           = static_cast<uint64_t>(getpid());
+  header->version       = version;
+  memcpy(header->magic, magic, sizeof(magic));  // last, readers check it first
+
+  file     = path;
+  start_ns = Host_profile::now_ns();
+
+  return true;
+}
+
+void Stats_mirror::start() {
+  if (!Config::has_entry("soc", "stats_mirror")) {
+    return;
+  }
+
+  auto path = fmt::format("/dev/shm/{}.{}", Config::get_string("soc", "stats_mirror"), getpid());
+  if (!open(path)) {
+    fmt::print(stderr, "could not create stats mirror {}\n", path);
+  }
+}
+
+void Stats_mirror::update(uint64_t clock, uint64_t insts) {
+  if (header == nullptr) {
+    return;
+  }
+
+  auto seq = header->seq.load(std::memory_order_relaxed);
+  header->seq.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  for (size_t i = 0; i < entries.size(); ++i) {
+    if (entries[i]) {
+      std::atomic_ref<double>(values[i]).store(entries[i]->get_value(), std::memory_order_relaxed);
+    }
+  }
+  std::atomic_ref<uint64_t>(header->clock).store(clock, std::memory_order_relaxed);
+  std::atomic_ref<uint64_t>(header->insts).store(insts, std::memory_order_relaxed);
+  std::atomic_ref<uint64_t>(header->host_ns).store(Host_profile::now_ns() - start_ns, std::memory_order_relaxed);
+  std::atomic_ref<uint64_t>(header->updates).store(header->updates + 1, std::memory_order_relaxed);
+
+  header->seq.store(seq + 2, std::memory_order_release);
+}
+
+void Stats_mirror::close() {
+  if (header == nullptr) {
+    return;
+  }
+
+  auto seq = header->seq.load(std::memory_order_relaxed);
+  header->seq.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  std::atomic_ref<uint64_t>(header->done).store(1, std::memory_order_relaxed);
+  header->seq.store(seq + 2, std::memory_order_release);
+
+  munmap(header, header->size);
+
+  for (auto* e : entries) {
+    if (e) {
+      e->mirror_pos = -1;
+    }
+  }
+  entries.clear();
+  header = nullptr;
+  values = nullptr;
+}
+
+void Stats_mirror::forget(int32_t pos) {
+  if (pos >= 0 && static_cast<size_t>(pos) < entries.size()) {
+    entries[pos] = nullptr;
+  }
+}
+
+bool Stats_mirror::read(const void* base, size_t size, Header& h, std::vector<std::string>& names, std::vector<double>& vals) {
+  if (size < sizeof(Header)) {
+    return false;
+  }
+
+  auto* src = static_cast<Header*>(const_cast<void*>(base));
+  if (memcmp(src->magic, magic, sizeof(magic)) != 0 || src->version != version || src->size > size) {
+    return false;
+  }
+
+  // The layout comes from the file: check it before following any offset
+  uint64_t names_offset  = src->names_offset;
+  uint64_t values_offset = src->values_offset;
+  uint64_t nstats        = src->nstats;
+  if (names_offset < sizeof(Header) || names_offset > values_offset || values_offset > src->size || values_offset % sizeof(double)
+      || nstats > (src->size - values_offset) / sizeof(double)) {
+    return false;
+  }
+
+  const auto* bytes = static_cast<const char*>(base);
+
+  names.clear();
+  const char* n   = bytes + names_offset;
+  const char* end = bytes + values_offset;
+  for (uint64_t i = 0; i < nstats; ++i) {
+    const auto* nul = static_cast<const char*>(memchr(n, '\0', end - n));
+    if (nul == nullptr) {
+      return false;  // names overflow into the values
+    }
+    names.emplace_back(n, nul);
+    n = nul + 1;
+  }
+
+  auto* vsrc = reinterpret_cast<double*>(const_cast<char*>(bytes) + values_offset);
+  vals.resize(nstats);
+
+  memcpy(h.magic, src->magic, sizeof(magic));
+  h.version       = src->version;
+  h.nstats        = nstats;
+  h.names_offset  = names_offset;
+  h.values_offset = values_offset;
+  h.size          = src->size;
+  h.pid           = src->pid;
+
+  for (int retry = 0; retry < read_retries; ++retry) {
+    auto seq = src->seq.load(std::memory_order_acquire);
+    if (seq & 1) {
+      std::this_thread::yield();  // writer in the middle of an update
+      continue;
+    }
+
+    for (uint64_t i = 0; i < nstats; ++i) {
+      vals[i] = std::atomic_ref<double>(vsrc[i]).load(std::memory_order_relaxed);
+    }
+    h.clock   = std::atomic_ref<uint64_t>(src->clock).load(std::memory_order_relaxed);
+    h.insts   = std::atomic_ref<uint64_t>(src->insts).load(std::memory_order_relaxed);
+    h.host_ns = std::atomic_ref<uint64_t>(src->host_ns).load(std::memory_order_relaxed);
+    h.updates = std::atomic_ref<uint64_t>(src->updates).load(std::memory_order_relaxed);
+    h.done    = std::atomic_ref<uint64_t>(src->done).load(std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (src->seq.load(std::memory_order_relaxed) == seq) {
+      h.seq.store(seq, std::memory_order_relaxed);
+      return true;
+    }
+  }
+
+  return false;
+}
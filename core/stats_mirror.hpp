@@ -0,0 +1,70 @@
+// See LICENSE for details.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Stats;
+
+// Live copy of the Stats values in a shared memory file, for watching long
+// runs without SIGUSR1 reports. [soc] stats_mirror = "name" creates
+// /dev/shm/name.<pid> when the simulation starts, with the names of all the
+// registered Stats, and the values are copied every 64K cycles (with the
+// heartbeat check). The update is a few stores and no syscall; a reader takes
+// a consistent copy with the seqlock in the header. desesc_stats (main/)
+// prints and diffs the counters of a mirror file.
+//
+// Stats created after open() are not in the mirror, and Stats destroyed
+// before close() keep their last value.
+class Stats_mirror {
+public:
+  static constexpr char     magic[8] = {'D', 'E', 'S', 'E', 'S', 'C', 'S', 'T'};
+  static constexpr uint32_t version  = 1;
+
+  // Start of the file. names_offset has nstats NUL terminated names, and
+  // values_offset nstats doubles in the same order. seq is odd while the
+  // simulator updates the values and the fields after it.
+  class Header {
+  public:
+    char                  magic[8];
+    uint32_t              version;
+    uint32_t              nstats;
+    uint64_t              names_offset;
+    uint64_t              values_offset;
+    uint64_t              size;
+    uint64_t              pid;
+    std::atomic<uint64_t> seq;
+    uint64_t              clock;    // globalClock of the last update
+    uint64_t              insts;    // instructions executed
+    uint64_t              host_ns;  // host time since open
+    uint64_t              updates;
+    uint64_t              done;  // 1 after close
+  };
+  static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+  static bool open(const std::string& path);
+  static void start();  // open the [soc] stats_mirror file, if any
+  static void update(uint64_t clock, uint64_t insts);
+  static void close();
+
+  static void forget(int32_t pos);  // a mirrored Stats is destroyed
+
+  [[nodiscard]] static bool is_open() { return header != nullptr; }
+
+  static constexpr int read_retries = 100000;  // tries with the writer updating before read gives up
+
+  // Consistent copy of the values of a mapped mirror, retrying while the
+  // writer is updating them. False if the file is not a valid mirror, or if
+  // an update never finishes (the writer died in the middle of it)
+  static bool read(const void* base, size_t size, Header& h, std::vector<std::string>& names, std::vector<double>& vals);
+
+private:
+  static inline Header*             header{nullptr};
+  static inline double*             values{nullptr};
+  static inline std::vector<Stats*> entries;
+  static inline std::string         file;
+  static inline uint64_t            start_ns{0};
+};
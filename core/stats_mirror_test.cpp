@@ -0,0 +1,137 @@
+// This file is distributed under the BSD 3-Clause License. See LICENSE for details.
+
+#include "stats_mirror.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "stats.hpp"
+
+class Stats_mirror_test : public ::testing::Test {
+protected:
+  static bool read(const std::string& path, Stats_mirror::Header& h, std::vector<std::string>& names, std::vector<double>& vals) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return false;
+    }
+    struct stat st;
+    fstat(fd, &st);
+    void* base = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+      return false;
+    }
+
+    bool ok = Stats_mirror::read(base, st.st_size, h, names, vals);
+    munmap(base, st.st_size);
+    return ok;
+  }
+};
+
+TEST_F(Stats_mirror_test, update) {
+  Stats_cntr cntr("mirror_test:cntr");
+  Stats_avg  avg("mirror_test:avg");
+  auto       gone = std::make_unique<Stats_cntr>("mirror_test:gone");
+
+  ASSERT_TRUE(Stats_mirror::open("stats_mirror_test.shm"));
+
+  cntr.add(5);
+  avg.sample(2, true);
+  avg.sample(4, true);
+  gone->inc();
+  Stats_mirror::update(100, 50);
+
+  gone.reset();  // keeps its last value
+  cntr.inc();
+  Stats_mirror::update(200, 80);
+
+  Stats_mirror::Header     h;
+  std::vector<std::string> names;
+  std::vector<double>      vals;
+  ASSERT_TRUE(read("stats_mirror_test.shm", h, names, vals));
+
+  EXPECT_EQ(h.clock, 200);
+  EXPECT_EQ(h.insts, 80);
+  EXPECT_EQ(h.updates, 2);
+  EXPECT_EQ(h.done, 0);
+  EXPECT_EQ(h.seq.load() & 1, 0);
+
+  auto value = [&](const std::string& n) {
+    for (size_t i = 0; i < names.size(); ++i) {
+      if (names[i] == n) {
+        return vals[i];
+      }
+    }
+    return -1.0;
+  };
+  EXPECT_DOUBLE_EQ(value("mirror_test:cntr"), 6);
+  EXPECT_DOUBLE_EQ(value("mirror_test:avg"), 3);
+  EXPECT_DOUBLE_EQ(value("mirror_test:gone"), 1);
+
+  Stats_mirror::close();
+  ASSERT_TRUE(read("stats_mirror_test.shm", h, names, vals));
+  EXPECT_EQ(h.done, 1);
+}
+
+TEST_F(Stats_mirror_test, not_a_mirror) {
+  char buf[sizeof(Stats_mirror::Header)] = {};
+
+  Stats_mirror::Header     h;
+  std::vector<std::string> names;
+  std::vector<double>      vals;
+  EXPECT_FALSE(Stats_mirror::read(buf, sizeof(buf), h, names, vals));
+  EXPECT_FALSE(Stats_mirror::read(buf, 8, h, names, vals));
+}
+
+TEST_F(Stats_mirror_test, bad_layout) {
+  Stats_cntr cntr("mirror_test:layout");
+
+  ASSERT_TRUE(Stats_mirror::open("stats_mirror_layout.shm"));
+  Stats_mirror::update(10, 5);
+
+  // Private copy of the file to corrupt, aligned for the header atomics
+  struct stat st;
+  int         fd = open("stats_mirror_layout.shm", O_RDONLY);
+  ASSERT_GE(fd, 0);
+  fstat(fd, &st);
+  std::vector<uint64_t> good((st.st_size + 7) / 8);
+  ASSERT_EQ(::read(fd, good.data(), st.st_size), st.st_size);
+  close(fd);
+  Stats_mirror::close();
+
+  Stats_mirror::Header     h;
+  std::vector<std::string> names;
+  std::vector<double>      vals;
+  size_t                   size = st.st_size;
+  ASSERT_TRUE(Stats_mirror::read(good.data(), size, h, names, vals));
+
+  auto corrupt = [&](auto&& change) {
+    auto  buf = good;
+    auto* hdr = reinterpret_cast<Stats_mirror::Header*>(buf.data());
+    change(*hdr, reinterpret_cast<char*>(buf.data()));
+    return Stats_mirror::read(buf.data(), size, h, names, vals);
+  };
+
+  EXPECT_FALSE(corrupt([&](Stats_mirror::Header& x, char*) { x.names_offset = size + 64; }));
+  EXPECT_FALSE(corrupt([&](Stats_mirror::Header& x, char*) { x.names_offset = 8; }));
+  EXPECT_FALSE(corrupt([&](Stats_mirror::Header& x, char*) { x.values_offset = size + 8; }));
+  EXPECT_FALSE(corrupt([&](Stats_mirror::Header& x, char*) { x.values_offset += 1; }));
+  EXPECT_FALSE(corrupt([&](Stats_mirror::Header& x, char*) { x.nstats = UINT32_MAX; }));
+  EXPECT_FALSE(corrupt([&](Stats_mirror::Header& x, char*) { x.size = size + 1; }));
+
+  // A name without its NUL runs into the values
+  EXPECT_FALSE(corrupt([&](Stats_mirror::Header& x, char* b) {
+    memset(b + x.names_offset, 'a', x.values_offset - x.names_offset);
+  }));
+
+  // A writer that died in the middle of an update
+  EXPECT_FALSE(corrupt([&](Stats_mirror::Header& x, char*) { x.seq.store(x.seq.load() + 1); }));
+}
@@ -11,9 +11,19 @@
 
 pool<Dinst> Dinst::dInstPool(32768, "Dinst");  // 4 * tsfifo size
 
+// Host footprint of Dinst (384 bytes in release before the hot/cold split).
+// The trace data lives in the cold record, so ESESC_TRACE_DATA does not change
+// it; debug builds add mreq_id. core/pool_bench.cpp prints it.
+#ifdef NDEBUG
+static_assert(sizeof(Dinst) <= 280, "Dinst grew, check the hot/cold layout");
+#else
+static_assert(sizeof(Dinst) <= 288, "Dinst grew, check the hot/cold layout");
+#endif
+
 Dinst::Dinst()
     : inst(Instruction(Opcode::iOpInvalid, RegType::LREG_R0, RegType::LREG_R0, RegType::LREG_InvalidOutput,
-                       RegType::LREG_InvalidOutput)) {
+                       RegType::LREG_InvalidOutput))
+    , cold(std::make_unique<Cold>()) {
   pend[0].init(this);
   pend[1].init(this);
   pend[2].init(this);
@@ -25,7 +35,7 @@ void Dinst::dump(std::string_view str) {
              str,
              fid,
              (long long)ID,
-             keep_stats ? 't' : 'd',
+             has_stats() ? 't' : 'd',
              (long long)pc,
              (long long)addr,
              (int)(inst.getSrc1()),
@@ -64,7 +74,7 @@ void Dinst::dump(std::string_view str) {
     fmt::print("    na");
   }
 
-  if (performed) {
+  if (flag(F_performed)) {
     fmt::print(" performed");
   } else if (executing) {
     fmt::print(" executing");
@@ -75,7 +85,7 @@ void Dinst::dump(std::string_view str) {
   } else {
     fmt::print(" non-issued");
   }
-  if (replay) {
+  if (flag(F_replay)) {
     fmt::print(" REPLAY ");
   }
 
@@ -171,29 +181,29 @@ DataSign Dinst::calcDataSign(int64_t _data) {
 }
 
 void Dinst::setDataSign(int64_t _data, Addr_t _ldpc) {
-  ldpc      = _ldpc;
-  data_sign = calcDataSign(_data);
+  cold->trace.ldpc      = _ldpc;
+  cold->trace.data_sign = calcDataSign(_data);
 }
 
 void Dinst::addDataSign(int ds, int64_t _data, Addr_t _ldpc) {
-  ldpc = (ldpc << 4) ^ _ldpc;
+  cold->trace.ldpc = (cold->trace.ldpc << 4) ^ _ldpc;
 
   if (ds == 0) {
-    if (_data == data) {
-      data_sign = DS_EQ;
-    } else if (data < _data) {
-      data_sign = DS_LTC;
-    } else if (data > _data) {
-      data_sign = DS_GEC;
+    if (_data == cold->trace.data) {
+      cold->trace.data_sign = DS_EQ;
+    } else if (cold->trace.data < _data) {
+      cold->trace.data_sign = DS_LTC;
+    } else if (cold->trace.data > _data) {
+      cold->trace.data_sign = DS_GEC;
     } else {
-      I(_data != data);
-      data_sign = DS_NE;
+      I(_data != cold->trace.data);
+      cold->trace.data_sign = DS_NE;
     }
   } else if (ds == 1) {
-    Data_t mix = data ^ (_data << 3);
-    data       = mix;
-    int v      = static_cast<int>(DS_OPos) + (data % 255);
-    data_sign  = static_cast<DataSign>(v);
+    Data_t mix      = cold->trace.data ^ (_data << 3);
+    cold->trace.data      = mix;
+    int v           = static_cast<int>(DS_OPos) + (cold->trace.data % 255);
+    cold->trace.data_sign = static_cast<DataSign>(v);
   }
 }
 #endif
@@ -111,147 +111,155 @@ private:
 
   static pool<Dinst> dInstPool;
 
-  DinstNext  pend[MAX_PENDING_SOURCES];
-  DinstNext* last;
-  DinstNext* first;
+  // Boolean state, one bit each in flags
+  enum Flag : uint8_t {
+    F_branchMiss,
+    F_use_level3,
+    F_branch_hit2_miss3,
+    F_branch_hit3_miss2,
+    F_branchHit_level1,
+    F_branchHit_level2,
+    F_branchHit_level3,
+    F_branchMiss_level1,
+    F_branchMiss_level2,
+    F_branchMiss_level3,
+    F_level3_NoPrediction,
+
+    F_retired,
+    F_loadForwarded,
+    F_replay,
+    F_performed,
+
+    F_interCluster,
+    F_keep_stats,
+    F_biasBranch,
+    F_imli_highconf,
+
+    F_prefetch,
+    F_dispatched,
+    F_fullMiss,
+    F_speculative,
+    F_transient,
+    F_del_entry,
+    F_is_rrob,
+    F_present_in_rob,
+    F_present_in_scb,
+    F_in_cluster,
+
+    F_flush_transient,
+    F_try_flush_transient,
+    F_to_be_destroyed,
+    F_to_be_load_destroyed,
+    F_load_destroyed_retired_spec,
+    F_load_destroyed_retired_safe_write,
+    F_load_destroyed_performed_spec,
+    F_load_destroyed_performed_safe_write,
+    F_destroy_transient,
+    F_to_be_load_scb_all,
+    F_write_scb_r,
+    F_cold_set,  // the cold record was reset for this instance
+    F_last
+  };
+  static_assert(F_last <= 64);
+
+  [[nodiscard]] bool flag(Flag f) const { return (flags >> f) & 1; }
+  void               set_flag(Flag f) { flags |= (1ULL << f); }
+  void               set_flag(Flag f, bool v) { flags = (flags & ~(1ULL << f)) | (static_cast<uint64_t>(v) << f); }
+  void               clear_flag(Flag f) { flags &= ~(1ULL << f); }
+
+  // BEGIN hot part: touched by every pipeline stage. Fields reset by setup()
+  // are kept together so that the reset is a few consecutive word stores.
+  Time_t      ID;
+  Addr_t      pc;
+  Addr_t      addr;
+  Instruction inst;
+  Hartid_t    fid;
+  char        nDeps;
+  SSID_t      SSID;  // read by the store set at every memory issue, so it stays hot
 
-  Hartid_t fid;
+  uint64_t flags;
 
-  // BEGIN Boolean flags
   Time_t fetched;
   Time_t renamed;
   Time_t issued;
   Time_t executing;
   Time_t executed;
 
-  bool branchMiss;
-  bool use_level3;
-  bool branch_hit2_miss3;
-  bool branch_hit3_miss2;
-  bool branchHit_level1;
-  bool branchHit_level2;
-  bool branchHit_level3;
-  bool branchMiss_level1;
-  bool branchMiss_level2;
-  bool branchMiss_level3;
-  bool level3_NoPrediction;
-
-  bool retired;
-  bool loadForwarded;
-  bool replay;
-  bool performed;
-
-  bool interCluster;
-  bool keep_stats;
-  bool biasBranch;
-  bool imli_highconf;
-
-  bool prefetch;
-  bool dispatched;
-  bool fullMiss;
-  bool speculative;
-  bool transient;
-  bool del_entry;
-  bool is_rrob;
-  bool present_in_rob;
-  bool present_in_scb;
-  bool in_cluster;
-
-  bool flush_transient;
-  bool try_flush_transient;
-  bool to_be_destroyed;
-  bool to_be_load_destroyed;
-  bool load_destroyed_retired_spec;
-  bool load_destroyed_retired_safe_write;
-  bool load_destroyed_performed_spec;
-  bool load_destroyed_performed_safe_write;
-  bool destroy_transient;
-  bool to_be_load_scb_all;
-  bool write_scb_r;
-  // END Boolean flags
-
-  SSID_t      SSID;
-  Addr_t      conflictStorePC;
-  Instruction inst;
-  Addr_t      pc;
-  Addr_t      addr;
-  uint64_t    inflight;
-  int16_t     bb;
+  DinstNext* last;
+  DinstNext* first;
 
+  // Non-owning, the processor owns the clusters/resources for the whole run
+  Cluster*     cluster;
+  Resource*    resource;
+  Dinst**      RAT1Entry;
+  Dinst**      RAT2Entry;
+  Dinst**      serializeEntry;
+  FetchEngine* fetch;
+  GProcessor*  gproc;
+
+  DinstNext pend[MAX_PENDING_SOURCES];
+  // END hot part
+
+  // Cold side-record: stats, predictor tags, and trace data. Allocated once
+  // per pool slot (the pool recycles the Dinst, not the record), and reset on
+  // the first write after create(), so setup() never touches it.
+  struct Cold {
+    Addr_t   conflictStorePC;
+    uint64_t inflight;
+    Time_t   original_id;
+    int16_t  bb;
 #ifdef ESESC_TRACE_DATA
-  Addr_t   ldpc;
-  Addr_t   ld_addr;
-  Addr_t   base_pref_addr;
-  Data_t   data;
-  Data_t   data2;
-  DataSign data_sign;
-  Data_t   br_data1;
-  Data_t   br_data2;
-  int      ld_br_type;
-  int      dep_depth;
-  int      chained;
-  // BR stats
-  Addr_t   brpc;
-  uint64_t delta;
-  uint64_t br_op_type;
-  int      ret_br_count;
-  bool     br_ld_chain_predictable;
-  bool     br_ld_chain;
+    struct Trace_data {
+      Addr_t   ldpc;
+      Addr_t   ld_addr;
+      Addr_t   base_pref_addr;
+      Data_t   data;
+      Data_t   data2;
+      DataSign data_sign;
+      Data_t   br_data1;
+      Data_t   br_data2;
+      int      ld_br_type;
+      int      dep_depth;
+      int      chained;
+      // BR stats
+      Addr_t   brpc;
+      uint64_t delta;
+      uint64_t br_op_type;
+      int      ret_br_count;
+      bool     br_ld_chain_predictable;
+      bool     br_ld_chain;
+    };
+    Trace_data trace;  // reset by create()
 #endif
+  };
+  std::unique_ptr<Cold> cold;
+
+  Cold& cold_rec() {
+    if (!flag(F_cold_set)) {
+      set_flag(F_cold_set);
+      cold->conflictStorePC = 0;
+      cold->inflight        = 0;
+      cold->original_id     = 0;
+      cold->bb              = -1;
+    }
+    return *cold;
+  }
 
-    std::shared_ptr<Cluster>      cluster;
-  std::shared_ptr<Resource>     resource;
-  std::shared_ptr<Store_buffer> scb;
-  Dinst**                       RAT1Entry;
-  Dinst**                       RAT2Entry;
-  Dinst**                       serializeEntry;
-  FetchEngine*                  fetch;
-  GProcessor*                   gproc;
-
-  char nDeps;
+#ifndef NDEBUG
+  uint64_t mreq_id;
+#endif
 
   static inline Time_t currentID           = 0;
   static inline Time_t current_original_id = 0;
   static inline Time_t currentID_trans     = 1000000;
 
-  // static ID, increased every create (currentID). pointer
-  // static ID, increased every Non_Transient create (currentID). pointer
-  Time_t ID;
-  Time_t original_id;
-
-#ifndef NDEBUG
-  uint64_t mreq_id;
-#endif
-  void setup() {
+  void setup(bool keep_stats) {
     ID = currentID++;
 #ifndef NDEBUG
     mreq_id = 0;
 #endif
-    first = nullptr;
 
-    RAT1Entry      = nullptr;
-    RAT2Entry      = nullptr;
-    serializeEntry = nullptr;
-    fetch          = nullptr;
-    cluster        = nullptr;
-    resource       = nullptr;
-    scb            = nullptr;
-
-    gproc           = nullptr;
-    SSID            = -1;
-    conflictStorePC = 0;
-
-    branchMiss          = false;
-    use_level3          = false;
-    branch_hit2_miss3   = false;
-    branch_hit3_miss2   = false;
-    branchHit_level1    = false;
-    branchHit_level2    = false;
-    branchHit_level3    = false;
-    branchMiss_level1   = false;
-    branchMiss_level2   = false;
-    branchMiss_level3   = false;
-    level3_NoPrediction = false;
+    flags = (1ULL << F_speculative) | (static_cast<uint64_t>(keep_stats) << F_keep_stats);
 
     fetched   = 0;
     renamed   = 0;
@@ -259,277 +267,236 @@ private:
     executing = 0;
     executed  = 0;
 
-    retired       = false;
-    loadForwarded = false;
-    replay        = false;
-    performed     = false;
-
-    interCluster  = false;
-    biasBranch    = false;
-    imli_highconf = false;
-
-    prefetch       = false;
-    dispatched     = false;
-    fullMiss       = false;
-    speculative    = true;
-    transient      = false;
-    del_entry      = false;
-    is_rrob        = false;
-    present_in_rob = false;
-    present_in_rob = false;
-    in_cluster     = false;
-
-    flush_transient                     = false;
-    try_flush_transient                 = false;
-    to_be_destroyed                     = false;
-    to_be_load_destroyed                = false;
-    load_destroyed_retired_spec         = false;
-    load_destroyed_retired_safe_write   = false;
-    load_destroyed_performed_spec       = false;
-    load_destroyed_performed_safe_write = false;
-    destroy_transient                   = false;
-    to_be_load_scb_all                  = false;
-    write_scb_r                         = false;
+    last           = nullptr;
+    first          = nullptr;
+    cluster        = nullptr;
+    resource       = nullptr;
+    RAT1Entry      = nullptr;
+    RAT2Entry      = nullptr;
+    serializeEntry = nullptr;
+    fetch          = nullptr;
+    gproc          = nullptr;
 
+    nDeps = 0;
+    for (auto& p : pend) {
+      p.isUsed = false;
+      p.setNextDep(nullptr);
 #ifdef DINST_PARENT
-    pend[0].setParentDinst(nullptr);
-    pend[1].setParentDinst(nullptr);
-    pend[2].setParentDinst(nullptr);
+      p.setParentDinst(nullptr);
 #endif
+    }
 
-    last  = nullptr;
-    nDeps = 0;
-
-    pend[0].isUsed = false;
-    pend[1].isUsed = false;
-    pend[2].isUsed = false;
-
-    pend[0].setNextDep(nullptr);
-    pend[1].setNextDep(nullptr);
-    pend[2].setNextDep(nullptr);
+    SSID = -1;
   }
 
 protected:
 public:
   Dinst();
 
-  // bool is_safe() const { return !speculative; }
-  // bool is_spec() const { return speculative; }
-  void set_safe() { speculative = false; }
-  void set_spec() { speculative = true; }
+  // bool is_safe() const { return !flag(F_speculative); }
+  // bool is_spec() const { return flag(F_speculative); }
+  void set_safe() { clear_flag(F_speculative); }
+  void set_spec() { set_flag(F_speculative); }
 
-  // bool isTransient() const { return transient; }
+  // bool isTransient() const { return flag(F_transient); }
   void set_original_id() {
-    I(!transient);
-    original_id = current_original_id++;
+    I(!flag(F_transient));
+    cold_rec().original_id = current_original_id++;
   }
 
   void setTransient() {
-    transient = true;
+    set_flag(F_transient);
     // ID = currentID_trans++;
   }
   void mark_to_be_destroyed() {
-    to_be_destroyed = true;
+    set_flag(F_to_be_destroyed);
     // printf("Setting mark_to_be_destroyed_transient ::dinst %ld\n", this->ID);
   }
   void set_to_be_load_destroyed() {
-    to_be_load_destroyed = true;
+    set_flag(F_to_be_load_destroyed);
     // printf("Setting mark_to_be_destroyed_transient ::dinst %ld\n", this->ID);
   }
   void clear_to_be_destroyed() {
-    to_be_destroyed = false;
+    clear_flag(F_to_be_destroyed);
     // printf("Clearing is_to_be_destroyed_transient to false ::dinst %ld\n", ID);
   }
 
-  void set_write_scb_r() { write_scb_r = true; }
-  bool is_write_scb_r() { return write_scb_r; }
+  void set_write_scb_r() { set_flag(F_write_scb_r); }
+  bool is_write_scb_r() { return flag(F_write_scb_r); }
   void set_load_destroyed_retired_spec() {
-    load_destroyed_retired_spec = true;
+    set_flag(F_load_destroyed_retired_spec);
     // printf("Setting mark_to_be_destroyed_transient ::dinst %ld\n", this->ID);
   }
   bool is_load_destroyed_retired_spec() {
-    return load_destroyed_retired_spec;
+    return flag(F_load_destroyed_retired_spec);
     // printf("Setting mark_to_be_destroyed_transient ::dinst %ld\n", this->ID);
   }
 
   void set_load_destroyed_retired_safe_write() {
-    load_destroyed_retired_safe_write = true;
+    set_flag(F_load_destroyed_retired_safe_write);
     // printf("Setting mark_to_be_destroyed_transient ::dinst %ld\n", this->ID);
   }
   bool is_load_destroyed_retired_safe_write() {
-    return load_destroyed_retired_safe_write;
+    return flag(F_load_destroyed_retired_safe_write);
     // printf("Setting mark_to_be_destroyed_transient ::dinst %ld\n", this->ID);
   }
 
   void set_load_destroyed_performed_spec() {
-    load_destroyed_performed_spec = true;
+    set_flag(F_load_destroyed_performed_spec);
     // printf("Setting mark_to_be_destroyed_transient ::dinst %ld\n", this->ID);
   }
 
   bool is_load_destroyed_performed_spec() {
-    return load_destroyed_performed_spec;
+    return flag(F_load_destroyed_performed_spec);
     // printf("Setting mark_to_be_destroyed_transient ::dinst %ld\n", this->ID);
   }
 
   void set_load_destroyed_performed_safe_write() {
-    load_destroyed_performed_safe_write = true;
+    set_flag(F_load_destroyed_performed_safe_write);
     // printf("Setting mark_to_be_destroyed_transient ::dinst %ld\n", this->ID);
   }
   bool is_load_destroyed_performed_safe_write() {
-    return load_destroyed_performed_safe_write;
+    return flag(F_load_destroyed_performed_safe_write);
     // printf("Setting mark_to_be_destroyed_transient ::dinst %ld\n", this->ID);
   }
 
   void mark_destroy_transient() {
-    destroy_transient = true;
+    set_flag(F_destroy_transient);
     // printf("Setting mark_to_be_destroyed_transient ::dinst %ld\n", this->ID);
   }
 
-  [[nodiscard]] bool is_safe() const { return !speculative; }
-  [[nodiscard]] bool is_spec() const { return speculative; }
-  void               mark_safe() { speculative = false; }
+  [[nodiscard]] bool is_safe() const { return !flag(F_speculative); }
+  [[nodiscard]] bool is_spec() const { return flag(F_speculative); }
+  void               mark_safe() { clear_flag(F_speculative); }
 
-  [[nodiscard]] bool isTransient() const { return transient; }
-  // void               setTransient() { transient = true; }
-  // void               mark_to_be_destroyed() { to_be_destroyed = true; }
+  [[nodiscard]] bool isTransient() const { return flag(F_transient); }
+  // void               setTransient() { set_flag(F_transient); }
+  // void               mark_to_be_destroyed() { set_flag(F_to_be_destroyed); }
 
-  // void clear_to_be_destroyed() { to_be_destroyed = false; }
+  // void clear_to_be_destroyed() { clear_flag(F_to_be_destroyed); }
 
-  // void mark_destroy_transient() { destroy_transient = true; }
+  // void mark_destroy_transient() { set_flag(F_destroy_transient); }
 
-  bool is_destroy_transient() { return to_be_destroyed; }
+  bool is_destroy_transient() { return flag(F_to_be_destroyed); }
 
-  void mark_del_entry() { del_entry = true; }
+  void mark_del_entry() { set_flag(F_del_entry); }
 
-  void unmark_del_entry() { del_entry = false; }
-  void mark_rrob() { is_rrob = true; }
-  bool is_in_cluster() const { return in_cluster; }
-  void set_in_cluster() { in_cluster = true; }
+  void unmark_del_entry() { clear_flag(F_del_entry); }
+  void mark_rrob() { set_flag(F_is_rrob); }
+  bool is_in_cluster() const { return flag(F_in_cluster); }
+  void set_in_cluster() { set_flag(F_in_cluster); }
 
-  void mark_flush_transient() { flush_transient = true; }
-  void mark_try_flush_transient() { try_flush_transient = true; }
+  void mark_flush_transient() { set_flag(F_flush_transient); }
+  void mark_try_flush_transient() { set_flag(F_try_flush_transient); }
 
-  bool is_present_in_rob() { return present_in_rob; }
-  void set_present_in_rob() { present_in_rob = true; }
-  bool is_present_in_scb() { return present_in_scb; }
-  void set_present_in_scb() { present_in_scb = true; }
-  void reset_present_in_scb() { present_in_scb = false; }
-  bool is_flush_transient() { return flush_transient; }
-  bool is_try_flush_transient() { return try_flush_transient; }
-  bool has_stats() const { return keep_stats; }
-  bool is_del_entry() { return del_entry; }
-  bool is_present_rrob() { return is_rrob; }
-  bool is_to_be_destroyed() { return to_be_destroyed; }
+  bool is_present_in_rob() { return flag(F_present_in_rob); }
+  void set_present_in_rob() { set_flag(F_present_in_rob); }
+  bool is_present_in_scb() { return flag(F_present_in_scb); }
+  void set_present_in_scb() { set_flag(F_present_in_scb); }
+  void reset_present_in_scb() { clear_flag(F_present_in_scb); }
+  bool is_flush_transient() { return flag(F_flush_transient); }
+  bool is_try_flush_transient() { return flag(F_try_flush_transient); }
+  bool has_stats() const { return flag(F_keep_stats); }
+  bool is_del_entry() { return flag(F_del_entry); }
+  bool is_present_rrob() { return flag(F_is_rrob); }
+  bool is_to_be_destroyed() { return flag(F_to_be_destroyed); }
 
-  bool is_to_be_load_destroyed() { return to_be_load_destroyed; }
-  bool is_load_scb_all() { return to_be_load_scb_all; }
-  bool set_load_scb_all() { return to_be_load_scb_all = true; }
+  bool is_to_be_load_destroyed() { return flag(F_to_be_load_destroyed); }
+  bool is_load_scb_all() { return flag(F_to_be_load_scb_all); }
+  bool set_load_scb_all() {
+    set_flag(F_to_be_load_scb_all);
+    return true;
+  }
 
   [[nodiscard]] static Dinst* create(Instruction&& inst, Addr_t pc, Addr_t address, Hartid_t fid, bool keep_stats) {
     Dinst* i = dInstPool.out();
     I(inst.getOpcode() != Opcode::iOpInvalid);
 
-    i->fid      = fid;
-    i->inst     = std::move(inst);
-    i->pc       = pc;
-    i->addr     = address;
-    i->inflight = 0;
-    i->bb       = -1;
+    i->fid  = fid;
+    i->inst = std::move(inst);
+    i->pc   = pc;
+    i->addr = address;
 #ifdef ESESC_TRACE_DATA
-    i->data           = 0;
-    i->data2          = 0;
-    i->br_data1       = 0;
-    i->br_data2       = 0;
-    i->ld_br_type     = 0;
-    i->dep_depth      = 0;
-    i->ldpc           = 0;
-    i->ld_addr        = 0;
-    i->base_pref_addr = 0;
-    i->data_sign      = DS_NoData;
-    i->chained        = 0;
-    i->brpc           = 0;
-    i->delta          = 0;
-    i->br_ld_chain    = false;
-    i->br_op_type     = -1;
+    i->cold->trace            = {};
+    i->cold->trace.data_sign  = DS_NoData;
+    i->cold->trace.br_op_type = -1;
 #endif
-    i->fetched    = 0;
-    i->keep_stats = keep_stats;
 
-    i->setup();
+    i->setup(keep_stats);
     I(i->getInst()->getOpcode() != Opcode::iOpInvalid);
 
     return i;
   }
 #ifdef ESESC_TRACE_DATA
-  uint64_t getDelta() const { return delta; }
+  uint64_t getDelta() const { return cold->trace.delta; }
 
-  void setDelta(uint64_t _delta) { delta = _delta; }
+  void setDelta(uint64_t _delta) { cold->trace.delta = _delta; }
 
-  int getRetireBrCount() const { return ret_br_count; }
+  int getRetireBrCount() const { return cold->trace.ret_br_count; }
 
-  void setRetireBrCount(int _cnt) { ret_br_count = _cnt; }
+  void setRetireBrCount(int _cnt) { cold->trace.ret_br_count = _cnt; }
 
-  bool is_br_ld_chain() const { return br_ld_chain; }
+  bool is_br_ld_chain() const { return cold->trace.br_ld_chain; }
 
-  void set_br_ld_chain() { br_ld_chain = true; }
+  void set_br_ld_chain() { cold->trace.br_ld_chain = true; }
 
-  bool is_br_ld_chain_predictable() { return br_ld_chain_predictable; }
+  bool is_br_ld_chain_predictable() { return cold->trace.br_ld_chain_predictable; }
 
-  void set_br_ld_chain_predictable() { br_ld_chain_predictable = true; }
+  void set_br_ld_chain_predictable() { cold->trace.br_ld_chain_predictable = true; }
 
-  Addr_t getBasePrefAddr() const { return base_pref_addr; }
+  Addr_t getBasePrefAddr() const { return cold->trace.base_pref_addr; }
 
-  void setBasePrefAddr(Addr_t _base_addr) { base_pref_addr = _base_addr; }
+  void setBasePrefAddr(Addr_t _base_addr) { cold->trace.base_pref_addr = _base_addr; }
 
-  Addr_t getLdAddr() const { return ld_addr; }
+  Addr_t getLdAddr() const { return cold->trace.ld_addr; }
 
-  void setLdAddr(Addr_t _ld_addr) { ld_addr = _ld_addr; }
+  void setLdAddr(Addr_t _ld_addr) { cold->trace.ld_addr = _ld_addr; }
 
-  Addr_t getBrPC() const { return brpc; }
+  Addr_t getBrPC() const { return cold->trace.brpc; }
 
-  void setBrPC(Addr_t _brpc) { brpc = _brpc; }
+  void setBrPC(Addr_t _brpc) { cold->trace.brpc = _brpc; }
 
   [[nodiscard]] static DataSign calcDataSign(int64_t data);
 
-  [[nodiscard]] int getDepDepth() const { return dep_depth; }
+  [[nodiscard]] int getDepDepth() const { return cold->trace.dep_depth; }
 
-  void setDepDepth(int d) { dep_depth = d; }
+  void setDepDepth(int d) { cold->trace.dep_depth = d; }
 
-  [[nodiscard]] int getLBType() const { return ld_br_type; }
+  [[nodiscard]] int getLBType() const { return cold->trace.ld_br_type; }
 
-  void setLBType(int lb) { ld_br_type = lb; }
+  void setLBType(int lb) { cold->trace.ld_br_type = lb; }
 
-  [[nodiscard]] Data_t getBrData1() const { return br_data1; }
+  [[nodiscard]] Data_t getBrData1() const { return cold->trace.br_data1; }
 
-  [[nodiscard]] Data_t getBrData2() const { return br_data2; }
+  [[nodiscard]] Data_t getBrData2() const { return cold->trace.br_data2; }
 
-  [[nodiscard]] Data_t getData() const { return data; }
+  [[nodiscard]] Data_t getData() const { return cold->trace.data; }
 
-  [[nodiscard]] Data_t getData2() const { return data2; }
+  [[nodiscard]] Data_t getData2() const { return cold->trace.data2; }
 
-  [[nodiscard]] DataSign getDataSign() const { return (DataSign)(int(data_sign) & 0x1FF); }
+  [[nodiscard]] DataSign getDataSign() const { return (DataSign)(int(cold->trace.data_sign) & 0x1FF); }
 
-  // DataSign getDataSign() const { return data_sign; }
+  // DataSign getDataSign() const { return cold->trace.data_sign; }
   void setDataSign(int64_t _data, Addr_t ldpc);
   void addDataSign(int ds, int64_t _data, Addr_t ldpc);
 
-  void setBrData1(Data_t _data) { br_data1 = _data; }
+  void setBrData1(Data_t _data) { cold->trace.br_data1 = _data; }
 
-  void setBrData2(Data_t _data) { br_data2 = _data; }
+  void setBrData2(Data_t _data) { cold->trace.br_data2 = _data; }
 
-  void setData(uint64_t _data) { data = _data; }
+  void setData(uint64_t _data) { cold->trace.data = _data; }
 
-  void setData2(uint64_t _data) { data2 = _data; }
+  void setData2(uint64_t _data) { cold->trace.data2 = _data; }
 
-  [[nodiscard]] Addr_t getLDPC() const { return ldpc; }
+  [[nodiscard]] Addr_t getLDPC() const { return cold->trace.ldpc; }
   void                 setChain(FetchEngine* fe, int c) {
     I(fetch == nullptr);
     I(c);
     I(fe);
     fetch   = fe;
-    chained = c;
+    cold->trace.chained = c;
   }
-  [[nodiscard]] int getChained() const { return chained; }
+  [[nodiscard]] int getChained() const { return cold->trace.chained; }
 #else
   static DataSign calcDataSign([[maybe_unused]] int64_t data) { return DS_NoData; }
   Data_t          getData() const { return 0; }
@@ -557,13 +524,13 @@ public:
   void destroy();
   void destroyTransientInst();
 
-  void set(std::shared_ptr<Cluster> cls, std::shared_ptr<Resource> res) {
+  void set(Cluster* cls, Resource* res) {
     cluster  = cls;
     resource = res;
   }
 
-  [[nodiscard]] std::shared_ptr<Cluster>  getCluster() const { return cluster; }
-  [[nodiscard]] std::shared_ptr<Resource> getClusterResource() const { return resource; }
+  [[nodiscard]] Cluster*  getCluster() const { return cluster; }
+  [[nodiscard]] Resource* getClusterResource() const { return resource; }
 
   void clearRATEntry();
   void setRAT1Entry(Dinst** rentry) {
@@ -585,9 +552,9 @@ public:
   void setConflictStorePC(Addr_t storepc) {
     I(storepc);
     I(this->getInst()->isLoad());
-    conflictStorePC = storepc;
+    cold_rec().conflictStorePC = storepc;
   }
-  [[nodiscard]] Addr_t getConflictStorePC() const { return conflictStorePC; }
+  [[nodiscard]] Addr_t getConflictStorePC() const { return flag(F_cold_set) ? cold->conflictStorePC : 0; }
 
 #ifdef DINST_PARENT
   Dinst* getParentSrc1() const {
@@ -608,63 +575,83 @@ public:
     }
     return nullptr;
   }
+  bool waits_on(const Dinst* parent) const {
+    for (const auto& p : pend) {
+      if (p.isUsed && p.getParentDinst() == parent) {
+        return true;
+      }
+    }
+    return false;
+  }
+  // Same as the getNextPending calls of parent that reach this instruction,
+  // without walking the parent list (the wakeup matrix clears it after)
+  void clear_pending_from(const Dinst* parent) {
+    for (auto& p : pend) {
+      if (p.isUsed && p.getParentDinst() == parent) {
+        I(nDeps > 0);
+        nDeps--;
+        p.isUsed = false;
+        p.setParentDinst(nullptr);
+      }
+    }
+  }
 #endif
 
   void lockFetch(FetchEngine* fe) {
-    I(!branchMiss);
+    I(!flag(F_branchMiss));
     I(fetch == nullptr);
     fetch      = fe;
-    branchMiss = true;
+    set_flag(F_branchMiss);
     fetched    = globalClock;
   }
 
   void setFetchTime() {
 #ifdef ESESC_TRACE_DATA
-    I(fetch == nullptr || chained);
+    I(fetch == nullptr || cold->trace.chained);
 #else
     I(fetch == nullptr);
 #endif
-    I(!branchMiss);
+    I(!flag(F_branchMiss));
     fetched = globalClock;
   }
-  [[nodiscard]] int16_t getBB() const { return bb; }
-  void                  setBB(int16_t b) { bb = b; }
+  [[nodiscard]] int16_t getBB() const { return flag(F_cold_set) ? cold->bb : -1; }
+  void                  setBB(int16_t b) { cold_rec().bb = b; }
 
-  [[nodiscard]] uint64_t getInflight() const { return inflight; }
+  [[nodiscard]] uint64_t getInflight() const { return flag(F_cold_set) ? cold->inflight : 0; }
 
-  void setInflight(uint64_t _inf) { inflight = _inf; }
+  void setInflight(uint64_t _inf) { cold_rec().inflight = _inf; }
 
-  [[nodiscard]] bool isUseLevel3() const { return use_level3; }
+  [[nodiscard]] bool isUseLevel3() const { return flag(F_use_level3); }
 
-  void setUseLevel3() { use_level3 = true; }
+  void setUseLevel3() { set_flag(F_use_level3); }
 
-  void setBranch_hit2_miss3() { branch_hit2_miss3 = true; }
-  void setBranch_hit3_miss2() { branch_hit3_miss2 = true; }
+  void setBranch_hit2_miss3() { set_flag(F_branch_hit2_miss3); }
+  void setBranch_hit3_miss2() { set_flag(F_branch_hit3_miss2); }
 
-  [[nodiscard]] bool isBranch_hit2_miss3() const { return branch_hit2_miss3; }
-  [[nodiscard]] bool isBranch_hit3_miss2() const { return branch_hit3_miss2; }
+  [[nodiscard]] bool isBranch_hit2_miss3() const { return flag(F_branch_hit2_miss3); }
+  [[nodiscard]] bool isBranch_hit3_miss2() const { return flag(F_branch_hit3_miss2); }
 
-  void setBranchHit_level1() { branchHit_level1 = true; }
-  void setBranchHit_level2() { branchHit_level2 = true; }
-  void setBranchHit_level3() { branchHit_level3 = true; }
+  void setBranchHit_level1() { set_flag(F_branchHit_level1); }
+  void setBranchHit_level2() { set_flag(F_branchHit_level2); }
+  void setBranchHit_level3() { set_flag(F_branchHit_level3); }
 
-  [[nodiscard]] bool isBranchHit_level1() const { return branchHit_level1; }
-  [[nodiscard]] bool isBranchHit_level2() const { return branchHit_level2; }
-  [[nodiscard]] bool isBranchHit_level3() const { return branchHit_level3; }
+  [[nodiscard]] bool isBranchHit_level1() const { return flag(F_branchHit_level1); }
+  [[nodiscard]] bool isBranchHit_level2() const { return flag(F_branchHit_level2); }
+  [[nodiscard]] bool isBranchHit_level3() const { return flag(F_branchHit_level3); }
 
-  void setBranchMiss_level1() { branchMiss_level1 = true; }
-  void setBranchMiss_level2() { branchMiss_level2 = true; }
-  void setBranchMiss_level3() { branchMiss_level3 = true; }
+  void setBranchMiss_level1() { set_flag(F_branchMiss_level1); }
+  void setBranchMiss_level2() { set_flag(F_branchMiss_level2); }
+  void setBranchMiss_level3() { set_flag(F_branchMiss_level3); }
 
-  [[nodiscard]] bool isBranchMiss_level1() const { return branchMiss_level1; }
-  [[nodiscard]] bool isBranchMiss_level2() const { return branchMiss_level2; }
-  [[nodiscard]] bool isBranchMiss_level3() const { return branchMiss_level3; }
+  [[nodiscard]] bool isBranchMiss_level1() const { return flag(F_branchMiss_level1); }
+  [[nodiscard]] bool isBranchMiss_level2() const { return flag(F_branchMiss_level2); }
+  [[nodiscard]] bool isBranchMiss_level3() const { return flag(F_branchMiss_level3); }
 
-  void setLevel3_NoPrediction() { level3_NoPrediction = true; }
+  void setLevel3_NoPrediction() { set_flag(F_level3_NoPrediction); }
 
-  [[nodiscard]] bool isLevel3_NoPrediction() const { return level3_NoPrediction; }
+  [[nodiscard]] bool isLevel3_NoPrediction() const { return flag(F_level3_NoPrediction); }
 
-  [[nodiscard]] bool         isBranchMiss() const { return branchMiss; }
+  [[nodiscard]] bool         isBranchMiss() const { return flag(F_branchMiss); }
   [[nodiscard]] FetchEngine* getFetchEngine() const { return fetch; }
 
   Time_t getFetchTime() const { return fetched; }
@@ -794,14 +781,14 @@ public:
   void dump(std::string_view txt);
 
   // methods required for LDSTBuffer
-  bool isLoadForwarded() const { return loadForwarded; }
+  bool isLoadForwarded() const { return flag(F_loadForwarded); }
   void setLoadForwarded() {
-    I(!loadForwarded);
-    loadForwarded = true;
+    I(!flag(F_loadForwarded));
+    set_flag(F_loadForwarded);
   }
 
-  bool hasInterCluster() const { return interCluster; }
-  void markInterCluster() { interCluster = true; }
+  bool hasInterCluster() const { return flag(F_interCluster); }
+  void markInterCluster() { set_flag(F_interCluster); }
 
   bool isIssued() const { return issued; }
 
@@ -838,22 +825,22 @@ public:
   }
   void markExecutingTransient() { executing = globalClock; }
 
-  bool isReplay() const { return replay; }
-  void markReplay() { replay = true; }
+  bool isReplay() const { return flag(F_replay); }
+  void markReplay() { set_flag(F_replay); }
 
-  void setBiasBranch(bool b) { biasBranch = b; }
-  bool isBiasBranch() const { return biasBranch; }
+  void setBiasBranch(bool b) { set_flag(F_biasBranch, b); }
+  bool isBiasBranch() const { return flag(F_biasBranch); }
 
-  void setImliHighConf() { imli_highconf = true; }
+  void setImliHighConf() { set_flag(F_imli_highconf); }
 
-  bool getImliHighconf() const { return imli_highconf; }
+  bool getImliHighconf() const { return flag(F_imli_highconf); }
 
   bool isTaken() const {
     I(getInst()->isControl());
     return addr != 0;
   }
 
-  bool isPerformed() const { return performed; }
+  bool isPerformed() const { return flag(F_performed); }
   void markPerformed() {
     // Loads get performed first, and then executed
     // printf("Dinst ::markPerformed Insit %ld and isTransient is %b\n", getID(), isTransient());
@@ -864,22 +851,22 @@ public:
       GI(!inst.isLoad(), executed != 0);
     }
 
-    performed = true;
+    set_flag(F_performed);
   }
 
-  bool isRetired() const { return retired; }
+  bool isRetired() const { return flag(F_retired); }
   void markRetired() {
     I(inst.isStore());
-    retired = true;
+    set_flag(F_retired);
   }
-  void mark_retired() { retired = true; }
+  void mark_retired() { set_flag(F_retired); }
 
-  bool isPrefetch() const { return prefetch; }
-  void markPrefetch() { prefetch = true; }
-  bool isDispatched() const { return dispatched; }
-  void markDispatched() { dispatched = true; }
-  bool isFullMiss() const { return fullMiss; }
-  void setFullMiss(bool t) { fullMiss = t; }
+  bool isPrefetch() const { return flag(F_prefetch); }
+  void markPrefetch() { set_flag(F_prefetch); }
+  bool isDispatched() const { return flag(F_dispatched); }
+  void markDispatched() { set_flag(F_dispatched); }
+  bool isFullMiss() const { return flag(F_fullMiss); }
+  void setFullMiss(bool t) { set_flag(F_fullMiss, t); }
 
   Time_t getFetchedTime() const { return fetched; }
   Time_t getRenamedTime() const { return renamed; }
@@ -888,7 +875,7 @@ public:
   Time_t getExecutedTime() const { return executed; }
 
   Time_t getID() const { return ID; }
-  Time_t get_original_id() const { return original_id; }
+  Time_t get_original_id() const { return flag(F_cold_set) ? cold->original_id : 0; }
 
 #ifndef NDEBUG
   uint64_t getmreq_id() { return mreq_id; }
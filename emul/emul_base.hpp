@@ -26,6 +26,9 @@ public:
 
   virtual void skip_rabbit(Hartid_t fid, size_t ninst) = 0;
 
+  // Instructions left to simulate, for progress reports (0 when unknown)
+  virtual uint64_t get_insts_left() const { return 0; }
+
   const std::string& get_type() const { return type; }
   const std::string& get_section() const { return section; }
 };
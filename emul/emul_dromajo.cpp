@@ -2,6 +2,7 @@
 
 #include "emul_dromajo.hpp"
 
+#include <bit>
 #include <filesystem>
 #include <print>
 
@@ -10,11 +11,12 @@
 Emul_dromajo::Emul_dromajo() : Emul_base() {
   num = 0;
 
-  uint64_t rabbit = 0;
+  uint64_t rabbit       = 0;
+  bool     use_parallel = false;
 
   auto nemuls = Config::get_array_size("soc", "emul");
 
-  last.resize(nemuls, {0, 0, 0, 0});
+  last.resize(nemuls, {0, 0, 0, 0, 0});
 
   for (auto i = 0u; i < nemuls; ++i) {
     auto tp = Config::get_string("soc", "emul", i, "type");
@@ -28,6 +30,9 @@ Emul_dromajo::Emul_dromajo() : Emul_base() {
       rabbit = Config::get_integer(section, "rabbit");
       detail = Config::get_integer(section, "detail");
       time   = Config::get_integer(section, "time");
+      if (Config::has_entry(section, "parallel")) {
+        use_parallel = Config::get_bool(section, "parallel");
+      }
       if (Config::has_entry(section, "bench")) {
         bench = Config::get_string(section, "bench");
         if (Config::has_entry(section, "load")) {
@@ -47,6 +52,25 @@ Emul_dromajo::Emul_dromajo() : Emul_base() {
       }
     }
   }
+  if (num) {
+    size_t decode_cache_size = 4096;
+    if (Config::has_entry(section, "decode_cache")) {
+      decode_cache_size = Config::get_integer(section, "decode_cache", 0, 1 << 24);
+    }
+    if (decode_cache_size) {
+      if (!std::has_single_bit(decode_cache_size)) {
+        Config::add_error(
+            fmt::format("section {} decode_cache:{} should be a power of two (or 0 to disable)", section, decode_cache_size));
+      }
+      set_decode_cache(std::bit_ceil(decode_cache_size));
+    }
+    decodeHit = std::make_unique<Stats_avg>(fmt::format("{}:decodeHitRate", section));
+  }
+  use_parallel = use_parallel && num > 1;
+  if (use_parallel) {
+    lookahead = Config::get_integer(section, "lookahead", 16, 1 << 20);
+    nStarved  = std::make_unique<Stats_cntr>(fmt::format("{}:nStarved", section));
+  }
   Config::exit_on_error();
 
   type = "dromajo";
@@ -62,9 +86,15 @@ Emul_dromajo::Emul_dromajo() : Emul_base() {
       execute(i);  // to set the last
     }
   }
+  if (use_parallel) {
+    start_harts();
+  }
 }
 
+Emul_dromajo::~Emul_dromajo() { stop_harts(); }
+
 void Emul_dromajo::destroy_machine() {
+  stop_harts();
   if (machine != nullptr) {
     virt_machine_end(machine);
   }
@@ -73,9 +103,7 @@ void Emul_dromajo::destroy_machine() {
 
 static inline uint32_t C_reg_decode(uint32_t rn) { return rn + 8; }
 
-Dinst* Emul_dromajo::peek(Hartid_t fid) {
-  uint32_t insn_raw = last[fid].insns;
-
+static Instruction decode(uint32_t insn_raw) {
   // Assume compressed, default to 32-bit insn
   uint32_t funct7 = 0;
   uint32_t rs1    = 0;
@@ -377,8 +405,42 @@ Dinst* Emul_dromajo::peek(Hartid_t fid) {
   I(src2 != RegType::LREG_INVALID);
   I(dst1 != RegType::LREG_INVALID);
 
+  return Instruction(opcode, src1, src2, dst1, dst2);
+}
+
+const Instruction& Emul_dromajo::decode_cached(uint64_t pc, uint32_t insn_raw) {
+  if (decode_cache.empty()) {
+    decode_miss = decode(insn_raw);
+    return decode_miss;
+  }
+
+  // Same pc with different bits (self modifying code, or a different
+  // process/hart at the same virtual address) is a miss
+  auto& entry = decode_cache[((pc >> 1) ^ (pc >> 17)) & (decode_cache.size() - 1)];
+  bool  hit   = entry.pc == pc && entry.insns == insn_raw && entry.inst.getOpcode() != Opcode::iOpInvalid;
+
+  decodeHit->sample(hit ? 1 : 0, detail == 0);
+  if (!hit) {
+    entry.pc    = pc;
+    entry.insns = insn_raw;
+    entry.inst  = decode(insn_raw);
+  }
+
+  return entry.inst;
+}
+
+Dinst* Emul_dromajo::peek(Hartid_t fid) {
+  if (last[fid].flags & no_insn) {
+    return nullptr;  // the hart terminated
+  }
+
+  uint32_t insn_raw = last[fid].insns;
+  uint64_t pc       = last[fid].pc;
+
+  const auto& inst   = decode_cached(pc, insn_raw);
+  auto        opcode = inst.getOpcode();
+
   uint64_t paddr = 0u;
-  uint64_t pc    = last[fid].pc;
   if (opcode == Opcode::iLALU_LD || opcode == Opcode::iSALU_ST) {
     paddr = last[fid].addr;
   } else if (opcode == Opcode::iBALU_LBRANCH || opcode == Opcode::iBALU_RBRANCH) {
@@ -405,11 +467,11 @@ Dinst* Emul_dromajo::peek(Hartid_t fid) {
 
   if (detail > 0) {
     --detail;
-    return Dinst::create(Instruction(opcode, src1, src2, dst1, dst2), pc, paddr, fid, false);
+    return Dinst::create(Instruction(inst), pc, paddr, fid, false);
   }
   if (time > 0) {
     --time;
-    return Dinst::create(Instruction(opcode, src1, src2, dst1, dst2), pc, paddr, fid, true);
+    return Dinst::create(Instruction(inst), pc, paddr, fid, true);
   }
 
   return nullptr;
@@ -417,22 +479,168 @@ Dinst* Emul_dromajo::peek(Hartid_t fid) {
 void Emul_dromajo::skip_rabbit(Hartid_t fid, size_t ninst) {
   I(ninst > 0);
 
-  if (ninst > 1) {
-    virt_machine_run(machine, fid, ninst - 1);
+  if (parallel) {
+    for (auto i = 0u; i < ninst; ++i) {
+      execute(fid);  // the emulation thread owns the machine state
+    }
+    return;
+  }
+
+  if (ninst > 1 && !(last[fid].flags & (last_insn | no_insn))) {
+    if (!virt_machine_run(machine, fid, ninst - 1)) {
+      last[fid].flags = last_insn;
+    }
   }
 
   execute(fid);
 }
 
+bool Emul_dromajo::run_one(Hartid_t fid, Last_state& st) {
+  auto keep_going = virt_machine_run(machine, fid, 1);
+
+  st.addr    = machine->cpu_state[fid]->last_data_paddr;
+  st.next_pc = machine->cpu_state[fid]->pc;
+
+  return keep_going != 0;
+}
+
 void Emul_dromajo::execute(Hartid_t fid) {
-  last[fid].pc = machine->cpu_state[fid]->pc;
-  (void)riscv_read_insn(machine->cpu_state[fid], &last[fid].insns, last[fid].pc);
+  if (!parallel) {
+    if (last[fid].flags & (last_insn | no_insn)) {
+      last[fid].flags = no_insn;
+      return;
+    }
+    last[fid].pc = machine->cpu_state[fid]->pc;
+    (void)riscv_read_insn(machine->cpu_state[fid], &last[fid].insns, last[fid].pc);
+    last[fid].flags = run_one(fid, last[fid]) ? 0 : last_insn;
+    return;
+  }
+
+  auto& s = *streams[fid];
+  if (s.pos == s.ready.size()) {
+    if (s.done) {
+      last[fid].flags = no_insn;
+      return;
+    }
 
-  virt_machine_run(machine, fid, 1);
+    s.ready.clear();
+    s.pos = 0;
 
-  last[fid].addr    = machine->cpu_state[fid]->last_data_paddr;
-  last[fid].next_pc = machine->cpu_state[fid]->pc;
+    std::unique_lock<std::mutex> lk(emul_mutex);
+    if (s.queue.empty()) {
+      nStarved->inc(detail == 0);
+      starving = true;
+      emul_cv.notify_all();
+      emul_cv.wait(lk, [&s] { return !s.queue.empty(); });
+      starving = false;
+    }
+    std::swap(s.ready, s.queue);
+    emul_cv.notify_all();  // room for the emulation thread
+  }
+
+  last[fid] = s.ready[s.pos++];
+  if (last[fid].flags & last_insn) {
+    s.done = true;
+  }
+}
+
+/* emulation thread {{{1 */
+
+void Emul_dromajo::start_harts() {
+  I(!parallel);
+  I(num > 1);
+
+  if (num > static_cast<Hartid_t>(machine->ncpus)) {
+    Config::add_error(fmt::format("section {} parallel with {} harts but the machine has ncpus={}", section, num, machine->ncpus));
+    Config::exit_on_error();
+  }
+
+  for (auto i = 0u; i < num; ++i) {
+    auto s  = std::make_unique<Hart_stream>();
+    s->done = (last[i].flags & (last_insn | no_insn)) != 0;  // terminated in the rabbit phase
+    streams.emplace_back(std::move(s));
+  }
+
+  parallel = true;
+  stop     = false;
+  worker   = std::thread(&Emul_dromajo::emul_loop, this);
+}
+
+void Emul_dromajo::stop_harts() {
+  if (!parallel) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lk(emul_mutex);
+    stop = true;
+    emul_cv.notify_all();
+  }
+  worker.join();
+  parallel = false;
+}
+
+void Emul_dromajo::emul_loop() {
+  std::vector<std::vector<Last_state>> batch(num);
+  std::vector<bool>                    running(num);
+
+  Hartid_t nrunning = 0;
+  for (auto fid = 0u; fid < num; ++fid) {
+    running[fid] = !streams[fid]->done;
+    nrunning += running[fid] ? 1 : 0;
+  }
+
+  while (nrunning) {
+    for (auto r = 0; r < emul_rounds && nrunning; ++r) {
+      for (auto fid = 0u; fid < num; ++fid) {
+        if (!running[fid]) {
+          continue;
+        }
+        auto& st = batch[fid].emplace_back();
+        st.pc    = machine->cpu_state[fid]->pc;
+        (void)riscv_read_insn(machine->cpu_state[fid], &st.insns, st.pc);
+        st.flags = 0;
+        if (!run_one(fid, st)) {
+          st.flags     = last_insn;
+          running[fid] = false;
+          --nrunning;
+        }
+      }
+    }
+    if (!publish(batch)) {
+      return;
+    }
+  }
+}
+
+bool Emul_dromajo::publish(std::vector<std::vector<Last_state>>& batch) {
+  std::unique_lock<std::mutex> lk(emul_mutex);
+
+  // Waiting for a full queue while the timing model waits for another hart
+  // would deadlock, so then the queues grow past lookahead
+  auto full = [this] {
+    for (const auto& s : streams) {
+      if (s->queue.size() >= lookahead) {
+        return true;
+      }
+    }
+    return false;
+  };
+  emul_cv.wait(lk, [this, &full] { return stop || starving || !full(); });
+  if (stop) {
+    return false;
+  }
+
+  for (auto fid = 0u; fid < num; ++fid) {
+    auto& q = streams[fid]->queue;
+    q.insert(q.end(), batch[fid].begin(), batch[fid].end());
+    batch[fid].clear();
+  }
+  emul_cv.notify_all();
+
+  return true;
 }
+/* }}} */
 
 Hartid_t Emul_dromajo::get_num() const { return num; }
 
@@ -2,8 +2,15 @@
 
 #pragma once
 
+#include <bit>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
 #include "dromajo.h"
 #include "emul_base.hpp"
+#include "stats.hpp"
 
 class Emul_dromajo : public Emul_base {
 private:
@@ -21,17 +28,72 @@ private:
     uint32_t insns;
     uint64_t pc;
     uint64_t next_pc;
-    uint64_t addr;  // memory address
+    uint64_t addr;   // memory address
+    uint8_t  flags;  // last_insn/no_insn once the hart terminates
   };
   std::vector<Last_state> last;
 
+  static constexpr uint8_t last_insn = 1;  // the hart terminated after this instruction
+  static constexpr uint8_t no_insn   = 2;  // nothing left, peek returns nullptr
+
+  bool run_one(Hartid_t fid, Last_state& st);
+
+  // Emulation thread (parallel = true with several harts). One worker host
+  // thread runs all the harts ahead of the timing model, one instruction each
+  // in a fixed round-robin order, so the machine is never shared between host
+  // threads and the streams do not depend on the host timing. The harts are
+  // not emulated concurrently: a thread per hart is out of scope, since the
+  // RISCVMachine is not thread safe. execute() consumes a per-hart queue. The
+  // worker waits while a hart has lookahead instructions queued, unless the
+  // timing model waits for another hart.
+  static constexpr int emul_rounds = 64;  // round-robin rounds per queue update
+
+  class Hart_stream {
+  public:
+    std::vector<Last_state> ready;  // consumed by execute (timing thread only)
+    size_t                  pos  = 0;
+    bool                    done = false;  // last_insn consumed (timing thread only)
+    std::vector<Last_state> queue;         // filled by the emulation thread, under emul_mutex
+  };
+  std::vector<std::unique_ptr<Hart_stream>> streams;
+  std::thread                               worker;
+
+  bool                    parallel = false;
+  uint64_t                lookahead;
+  bool                    stop     = false;  // under emul_mutex
+  bool                    starving = false;  // under emul_mutex
+  std::mutex              emul_mutex;
+  std::condition_variable emul_cv;
+
+  std::unique_ptr<Stats_cntr> nStarved;
+
+  void start_harts();
+  void stop_harts();
+  void emul_loop();
+  bool publish(std::vector<std::vector<Last_state>>& batch);
+
+  // Decoded instructions, direct mapped by pc and tagged with (pc, insn bits)
+  struct Decode_entry {
+    uint64_t    pc;
+    uint32_t    insns;
+    Instruction inst;
+  };
+  std::vector<Decode_entry>  decode_cache;
+  std::unique_ptr<Stats_avg> decodeHit;
+
+  // Starts invalid, and holds the last decode when decode_cache = 0
+  Instruction decode_miss{
+      Opcode::iOpInvalid, RegType::LREG_R0, RegType::LREG_R0, RegType::LREG_InvalidOutput, RegType::LREG_InvalidOutput};
+
+  const Instruction& decode_cached(uint64_t pc, uint32_t insn_raw);
+
 public:
   Emul_dromajo();
-  Emul_dromajo(const Emul_dromajo&)            = default;
+  Emul_dromajo(const Emul_dromajo&)            = delete;
   Emul_dromajo(Emul_dromajo&&)                 = delete;
-  Emul_dromajo& operator=(const Emul_dromajo&) = default;
+  Emul_dromajo& operator=(const Emul_dromajo&) = delete;
   Emul_dromajo& operator=(Emul_dromajo&&)      = delete;
-  ~Emul_dromajo() override                     = default;
+  ~Emul_dromajo() override;
 
   void destroy_machine();
 
@@ -42,7 +104,13 @@ public:
 
   [[nodiscard]] Hartid_t get_num() const final;
   [[nodiscard]] bool     is_sleeping(Hartid_t fid) const override;
+  [[nodiscard]] uint64_t get_insts_left() const override { return detail + time; }
 
   void set_detail(uint64_t ninst) { detail = ninst; }
   void set_time(uint64_t ninst) { time = ninst; }
+  void set_decode_cache(size_t nentries) {
+    I(nentries == 0 || std::has_single_bit(nentries));
+    decode_cache.clear();
+    decode_cache.resize(nentries, {0, 0, decode_miss});
+  }
 };
@@ -15,6 +15,18 @@ static void BM_InstructionExecuteAndDecode(benchmark::State& state) {
 }
 BENCHMARK(BM_InstructionExecuteAndDecode);
 
+static void BM_InstructionPeek(benchmark::State& state) {
+  // Same dynamic instruction over and over: decode cache hit path (or full decode with decode_cache = 0)
+  dromajo_ptr->set_decode_cache(state.range(0));
+  dromajo_ptr->set_time(1024 * 1024 * 1024);
+  for (auto _ : state) {
+    Dinst* dinst = dromajo_ptr->peek(0);
+    dinst->scrap();
+  }
+  dromajo_ptr->set_decode_cache(4096);
+}
+BENCHMARK(BM_InstructionPeek)->Arg(0)->Arg(4096);
+
 static void BM_InstructionExecute(benchmark::State& state) {
   dromajo_ptr->set_time(1024 * 1024 * 1024);  // Lots of instructions to make sure that it runs
   for (auto _ : state) {
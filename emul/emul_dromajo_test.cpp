@@ -146,3 +146,81 @@ TEST_F(Emul_Dromajo_test, dhrystone_test) {
   EXPECT_TRUE(inst->isStore());
   dinst->scrap();
 }
+
+class Emul_Dromajo_parallel_test : public ::testing::Test {
+protected:
+  static constexpr int nsteps = 5000;
+
+  struct Step {
+    Addr_t pc;
+    Addr_t addr;
+    bool   operator==(const Step&) const = default;
+  };
+  using Streams = std::vector<std::vector<Step>>;
+
+  void SetUp() override {
+    std::ofstream file;
+    file.open("emul_dromajo_parallel_test.toml");
+
+    file << "[soc]\n";
+    file << "core = [\"c0\", \"c0\"]\n";
+    file << "emul = [\"drom_emu\", \"drom_emu\"]\n";
+    file << "\n[drom_emu]\n";
+    file << "num = \"1\"\n";
+    file << "type = \"dromajo\"\n";
+    file << "rabbit = 0\n";
+    file << "detail = 1e6\n";
+    file << "time = 0\n";
+    file << "parallel = true\n";
+    file << "lookahead = 16\n";
+    file << "ncpus = \"2\"\n";
+    file << "bench=\"conf/dhrystone.riscv\"\n";
+    file.close();
+  }
+
+  static bool step(Emul_dromajo& drom, Hartid_t fid, Streams& out) {
+    drom.execute(fid);
+    Dinst* dinst = drom.peek(fid);
+    if (dinst == nullptr) {
+      return false;
+    }
+    out[fid].push_back({dinst->getPC(), dinst->getAddr()});
+    dinst->scrap();
+    return true;
+  }
+
+  // Runs both harts with the timing model consuming them in lockstep, or one
+  // hart after the other (which makes the second queue grow past lookahead)
+  static Streams run(bool lockstep) {
+    Config::init("emul_dromajo_parallel_test.toml");
+
+    Streams out(2);
+    {
+      Emul_dromajo drom;
+      if (lockstep) {
+        for (auto i = 0; i < nsteps; ++i) {
+          step(drom, 0, out);
+          step(drom, 1, out);
+        }
+      } else {
+        for (Hartid_t fid = 0; fid < 2; ++fid) {
+          for (auto i = 0; i < nsteps && step(drom, fid, out); ++i) {
+          }
+        }
+      }
+      drom.destroy_machine();
+    }
+    return out;
+  }
+};
+
+TEST_F(Emul_Dromajo_parallel_test, deterministic_streams) {
+  auto a = run(true);
+  auto b = run(false);
+  auto c = run(true);
+
+  EXPECT_FALSE(a[0].empty());
+  EXPECT_FALSE(a[1].empty());
+  EXPECT_EQ(a, b);  // the consumption order does not change what the harts execute
+  EXPECT_EQ(a, c);
+}
@@ -0,0 +1,240 @@
+// See LICENSE for details.
+
+#include "emul_random.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+static constexpr uint32_t max_dep_distance = 30;  // registers rotate over r1..r31
+
+Emul_random::Emul_random() : Emul_base() {
+  num = 0;
+
+  uint64_t rabbit = 0;
+  uint64_t seed   = 0;
+
+  auto nemuls = Config::get_array_size("soc", "emul");
+
+  harts.resize(nemuls);
+
+  std::vector<Hartid_t> fids;
+  for (auto i = 0u; i < nemuls; ++i) {
+    auto tp = Config::get_string("soc", "emul", i, "type");
+    if (tp != "random") {
+      continue;
+    }
+
+    if (num == 0) {
+      section = Config::get_string("soc", "emul", i);
+
+      seed   = Config::get_integer(section, "seed", 0);
+      detail = Config::get_integer(section, "detail");
+      time   = Config::get_integer(section, "time");
+      if (Config::has_entry(section, "rabbit")) {
+        rabbit = Config::get_integer(section, "rabbit");
+      }
+    }
+    fids.push_back(i);
+    ++num;
+  }
+
+  type = "random";
+  if (num == 0) {
+    return;
+  }
+
+  codeMask     = Config::get_power2(section, "code_size", 64, 1 << 24) / 4 - 1;
+  dataMask     = Config::get_power2(section, "data_size", 64, 1 << 30) - 1;
+  stride       = Config::get_integer(section, "stride", 1, 1 << 20);
+  branchRandom = Config::get_integer(section, "branch_random", 0, 100);
+  Config::exit_on_error();
+
+  generate(seed);
+
+  for (auto fid : fids) {
+    auto& h = harts[fid];
+    h.rng   = seed ^ (0x9E3779B97F4A7C15ULL * (fid + 1));
+    h.idx   = 0;
+    h.streams.resize(nStreams);
+    for (auto& s : h.streams) {
+      s = next_rand(h.rng) & dataMask & ~static_cast<Addr_t>(7);
+    }
+    resolve(h);
+
+    if (rabbit) {
+      skip_rabbit(fid, rabbit);
+    }
+  }
+}
+
+uint64_t Emul_random::next_rand(uint64_t& state) {
+  // splitmix64: one add and a few multiplies per number, and any seed is fine
+  uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+  z          = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z          = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+void Emul_random::generate(uint64_t seed)
+/* static program with the section mix {{{1 */
+{
+  struct Mix {
+    const char* name;
+    Opcode      op;
+  };
+  static constexpr std::array<Mix, 10> mix = {{
+      {"alu", Opcode::iAALU},
+      {"mult", Opcode::iCALU_MULT},
+      {"div", Opcode::iCALU_DIV},
+      {"fpalu", Opcode::iCALU_FPALU},
+      {"fpmult", Opcode::iCALU_FPMULT},
+      {"fpdiv", Opcode::iCALU_FPDIV},
+      {"load", Opcode::iLALU_LD},
+      {"store", Opcode::iSALU_ST},
+      {"branch", Opcode::iBALU_LBRANCH},
+      {"jump", Opcode::iBALU_LJUMP},
+  }};
+
+  std::array<uint32_t, mix.size()> weight;
+  uint32_t                         total = 0;
+  for (auto i = 0u; i < mix.size(); ++i) {
+    total += Config::get_integer(section, mix[i].name, 0, 1000);
+    weight[i] = total;
+  }
+  if (total == 0) {
+    Config::add_error(fmt::format("section {} needs a non zero weight in the instruction mix", section));
+  }
+
+  auto dep_distance = Config::get_integer(section, "dep_distance", 1, max_dep_distance);
+  auto branch_taken = Config::get_integer(section, "branch_taken", 0, 100);
+  auto stride_ratio = Config::get_integer(section, "stride_ratio", 0, 100);
+  Config::exit_on_error();
+
+  uint64_t rng = seed;
+  nStreams     = 0;
+
+  const uint32_t target_span = std::min<uint32_t>(16, codeMask - 1);
+
+  auto int_reg = [](uint32_t pos) { return static_cast<RegType>(1 + pos % 31); };
+  auto fp_reg  = [](uint32_t pos) { return static_cast<RegType>(static_cast<uint32_t>(RegType::LREG_FP0) + 1 + pos % 31); };
+
+  code.clear();
+  code.reserve(codeMask + 1);
+  for (uint32_t i = 0; i <= codeMask; ++i) {
+    auto pick = ((next_rand(rng) >> 32) * total) >> 32;
+    auto op   = mix[std::upper_bound(weight.begin(), weight.end(), pick) - weight.begin()].op;
+
+    // Distances in 1..2*dep_distance-1 average dep_distance. Position i+31
+    // writes the same register as position i, so i-d is the last writer.
+    auto src_pos = [&]() {
+      auto d = 1 + ((next_rand(rng) >> 32) * (2 * dep_distance - 1) >> 32);
+      return i + 31 * max_dep_distance - std::min<uint32_t>(d, max_dep_distance);
+    };
+
+    RegType src1 = int_reg(src_pos());
+    RegType src2 = int_reg(src_pos());
+    RegType dst1 = int_reg(i);
+    switch (op) {
+      case Opcode::iCALU_FPALU:
+      case Opcode::iCALU_FPMULT:
+      case Opcode::iCALU_FPDIV:
+        src1 = fp_reg(src_pos());
+        src2 = fp_reg(src_pos());
+        dst1 = fp_reg(i);
+        break;
+      case Opcode::iLALU_LD: src2 = LREG_NoDependence; break;
+      case Opcode::iSALU_ST:
+      case Opcode::iBALU_LBRANCH: dst1 = RegType::LREG_InvalidOutput; break;
+      case Opcode::iBALU_LJUMP:
+        src1 = LREG_NoDependence;
+        src2 = LREG_NoDependence;
+        dst1 = RegType::LREG_InvalidOutput;
+        break;
+      default: break;
+    }
+
+    Static_inst s{Instruction(op, src1, src2, dst1, RegType::LREG_InvalidOutput), 0, 0, false, false};
+
+    // Forward 2 to 17 instructions (fewer in a small program, where a longer
+    // jump would wrap around to pc+4 or pc), so a taken target is never either
+    s.target = (i + 2 + ((next_rand(rng) >> 32) * target_span >> 32)) & codeMask;
+    s.taken  = percent(rng) < static_cast<uint32_t>(branch_taken);
+    if ((op == Opcode::iLALU_LD || op == Opcode::iSALU_ST) && percent(rng) < static_cast<uint32_t>(stride_ratio)) {
+      s.strided = true;
+      s.stream  = nStreams++;
+    }
+
+    code.push_back(s);
+  }
+}
+/* }}} */
+
+void Emul_random::resolve(Hart& h) {
+  const auto& s = code[h.idx];
+
+  h.next = (h.idx + 1) & codeMask;
+  h.addr = 0;
+
+  switch (s.inst.getOpcode()) {
+    case Opcode::iLALU_LD:
+    case Opcode::iSALU_ST:
+      if (s.strided) {
+        auto& pos = h.streams[s.stream];
+        h.addr    = data_base + pos;
+        pos       = (pos + stride) & dataMask;
+      } else {
+        h.addr = data_base + (next_rand(h.rng) & dataMask & ~static_cast<Addr_t>(7));
+      }
+      break;
+    case Opcode::iBALU_LBRANCH: {
+      bool taken = s.taken;
+      if (branchRandom && percent(h.rng) < branchRandom) {
+        taken = next_rand(h.rng) & 1;
+      }
+      if (taken) {
+        h.next = s.target;
+        h.addr = get_pc(s.target);
+      }
+    } break;
+    case Opcode::iBALU_LJUMP:
+      h.next = s.target;
+      h.addr = get_pc(s.target);
+      break;
+    default: break;
+  }
+}
+
+Dinst* Emul_random::peek(Hartid_t fid) {
+  const auto& h = harts[fid];
+
+  if (detail > 0) {
+    --detail;
+    return Dinst::create(Instruction(code[h.idx].inst), get_pc(h.idx), h.addr, fid, false);
+  }
+  if (time > 0) {
+    --time;
+    return Dinst::create(Instruction(code[h.idx].inst), get_pc(h.idx), h.addr, fid, true);
+  }
+
+  return nullptr;
+}
+
+void Emul_random::execute(Hartid_t fid) {
+  auto& h = harts[fid];
+  h.idx   = h.next;
+  resolve(h);
+}
+
+void Emul_random::skip_rabbit(Hartid_t fid, size_t ninst) {
+  for (auto i = 0u; i < ninst; ++i) {
+    execute(fid);
+  }
+}
+
+Hartid_t Emul_random::get_num() const { return num; }
+
+bool Emul_random::is_sleeping(Hartid_t fid) const {
+  (void)fid;
+  return false;
+}
@@ -0,0 +1,80 @@
+// See LICENSE for details.
+
+#pragma once
+
+#include <vector>
+
+#include "emul_base.hpp"
+
+// Synthetic instruction stream (type = "random"). A static program of
+// code_size bytes is generated from seed with the opcode mix of the section,
+// and each hart walks it: branches have a fixed direction (branch_taken
+// percent of them are taken) except for the branch_random percent of the
+// outcomes that are drawn at random, and taken branches and jumps go a few
+// instructions forward, so the hart sweeps the program again and again.
+//
+// Sources read the destination of the instruction dep_distance (on average)
+// before. Loads and stores access a data_size footprint: stride_ratio percent
+// of the static loads/stores walk their own stream with stride, the rest
+// access random addresses. The same seed gives the same stream.
+class Emul_random : public Emul_base {
+private:
+  static constexpr Addr_t code_base = 0x10000;
+  static constexpr Addr_t data_base = 0x80000000;
+
+  class Static_inst {
+  public:
+    Instruction inst;
+    uint32_t    target;   // branch/jump target
+    uint32_t    stream;   // stream of a strided load/store
+    bool        taken;    // branch direction
+    bool        strided;
+  };
+
+  class Hart {
+  public:
+    uint64_t            rng;
+    uint32_t            idx;   // current instruction
+    uint32_t            next;  // instruction after the current one
+    Addr_t              addr;  // memory address, or taken target (0 not taken)
+    std::vector<Addr_t> streams;
+  };
+
+  std::vector<Static_inst> code;
+  std::vector<Hart>        harts;
+
+  uint64_t num;
+  uint64_t detail;
+  uint64_t time;
+
+  uint32_t codeMask;
+  Addr_t   dataMask;
+  Addr_t   stride;
+  uint32_t branchRandom;
+  uint32_t nStreams;
+
+  static uint64_t next_rand(uint64_t& state);
+  static uint32_t percent(uint64_t& state) { return ((next_rand(state) >> 32) * 100) >> 32; }
+
+  [[nodiscard]] static Addr_t get_pc(uint32_t idx) { return code_base + 4 * static_cast<Addr_t>(idx); }
+
+  void generate(uint64_t seed);
+  void resolve(Hart& h);
+
+public:
+  Emul_random();
+  Emul_random(const Emul_random&)            = delete;
+  Emul_random(Emul_random&&)                 = delete;
+  Emul_random& operator=(const Emul_random&) = delete;
+  Emul_random& operator=(Emul_random&&)      = delete;
+  ~Emul_random() override                    = default;
+
+  Dinst* peek(Hartid_t fid) final;
+
+  void skip_rabbit(Hartid_t fid, size_t ninst) final;
+  void execute(Hartid_t fid) final;
+
+  [[nodiscard]] Hartid_t get_num() const final;
+  [[nodiscard]] bool     is_sleeping(Hartid_t fid) const override;
+  [[nodiscard]] uint64_t get_insts_left() const override { return detail + time; }
+};
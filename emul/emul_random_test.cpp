@@ -0,0 +1,130 @@
+// This file is distributed under the BSD 3-Clause License. See LICENSE for details.
+
+#include "emul_random.hpp"
+
+#include <fstream>
+
+#include "config.hpp"
+#include "gtest/gtest.h"
+
+class Emul_random_test : public ::testing::Test {
+protected:
+  void setup(int branch_taken, int branch_random, int stride_ratio, int code_size = 4096, int jump = 0) {
+    std::ofstream file;
+    file.open("emul_random_test.toml");
+
+    file << "[soc]\n";
+    file << "core = [\"c0\"]\n";
+    file << "emul = [\"rand_emu\"]\n";
+    file << "\n[rand_emu]\n";
+    file << "type = \"random\"\n";
+    file << "seed = 7\n";
+    file << "detail = 0\n";
+    file << "time = 1000000\n";
+    file << "code_size = " << code_size << "\n";
+    file << "data_size = 65536\n";
+    file << "stride = 64\n";
+    file << "stride_ratio = " << stride_ratio << "\n";
+    file << "dep_distance = 4\n";
+    file << "branch_taken = " << branch_taken << "\n";
+    file << "branch_random = " << branch_random << "\n";
+    file << "alu = 50\n";
+    file << "mult = 0\n";
+    file << "div = 0\n";
+    file << "fpalu = 0\n";
+    file << "fpmult = 0\n";
+    file << "fpdiv = 0\n";
+    file << "load = 25\n";
+    file << "store = 10\n";
+    file << "branch = 15\n";
+    file << "jump = " << jump << "\n";
+    file.close();
+
+    Config::init("emul_random_test.toml");
+  }
+
+  // Taken targets go 2 to 17 instructions forward, wrapping in the program
+  static bool forward_target(Addr_t pc, Addr_t target, int code_size) {
+    auto dist = (target - pc) & static_cast<Addr_t>(code_size - 1);
+    return dist >= 2 * 4 && dist <= 17 * 4;
+  }
+};
+
+TEST_F(Emul_random_test, same_seed_same_stream) {
+  setup(50, 10, 50);
+
+  Emul_random a;
+  Emul_random b;
+
+  for (auto i = 0; i < 100000; ++i) {
+    auto* da = a.peek(0);
+    auto* db = b.peek(0);
+    ASSERT_EQ(da->getPC(), db->getPC());
+    ASSERT_EQ(da->getAddr(), db->getAddr());
+    ASSERT_EQ(da->getInst()->getOpcode(), db->getInst()->getOpcode());
+    da->scrap();
+    db->scrap();
+    a.execute(0);
+    b.execute(0);
+  }
+}
+
+TEST_F(Emul_random_test, mix_and_branch_bias) {
+  setup(100, 0, 100);
+
+  Emul_random emul;
+
+  int    nLoads  = 0;
+  int    nBranch = 0;
+  int    nTaken  = 0;
+  Addr_t next_pc = 0;
+  for (auto i = 0; i < 100000; ++i) {
+    auto* dinst = emul.peek(0);
+    auto  pc    = dinst->getPC();
+    if (next_pc) {
+      EXPECT_EQ(pc, next_pc);  // the stream follows the taken target
+    }
+    next_pc = 0;
+    if (dinst->getInst()->isLoad()) {
+      nLoads++;
+    }
+    if (dinst->getInst()->isBranch()) {
+      nBranch++;
+      if (dinst->getAddr()) {
+        nTaken++;
+        EXPECT_TRUE(forward_target(pc, dinst->getAddr(), 4096));
+        next_pc = dinst->getAddr();
+      }
+    }
+    dinst->scrap();
+    emul.execute(0);
+  }
+
+  // Taken branches skip instructions, so the dynamic mix is only close to the weights
+  EXPECT_GT(nLoads, 15000);
+  EXPECT_LT(nLoads, 35000);
+  EXPECT_GT(nBranch, 5000);
+  EXPECT_EQ(nTaken, nBranch);  // all the branches biased taken, no random outcomes
+}
+
+TEST_F(Emul_random_test, small_code_targets) {
+  setup(100, 0, 0, 64, 20);  // 16 instructions, taken targets can wrap
+
+  Emul_random emul;
+
+  int nTaken = 0;
+  for (auto i = 0; i < 10000; ++i) {
+    auto* dinst = emul.peek(0);
+    auto  pc    = dinst->getPC();
+    auto  inst  = dinst->getInst();
+    if ((inst->isBranch() || inst->isJump()) && dinst->getAddr()) {
+      nTaken++;
+      EXPECT_NE(dinst->getAddr(), pc);
+      EXPECT_NE(dinst->getAddr(), pc + 4);
+      EXPECT_TRUE(forward_target(pc, dinst->getAddr(), 64));
+    }
+    dinst->scrap();
+    emul.execute(0);
+  }
+  EXPECT_GT(nTaken, 0);
+}
@@ -4,16 +4,21 @@
 
 #include <pthread.h>
 #include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
+#include <algorithm>
 #include <cstdlib>
 
 #include "accprocessor.hpp"
 #include "config.hpp"
 #include "drawarch.hpp"
 #include "emul_dromajo.hpp"
+#include "emul_random.hpp"
 #include "gmemory_system.hpp"
 #include "gprocessor.hpp"
 #include "gpusmprocessor.hpp"
+#include "host_profile.hpp"
 #include "inorderprocessor.hpp"
 #include "memory_system.hpp"
 #include "oooprocessor.hpp"
@@ -83,6 +88,7 @@ void BootLoader::report(std::string_view str) {
   TaskHandler::report();
 
   Report::field(fmt::format("OSSim:msecs={}", (double)msecs / 1000));
+  Host_profile::report(globalClock);
 
   Stats::report_all();
 
@@ -96,9 +102,10 @@ void BootLoader::plug_emuls() {
   auto nemuls = Config::get_array_size("soc", "emul");
 
   std::shared_ptr<Emul_dromajo> dromajo;
+  std::shared_ptr<Emul_random>  random;
 
   for (auto i = 0u; i < nemuls; i++) {
-    auto type = Config::get_string("soc", "emul", i, "type", {"dromajo", "accel", "trace"});
+    auto type = Config::get_string("soc", "emul", i, "type", {"dromajo", "random", "accel", "trace"});
     if (type == "dromajo") {
       if (dromajo == nullptr) {
         dromajo = std::make_shared<Emul_dromajo>();
@@ -106,6 +113,11 @@ void BootLoader::plug_emuls() {
       if (dromajo) {  // Invalid dromahor otherwise
         TaskHandler::add_emul(dromajo, i);
       }
+    } else if (type == "random") {
+      if (random == nullptr) {
+        random = std::make_shared<Emul_random>();
+      }
+      TaskHandler::add_emul(random, i);
     } else if (type == "accel") {
       Config::add_error("accel still not implemented");
     } else if (type == "trace") {
@@ -143,6 +155,8 @@ void BootLoader::plug(int argc, const char** argv) {
   // Before boot
 
   std::string conf_file  = "desesc.toml";
+  std::string batch;
+  std::string snapshot;
   bool        just_check = false;
 
   for (auto i = 1; i < argc; ++i) {
@@ -153,6 +167,20 @@ void BootLoader::plug(int argc, const char** argv) {
         exit(-3);
       }
       conf_file = argv[i];
+    } else if (strcmp(argv[i], "-b") == 0) {
+      ++i;
+      if (i >= argc) {
+        fmt::print("after -b, there should be a batch section name\n");
+        exit(-3);
+      }
+      batch = argv[i];
+    } else if (strcmp(argv[i], "-s") == 0) {
+      ++i;
+      if (i >= argc) {
+        fmt::print("after -s, there should be a snapshot file name\n");
+        exit(-3);
+      }
+      snapshot = argv[i];
     } else if (strcasecmp(argv[i], "check") == 0) {
       just_check = true;
     } else {
@@ -162,6 +190,21 @@ void BootLoader::plug(int argc, const char** argv) {
   }
   Config::init(conf_file);
 
+  if (!snapshot.empty()) {
+    Config::save_snapshot(snapshot);
+    Config::exit_on_error();
+    fmt::print("configuration {} saved as snapshot {}\n", conf_file, snapshot);
+    exit(0);
+  }
+
+  if (!batch.empty() && !just_check) {
+    run_batch(batch);
+  }
+
+  plug_system(just_check);
+}
+
+void BootLoader::plug_system(bool just_check) {
   auto ncores = Config::get_array_size("soc", "core");
   auto nemuls = Config::get_array_size("soc", "emul");
 
@@ -190,6 +233,177 @@ void BootLoader::plug(int argc, const char** argv) {
   TaskHandler::plugEnd();
 }
 
+void BootLoader::run_batch(const std::string& batch) {
+  auto emul_section = Config::get_string(batch, "emul");
+  auto nloads       = Config::get_array_size(batch, "load", 4096);
+  auto nweights     = Config::get_array_size(batch, "weight", 4096);
+  auto njobs        = static_cast<size_t>(Config::get_integer(batch, "jobs", 1, 1024));
+
+  if (nloads == 0) {
+    Config::add_error(fmt::format("batch section [{}] should have at least one checkpoint in load", batch));
+  } else if (nloads != nweights) {
+    Config::add_error(fmt::format("batch section [{}] load and weight should have the same size ({} vs {})", batch, nloads, nweights));
+  }
+
+  std::vector<Batch_result> results(nloads);
+  for (auto i = 0u; i < nloads && i < nweights; ++i) {
+    results[i].load   = Config::get_array_string(batch, "load", i);
+    results[i].weight = Config::get_array_double(batch, "weight", i);
+    if (results[i].weight < 0) {
+      Config::add_error(fmt::format("batch section [{}] weight {} is negative", batch, i));
+    }
+  }
+  Config::exit_on_error();
+
+  gettimeofday(&stTime, 0);
+
+  struct Job {
+    pid_t  pid;
+    int    fd;
+    size_t pos;
+  };
+  std::vector<Job> running;
+
+  size_t next = 0;
+  while (next < nloads || !running.empty()) {
+    while (next < nloads && running.size() < njobs) {
+      int fds[2];
+      if (pipe(fds) != 0) {
+        perror("BootLoader::run_batch could not create pipe:");
+        exit(-1);
+      }
+      fflush(stdout);
+      fflush(stderr);
+
+      auto pid = fork();
+      if (pid < 0) {
+        perror("BootLoader::run_batch could not fork:");
+        exit(-1);
+      }
+      if (pid == 0) {
+        ::close(fds[0]);
+        run_batch_job(emul_section, results[next].load, next, fds[1]);
+      }
+      ::close(fds[1]);
+      running.push_back({pid, fds[0], next});
+      ++next;
+    }
+
+    int  status = 0;
+    auto pid    = waitpid(-1, &status, 0);
+    if (pid < 0) {
+      perror("BootLoader::run_batch waitpid:");
+      break;
+    }
+
+    auto it = std::find_if(running.begin(), running.end(), [pid](const Job& j) { return j.pid == pid; });
+    if (it == running.end()) {
+      continue;
+    }
+
+    // The job writes a single short line (< PIPE_BUF) right before exiting, so it is already in the pipe
+    char buffer[128];
+    auto sz = ::read(it->fd, buffer, sizeof(buffer) - 1);
+    ::close(it->fd);
+
+    auto& res = results[it->pos];
+    if (sz > 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+      buffer[sz]                 = 0;
+      unsigned long long ninst   = 0;
+      unsigned long long ncycles = 0;
+
+      res.done    = sscanf(buffer, "%llu %llu", &ninst, &ncycles) == 2 && ninst > 0;
+      res.ninst   = ninst;
+      res.ncycles = ncycles;
+    }
+    if (!res.done) {
+      fmt::print("batch: checkpoint {} ({}) failed\n", it->pos, res.load);
+    } else {
+      fmt::print("batch: checkpoint {} ({}) cpi={:.4f}\n", it->pos, res.load, static_cast<double>(res.ncycles) / res.ninst);
+    }
+
+    running.erase(it);
+  }
+
+  report_batch(batch, results);
+
+  auto all_done = std::all_of(results.begin(), results.end(), [](const Batch_result& r) { return r.done; });
+  exit(all_done ? 0 : -1);
+}
+
+void BootLoader::run_batch_job(const std::string& emul_section, const std::string& load, size_t pos, int fd) {
+  // NOTE: each job is a forked copy of the parent, so the TOML tree is parsed once and all the static simulator state
+  // (TaskHandler, EventScheduler, Stats, pools) is private to the job without any locking in the hot loops.
+  Config::set_string(emul_section, "load", load);
+  setenv("REPORTFILE2", fmt::format("sp{}", pos).c_str(), 1);
+
+  plug_system(false);
+  boot();
+
+  uint64_t ninst  = 0;
+  auto     ncores = Config::get_array_size("soc", "core");
+  for (auto i = 0u; i < ncores; ++i) {
+    ninst += static_cast<uint64_t>(Stats::get_cntr(fmt::format("P({}):nCommitted", i)));
+  }
+
+  auto msg = fmt::format("{} {}\n", ninst, globalClock);
+  auto sz  = ::write(fd, msg.data(), msg.size());
+  (void)sz;
+  ::close(fd);
+
+  report(fmt::format("batch sp{}", pos));
+  unboot();
+  unplug();
+
+  fflush(stdout);
+  _exit(0);
+}
+
+void BootLoader::report_batch(const std::string& batch, const std::vector<Batch_result>& results) {
+  timeval endTime;
+  gettimeofday(&endTime, 0);
+
+  setenv("REPORTFILE2", "batch", 1);
+  Report::init();
+
+  Report::field(fmt::format("#BEGIN:report batch {}", batch));
+  Report::field(fmt::format("OSSim:beginTime={}", ctime(&stTime.tv_sec)));
+  Report::field(fmt::format("OSSim:endTime={}", ctime(&endTime.tv_sec)));
+
+  double sum_weight = 0;
+  double sum_cpi    = 0;
+  for (auto i = 0u; i < results.size(); ++i) {
+    const auto& res = results[i];
+
+    Report::field(fmt::format("Batch:sp({})load={}", i, res.load));
+    Report::field(fmt::format("Batch:sp({})weight={}", i, res.weight));
+    Report::field(fmt::format("Batch:sp({})done={}", i, res.done));
+    if (!res.done) {
+      continue;
+    }
+
+    auto cpi = static_cast<double>(res.ncycles) / res.ninst;
+    Report::field(fmt::format("Batch:sp({})nInst={}", i, res.ninst));
+    Report::field(fmt::format("Batch:sp({})nCycles={}", i, res.ncycles));
+    Report::field(fmt::format("Batch:sp({})cpi={}", i, cpi));
+
+    sum_weight += res.weight;
+    sum_cpi += res.weight * cpi;
+  }
+
+  double msecs = (endTime.tv_sec - stTime.tv_sec) * 1000 + (endTime.tv_usec - stTime.tv_usec) / 1000;
+
+  auto cpi = sum_weight > 0 ? sum_cpi / sum_weight : 0;
+  Report::field(fmt::format("Batch:coveredWeight={}", sum_weight));
+  Report::field(fmt::format("Batch:weightedCPI={}", cpi));
+  Report::field(fmt::format("Batch:weightedIPC={}", cpi > 0 ? 1.0 / cpi : 0));
+  Report::field(fmt::format("OSSim:msecs={}", msecs / 1000));
+  Report::field(fmt::format("#END:report batch {}", batch));
+  Report::close();
+
+  fmt::print("batch: {} checkpoints weightedCPI={:.4f} (weight covered {:.3f})\n", results.size(), cpi, sum_weight);
+}
+
 void BootLoader::boot() {
   gettimeofday(&stTime, 0);
 
@@ -5,6 +5,7 @@
 #include <sys/time.h>
 
 #include <string>
+#include <vector>
 
 // #include "power_model.hpp"
 #include "iassert.hpp"
@@ -21,6 +22,20 @@ private:
 protected:
   static void plug_emuls();
   static void plug_simus();
+  static void plug_system(bool just_check);
+
+  // Batch mode: one parsed configuration, many weighted checkpoints, each simulated in a forked worker
+  struct Batch_result {
+    std::string load;
+    double      weight{0};
+    uint64_t    ninst{0};
+    uint64_t    ncycles{0};
+    bool        done{false};
+  };
+
+  [[noreturn]] static void run_batch(const std::string& batch);
+  [[noreturn]] static void run_batch_job(const std::string& emul_section, const std::string& load, size_t pos, int fd);
+  static void              report_batch(const std::string& batch, const std::vector<Batch_result>& results);
 
 public:
   static int64_t sample_count;
@@ -0,0 +1,137 @@
+// See LICENSE for details.
+
+// Prints the Stats of running simulations from their stats_mirror files
+//
+//   desesc_stats [-d secs] [-p pattern]... file...
+//
+// -p keeps the stats whose name contains the pattern (all by default). -d
+// reads each file twice, secs apart, and prints the change of each stat.
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "fmt/format.h"
+#include "stats_mirror.hpp"
+
+class Mirror_file {
+public:
+  std::string              path;
+  void*                    base = nullptr;
+  size_t                   size = 0;
+  std::vector<std::string> names;
+  std::vector<double>      values;
+};
+
+static bool map_file(Mirror_file& m) {
+  int fd = open(m.path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    close(fd);
+    return false;
+  }
+  m.size = st.st_size;
+  m.base = mmap(nullptr, m.size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+
+  return m.base != MAP_FAILED;
+}
+
+static bool selected(const std::string& name, const std::vector<std::string>& patterns) {
+  if (patterns.empty()) {
+    return true;
+  }
+  for (const auto& p : patterns) {
+    if (name.find(p) != std::string::npos) {
+      return true;
+    }
+  }
+  return false;
+}
+
+int main(int argc, const char** argv) {
+  std::vector<std::string> patterns;
+  std::vector<Mirror_file> files;
+  int                      delay = 0;
+
+  for (auto i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+      patterns.emplace_back(argv[++i]);
+    } else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+      delay = atoi(argv[++i]);
+    } else if (argv[i][0] == '-') {
+      fmt::print(stderr, "usage: {} [-d secs] [-p pattern]... file...\n", argv[0]);
+      return 3;
+    } else {
+      files.emplace_back();
+      files.back().path = argv[i];
+    }
+  }
+
+  if (files.empty()) {
+    fmt::print(stderr, "usage: {} [-d secs] [-p pattern]... file...\n", argv[0]);
+    return 3;
+  }
+
+  int                  errors = 0;
+  Stats_mirror::Header h;
+  for (auto& m : files) {
+    if (!map_file(m) || !Stats_mirror::read(m.base, m.size, h, m.names, m.values)) {
+      fmt::print(stderr, "{} is not a stats mirror\n", m.path);
+      m.base = nullptr;
+      errors++;
+    }
+  }
+
+  if (delay > 0) {
+    sleep(delay);
+  }
+
+  for (auto& m : files) {
+    if (m.base == nullptr) {
+      continue;
+    }
+
+    auto prev = m.values;
+    if (!Stats_mirror::read(m.base, m.size, h, m.names, m.values)) {
+      fmt::print(stderr, "{} is not a stats mirror anymore, or its writer is stuck\n", m.path);
+      munmap(m.base, m.size);
+      errors++;
+      continue;
+    }
+
+    fmt::print("# {} pid={} clock={} insts={} KIPS={:.1f} KCPS={:.1f} updates={}{}\n",
+               m.path,
+               h.pid,
+               h.clock,
+               h.insts,
+               h.host_ns ? 1e6 * h.insts / h.host_ns : 0.0,
+               h.host_ns ? 1e6 * h.clock / h.host_ns : 0.0,
+               h.updates,
+               h.done ? " done" : "");
+
+    for (size_t i = 0; i < m.names.size(); ++i) {
+      if (!selected(m.names[i], patterns)) {
+        continue;
+      }
+      if (delay > 0) {
+        fmt::print("{}={} delta={}\n", m.names[i], m.values[i], m.values[i] - prev[i]);
+      } else {
+        fmt::print("{}={}\n", m.names[i], m.values[i]);
+      }
+    }
+
+    munmap(m.base, m.size);
+  }
+
+  return errors ? 1 : 0;
+}
@@ -77,8 +77,8 @@ bool Bus::isBusy(Addr_t addr) const {
   return false;
 }
 
-void Bus::tryPrefetch(Addr_t addr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb) {
-  router->tryPrefetch(addr, doStats, degree, pref_sign, pc, cb);
+void Bus::tryPrefetch(Addr_t addr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb, Time_t age) {
+  router->tryPrefetch(addr, doStats, degree, pref_sign, pc, cb, age);
 }
 
 TimeDelta_t Bus::ffread(Addr_t addr) {
@@ -37,7 +37,7 @@ public:
   TimeDelta_t ffread(Addr_t addr);
   TimeDelta_t ffwrite(Addr_t addr);
 
-  void tryPrefetch(Addr_t addr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb = 0);
+  void tryPrefetch(Addr_t addr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb = 0, Time_t age = 0);
 
   bool isBusy(Addr_t addr) const;
 };
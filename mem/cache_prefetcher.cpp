@@ -0,0 +1,317 @@
+// See LICENSE for details.
+
+#include "cache_prefetcher.hpp"
+
+#include <algorithm>
+#include <bit>
+
+#include "config.hpp"
+#include "fmt/format.h"
+#include "memobj.hpp"
+
+// A prefetch still pending after this many cycles was dropped on the way
+static constexpr Time_t max_inflight_age = 4096;
+
+std::unique_ptr<Cache_prefetcher> Cache_prefetcher::create(const std::string& section, const std::string& cache_name,
+                                                           uint32_t line_size) {
+  auto type = Config::get_string(section, "type", {"bop", "region"});
+
+  if (type == "bop") {
+    return std::make_unique<Best_offset_prefetcher>(section, cache_name, line_size);
+  }
+  if (type == "region") {
+    return std::make_unique<Region_prefetcher>(section, cache_name, line_size);
+  }
+
+  Config::add_error(fmt::format("prefetcher section [{}] has an unknown type {}", section, type));
+  return nullptr;
+}
+
+Cache_prefetcher::Cache_prefetcher(const std::string& section, const std::string& cache_name, uint32_t line_size, Addr_t _sign)
+    /* constructor {{{1 */
+    : sign(_sign)
+    , lineSizeBits(log2i(line_size))
+    , degree(Config::get_integer(section, "degree", 1, 32))
+    , nIssued(fmt::format("{}_pf:nIssued", cache_name))
+    , nThrottled(fmt::format("{}_pf:nThrottled", cache_name))
+    , nUseful(fmt::format("{}_pf:nUseful", cache_name))
+    , nLate(fmt::format("{}_pf:nLate", cache_name))
+    , nWasteful(fmt::format("{}_pf:nWasteful", cache_name))
+    , nDemandMiss(fmt::format("{}_pf:nDemandMiss", cache_name))
+    , accuracy(fmt::format("{}_pf_accuracy", cache_name))
+    , coverage(fmt::format("{}_pf_coverage", cache_name))
+    , timeliness(fmt::format("{}_pf_timeliness", cache_name))
+    , avgFillLat(fmt::format("{}_pf_avgFillLat", cache_name)) {
+  inflight.resize(128, Inflight{0, 0});
+  lateLine = 0;
+}
+/* }}} */
+
+void Cache_prefetcher::demand(Addr_t addr, bool doStats) {
+  auto  line = addr >> lineSizeBits;
+  auto& e    = get_inflight(line);
+  if (e.line != line || e.issued + max_inflight_age < globalClock) {
+    return;
+  }
+
+  // The demand arrived before the prefetched line: late, but still accurate
+  e.line   = 0;
+  lateLine = line;
+  nLate.inc(doStats);
+  accuracy.sample(1, doStats);
+  coverage.sample(1, doStats);
+  timeliness.sample(0, doStats);
+}
+
+void Cache_prefetcher::train(Addr_t addr, Addr_t pc, bool miss, bool prefetch_hit, bool doStats, std::vector<Addr_t>& candidates) {
+  auto line = addr >> lineSizeBits;
+
+  if (prefetch_hit) {
+    nUseful.inc(doStats);
+    accuracy.sample(1, doStats);
+    coverage.sample(1, doStats);
+    timeliness.sample(1, doStats);
+  } else if (miss && line != lateLine) {
+    nDemandMiss.inc(doStats);
+    coverage.sample(0, doStats);
+  }
+  lateLine = 0;
+
+  lines.clear();
+  on_access(line, pc, miss, prefetch_hit, doStats, lines);
+
+  for (auto l : lines) {
+    candidates.push_back(l << lineSizeBits);
+  }
+}
+
+void Cache_prefetcher::issued(Addr_t addr, bool doStats) {
+  auto  line = addr >> lineSizeBits;
+  auto& e    = get_inflight(line);
+  e.line     = line;
+  e.issued   = globalClock;
+
+  nIssued.inc(doStats);
+}
+
+void Cache_prefetcher::fill(Addr_t addr, bool prefetch, bool doStats) {
+  auto line = addr >> lineSizeBits;
+
+  if (prefetch) {
+    auto& e = get_inflight(line);
+    if (e.line == line) {
+      avgFillLat.sample(globalClock - e.issued, doStats);
+      e.line = 0;
+    }
+  }
+
+  on_fill(line, prefetch);
+}
+
+void Cache_prefetcher::evict(Addr_t addr, bool unused_prefetch, bool doStats) {
+  if (unused_prefetch) {
+    nWasteful.inc(doStats);
+    accuracy.sample(0, doStats);
+  }
+
+  on_evict(addr >> lineSizeBits);
+}
+
+/* Best_offset_prefetcher {{{1 */
+
+Best_offset_prefetcher::Best_offset_prefetcher(const std::string& section, const std::string& cache_name, uint32_t line_size)
+    : Cache_prefetcher(section, cache_name, line_size, PSIGN_BOP)
+    , scoreMax(Config::get_integer(section, "score_max", 1, 255))
+    , roundMax(Config::get_integer(section, "round_max", 1, 1024))
+    , badScore(Config::get_integer(section, "bad_score", 0, 255))
+    , avgOffset(fmt::format("{}_pf_avgOffset", cache_name)) {
+  auto max_offset = Config::get_integer(section, "max_offset", 1, 256);
+  auto rr_size    = Config::get_power2(section, "rr_size", 16, 65536);
+  auto page_size  = Config::get_power2(section, "page_size", line_size, 1 << 30);
+
+  pageLinesBits = log2i(page_size) - lineSizeBits;
+
+  // Offsets whose prime factors are 2, 3 or 5 (52 of them up to 256)
+  for (int32_t o = 1; o <= max_offset; ++o) {
+    auto n = o;
+    for (auto p : {2, 3, 5}) {
+      while (n % p == 0) {
+        n /= p;
+      }
+    }
+    if (n == 1 && o < (1 << pageLinesBits)) {
+      offsets.push_back(o);
+    }
+  }
+  if (offsets.empty()) {
+    Config::add_error(fmt::format("prefetcher section [{}] has no offset below max_offset and the page size", section));
+    offsets.push_back(1);
+  }
+
+  scores.resize(offsets.size(), 0);
+  rr.resize(rr_size, 0);
+
+  testPos    = 0;
+  round      = 0;
+  bestOffset = 1;
+  enabled    = true;
+}
+
+void Best_offset_prefetcher::end_phase() {
+  auto best = std::max_element(scores.begin(), scores.end());
+
+  bestOffset = offsets[best - scores.begin()];
+  enabled    = *best > badScore;
+
+  std::fill(scores.begin(), scores.end(), 0);
+  testPos = 0;
+  round   = 0;
+}
+
+void Best_offset_prefetcher::learn(Addr_t line) {
+  auto o = offsets[testPos];
+  if (line > static_cast<Addr_t>(o) && rr_hit(line - o)) {
+    if (++scores[testPos] >= scoreMax) {
+      end_phase();
+      return;
+    }
+  }
+
+  if (++testPos == offsets.size()) {
+    testPos = 0;
+    if (++round >= roundMax) {
+      end_phase();
+    }
+  }
+}
+
+void Best_offset_prefetcher::on_access(Addr_t line, [[maybe_unused]] Addr_t pc, bool miss, bool prefetch_hit, bool doStats,
+                                       std::vector<Addr_t>& candidates) {
+  if (!miss && !prefetch_hit) {
+    return;
+  }
+
+  learn(line);
+
+  if (!enabled) {
+    if (miss) {
+      rr_insert(line);  // no prefetch fills to learn from
+    }
+    return;
+  }
+
+  avgOffset.sample(bestOffset, doStats);
+
+  auto page = line >> pageLinesBits;
+  for (int32_t k = 1; k <= degree; ++k) {
+    auto target = line + static_cast<Addr_t>(k) * bestOffset;
+    if ((target >> pageLinesBits) != page) {
+      break;
+    }
+    candidates.push_back(target);
+  }
+}
+
+void Best_offset_prefetcher::on_fill(Addr_t line, bool prefetch) {
+  if (prefetch && line > static_cast<Addr_t>(bestOffset)) {
+    rr_insert(line - bestOffset);
+  }
+}
+
+/* }}} */
+
+/* Region_prefetcher {{{1 */
+
+Region_prefetcher::Region_prefetcher(const std::string& section, const std::string& cache_name, uint32_t line_size)
+    : Cache_prefetcher(section, cache_name, line_size, PSIGN_REGION)
+    , nGenerations(fmt::format("{}_pf:nGenerations", cache_name))
+    , nPHTHit(fmt::format("{}_pf:nPHTHit", cache_name)) {
+  auto region_size = Config::get_power2(section, "region_size", 2 * line_size, 64 * line_size);
+  auto agt_size    = Config::get_integer(section, "agt_size", 1, 1024);
+  auto pht_size    = Config::get_power2(section, "pht_size", 16, 1 << 20);
+
+  regionLinesBits = log2i(region_size) - lineSizeBits;
+
+  agt.resize(agt_size, Generation{0, 0, 0, 0, 0, false});
+  pht.resize(pht_size, Pattern{0, 0});
+
+  useCounter = 0;
+}
+
+void Region_prefetcher::end_generation(Generation& g) {
+  I(g.valid);
+  g.valid = false;
+
+  if (std::popcount(g.pattern) < 2) {
+    return;  // only the trigger line, nothing to learn
+  }
+
+  auto  key = pht_key(g.pc, g.trigger);
+  auto& p   = pht[pht_index(key)];
+  p.tag     = key;
+  p.pattern = g.pattern;
+}
+
+void Region_prefetcher::on_access(Addr_t line, Addr_t pc, [[maybe_unused]] bool miss, [[maybe_unused]] bool prefetch_hit,
+                                  bool doStats, std::vector<Addr_t>& candidates) {
+  auto region = line >> regionLinesBits;
+  auto offset = static_cast<uint32_t>(line & ((1UL << regionLinesBits) - 1));
+
+  ++useCounter;
+
+  Generation* victim = &agt[0];
+  for (auto& g : agt) {
+    if (g.valid && g.region == region) {
+      g.pattern |= 1UL << offset;
+      g.last_use = useCounter;
+      return;
+    }
+    if (!victim->valid) {
+      continue;
+    }
+    if (!g.valid || g.last_use < victim->last_use) {
+      victim = &g;
+    }
+  }
+
+  // Trigger access: start a new generation and replay the footprint of the last one
+  if (victim->valid) {
+    end_generation(*victim);
+  }
+  nGenerations.inc(doStats);
+
+  victim->region   = region;
+  victim->pc       = pc;
+  victim->pattern  = 1UL << offset;
+  victim->last_use = useCounter;
+  victim->trigger  = offset;
+  victim->valid    = true;
+
+  auto        key = pht_key(pc, offset);
+  const auto& p   = pht[pht_index(key)];
+  if (p.tag != key) {
+    return;
+  }
+  nPHTHit.inc(doStats);
+
+  auto    pattern = p.pattern & ~(1UL << offset);
+  int32_t n       = 0;
+  while (pattern && n < degree) {
+    auto i = std::countr_zero(pattern);
+    pattern &= pattern - 1;
+    candidates.push_back((region << regionLinesBits) | i);
+    ++n;
+  }
+}
+
+void Region_prefetcher::on_evict(Addr_t line) {
+  auto region = line >> regionLinesBits;
+  for (auto& g : agt) {
+    if (g.valid && g.region == region) {
+      end_generation(g);
+      return;
+    }
+  }
+}
+
+/* }}} */
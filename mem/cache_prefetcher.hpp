@@ -0,0 +1,164 @@
+// See LICENSE for details.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "callback.hpp"
+#include "iassert.hpp"
+#include "opcode.hpp"
+#include "snippets.hpp"
+#include "stats.hpp"
+
+// Prefetch engine attached to a CCache (prefetcher = "section" in the cache
+// section). The cache trains it with its demand accesses and issues the
+// candidate lines through its own tryPrefetch path, so the MSHR and the cache
+// port throttle them like any other prefetch.
+//
+// Lines filled by the engine carry its prefetch sign, which gives:
+//   accuracy:   (useful + late) / (useful + late + wasteful)
+//   coverage:   (useful + late) / (useful + late + demand misses)
+//   timeliness: useful / (useful + late)
+// where late is a demand that found the prefetch still in flight.
+class Cache_prefetcher {
+public:
+  virtual ~Cache_prefetcher() = default;
+
+  // Returns nullptr (and adds a config error) on an unknown type
+  static std::unique_ptr<Cache_prefetcher> create(const std::string& section, const std::string& cache_name, uint32_t line_size);
+
+  [[nodiscard]] Addr_t get_sign() const { return sign; }
+
+  // Demand request entering the cache (not retrying), before the MSHR check
+  void demand(Addr_t addr, bool doStats);
+  // Demand lookup result: trains the engine and returns the addresses to prefetch
+  void train(Addr_t addr, Addr_t pc, bool miss, bool prefetch_hit, bool doStats, std::vector<Addr_t>& candidates);
+  // A candidate was sent from the cache
+  void issued(Addr_t addr, bool doStats);
+  // The cache could not take more prefetches (MSHR or port busy)
+  void throttled(bool doStats) { nThrottled.inc(doStats); }
+  // Line allocated in the cache (prefetch is true if the engine brought it)
+  void fill(Addr_t addr, bool prefetch, bool doStats);
+  // Line evicted (unused_prefetch if the engine brought it and it was never used)
+  void evict(Addr_t addr, bool unused_prefetch, bool doStats);
+
+protected:
+  Cache_prefetcher(const std::string& section, const std::string& cache_name, uint32_t line_size, Addr_t sign);
+
+  const Addr_t   sign;
+  const uint32_t lineSizeBits;
+  const int32_t  degree;
+
+  virtual void on_access(Addr_t line, Addr_t pc, bool miss, bool prefetch_hit, bool doStats, std::vector<Addr_t>& lines) = 0;
+  virtual void on_fill(Addr_t line, bool prefetch) {
+    (void)line;
+    (void)prefetch;
+  }
+  virtual void on_evict(Addr_t line) { (void)line; }
+
+private:
+  // Small direct mapped table of the prefetches in flight, to detect late prefetches
+  class Inflight {
+  public:
+    Addr_t line;
+    Time_t issued;
+  };
+  std::vector<Inflight> inflight;
+  Addr_t                lateLine;  // last demand found late, not counted again as a miss
+
+  std::vector<Addr_t> lines;  // scratch for on_access
+
+  Stats_cntr nIssued;
+  Stats_cntr nThrottled;
+  Stats_cntr nUseful;
+  Stats_cntr nLate;
+  Stats_cntr nWasteful;
+  Stats_cntr nDemandMiss;
+  Stats_avg  accuracy;
+  Stats_avg  coverage;
+  Stats_avg  timeliness;
+  Stats_avg  avgFillLat;
+
+  [[nodiscard]] Inflight& get_inflight(Addr_t line) { return inflight[(line ^ (line >> 7)) & (inflight.size() - 1)]; }
+};
+
+// Best-Offset prefetcher (Michaud, HPCA 2016). Learns, in phases, the offset
+// D such that X-D was recently filled for the triggering line X, and
+// prefetches X+D (X+k*D with degree k) within the page. A recent request
+// table (RR) holds the base of the lines brought by the prefetcher (or the
+// demand misses while prefetching is off).
+class Best_offset_prefetcher : public Cache_prefetcher {
+public:
+  Best_offset_prefetcher(const std::string& section, const std::string& cache_name, uint32_t line_size);
+
+protected:
+  std::vector<int32_t>  offsets;
+  std::vector<int32_t>  scores;
+  std::vector<Addr_t>   rr;
+  const int32_t         scoreMax;
+  const int32_t         roundMax;
+  const int32_t         badScore;
+  uint32_t              pageLinesBits;
+  size_t                testPos;
+  int32_t               round;
+  int32_t               bestOffset;
+  bool                  enabled;
+
+  Stats_avg avgOffset;
+
+  [[nodiscard]] size_t rr_index(Addr_t line) const { return (line ^ (line >> 8)) & (rr.size() - 1); }
+  [[nodiscard]] bool   rr_hit(Addr_t line) const { return rr[rr_index(line)] == line; }
+  void                 rr_insert(Addr_t line) { rr[rr_index(line)] = line; }
+
+  void learn(Addr_t line);
+  void end_phase();
+
+  void on_access(Addr_t line, Addr_t pc, bool miss, bool prefetch_hit, bool doStats, std::vector<Addr_t>& lines) override;
+  void on_fill(Addr_t line, bool prefetch) override;
+};
+
+// Spatial region prefetcher in the style of SMS (Somogyi, ISCA 2006). An
+// active generation table (AGT) records the lines touched in each live
+// region; when a generation ends (AGT replacement or a line of the region is
+// evicted) its footprint is stored in a pattern history table (PHT) indexed
+// by the trigger PC and offset. The next trigger with the same PC and offset
+// prefetches the recorded footprint.
+class Region_prefetcher : public Cache_prefetcher {
+public:
+  Region_prefetcher(const std::string& section, const std::string& cache_name, uint32_t line_size);
+
+protected:
+  class Generation {
+  public:
+    Addr_t   region;
+    Addr_t   pc;
+    uint64_t pattern;
+    uint64_t last_use;
+    uint32_t trigger;  // offset of the trigger line
+    bool     valid;
+  };
+  class Pattern {
+  public:
+    Addr_t   tag;
+    uint64_t pattern;
+  };
+
+  uint32_t                regionLinesBits;
+  std::vector<Generation> agt;
+  std::vector<Pattern>    pht;
+  uint64_t                useCounter;
+
+  Stats_cntr nGenerations;
+  Stats_cntr nPHTHit;
+
+  [[nodiscard]] Addr_t pht_key(Addr_t pc, uint32_t offset) const { return ((pc >> 1) << regionLinesBits) | offset; }
+  [[nodiscard]] size_t pht_index(Addr_t key) const { return (key ^ (key >> 11)) & (pht.size() - 1); }
+
+  void end_generation(Generation& g);
+
+  void on_access(Addr_t line, Addr_t pc, bool miss, bool prefetch_hit, bool doStats, std::vector<Addr_t>& lines) override;
+  void on_evict(Addr_t line) override;
+};
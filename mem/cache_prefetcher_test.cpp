@@ -0,0 +1,109 @@
+// This file is distributed under the BSD 3-Clause License. See LICENSE for details.
+
+#include "cache_prefetcher.hpp"
+
+#include <fstream>
+#include <set>
+
+#include "config.hpp"
+#include "gtest/gtest.h"
+#include "memobj.hpp"
+
+class Cache_prefetcher_test : public ::testing::Test {
+protected:
+  void SetUp() override {
+    std::ofstream file;
+
+    file.open("cache_prefetcher_test.toml");
+    file << "[bop]\n";
+    file << "type = \"bop\"\n";
+    file << "degree = 1\n";
+    file << "max_offset = 64\n";
+    file << "score_max = 31\n";
+    file << "round_max = 100\n";
+    file << "bad_score = 1\n";
+    file << "rr_size = 256\n";
+    file << "page_size = 4096\n";
+    file << "[region]\n";
+    file << "type = \"region\"\n";
+    file << "degree = 16\n";
+    file << "region_size = 2048\n";
+    file << "agt_size = 4\n";
+    file << "pht_size = 256\n";
+    file.close();
+
+    Config::init("cache_prefetcher_test.toml");
+  }
+
+  // Tiny fully associative cache without replacement: prefetches fill at once
+  std::set<Addr_t> present;
+  std::set<Addr_t> prefetched;
+  int              nPrefetchHits = 0;
+
+  void access(Cache_prefetcher* pref, Addr_t addr, Addr_t pc) {
+    bool miss         = !present.contains(addr);
+    bool prefetch_hit = !miss && prefetched.contains(addr);
+    if (prefetch_hit) {
+      nPrefetchHits++;
+      prefetched.erase(addr);
+    }
+
+    std::vector<Addr_t> candidates;
+    pref->train(addr, pc, miss, prefetch_hit, true, candidates);
+
+    if (miss) {
+      present.insert(addr);
+      pref->fill(addr, false, true);
+    }
+    for (auto a : candidates) {
+      if (present.contains(a)) {
+        continue;
+      }
+      pref->issued(a, true);
+      present.insert(a);
+      prefetched.insert(a);
+      pref->fill(a, true, true);
+    }
+  }
+
+  void evict_all(Cache_prefetcher* pref) {
+    for (auto a : present) {
+      pref->evict(a, prefetched.contains(a), true);
+    }
+    present.clear();
+    prefetched.clear();
+  }
+};
+
+TEST_F(Cache_prefetcher_test, bop_learns_stride) {
+  auto pref = Cache_prefetcher::create("bop", "bop_test", 64);
+  ASSERT_NE(pref, nullptr);
+  EXPECT_EQ(pref->get_sign(), PSIGN_BOP);
+
+  // Stream with a 3 line stride over many pages
+  for (Addr_t i = 0; i < 20000; ++i) {
+    access(pref.get(), 0x100000 + i * 3 * 64, 0x400);
+  }
+
+  // Once the offset is learnt only the first access of each page misses
+  EXPECT_GT(nPrefetchHits, 15000);
+}
+
+TEST_F(Cache_prefetcher_test, region_replays_footprint) {
+  auto pref = Cache_prefetcher::create("region", "region_test", 64);
+  ASSERT_NE(pref, nullptr);
+  EXPECT_EQ(pref->get_sign(), PSIGN_REGION);
+
+  // Same sparse footprint (lines 0, 5, 9, 20) in many 2KB regions, same trigger PC
+  int nregions = 100;
+  for (Addr_t r = 0; r < static_cast<Addr_t>(nregions); ++r) {
+    Addr_t base = 0x800000 + r * 2048;
+    for (auto l : {0, 5, 9, 20}) {
+      access(pref.get(), base + l * 64, 0x500);
+    }
+    evict_all(pref.get());
+  }
+
+  // The first region trains the PHT, the others only miss on the trigger
+  EXPECT_EQ(nPrefetchHits, (nregions - 1) * 3);
+}
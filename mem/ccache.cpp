@@ -2,6 +2,7 @@
 
 #include "ccache.hpp"
 
+#include <algorithm>
 #include <climits>
 #include <cstdlib>
 #include <cstring>
@@ -38,6 +39,7 @@ CCache::CCache(Memory_system* gms, const std::string& sec, const std::string& n)
     , invNone(fmt::format("{}:invNone", n))
     , writeBack(fmt::format("{}:writeBack", n))
     , lineFill(fmt::format("{}:lineFill", n))
+    , nMSHRRetry(fmt::format("{}:nMSHRRetry", n))
     , avgMissLat(fmt::format("{}_avgMissLat", n))
     , avgMemLat(fmt::format("{}_avgMemLat", n))
     , avgHalfMemLat(fmt::format("{}_avgHalfMemLat", n))
@@ -56,6 +58,11 @@ CCache::CCache(Memory_system* gms, const std::string& sec, const std::string& n)
     , nPrefetchHitPending(fmt::format("{}:nPrefetchHitPending", n))
     , nPrefetchHitBusy(fmt::format("{}:nPrefetchHitBusy", n))
     , nPrefetchDropped(fmt::format("{}:nPrefetchDropped", n))
+    , nPrefetchQueued(fmt::format("{}:nPrefetchQueued", n))
+    , nPrefetchAgeDropped(fmt::format("{}:nPrefetchAgeDropped", n))
+    , prefetchAccuracy(fmt::format("{}_prefetchAccuracy", n))
+    , prefetchCoverage(fmt::format("{}_prefetchCoverage", n))
+    , issuePrefetchQueueCB(this)
     , cleanupCB(this)
     , port(sec, n) {
   s_reqHit[ma_setInvalid]   = new Stats_cntr(fmt::format("{}:setInvalidHit", name));
@@ -142,6 +149,16 @@ CCache::CCache(Memory_system* gms, const std::string& sec, const std::string& n)
 
   prefetch_degree = Config::get_integer(section, "prefetch_degree", 0, 32);
 
+  prefetchQueueSize      = Config::has_entry(section, "prefetch_queue") ? Config::get_integer(section, "prefetch_queue", 0, 1024) : 0;
+  prefetchQueueScheduled = false;
+
+  if (Config::has_entry(section, "prefetcher")) {
+    if (!allocateMiss || victim) {
+      Config::add_error(fmt::format("{} CCache prefetcher needs allocate_miss = true and victim = false", section));
+    }
+    cachePref = Cache_prefetcher::create(Config::get_string(section, "prefetcher"), name, lineSize);
+  }
+
   auto mega_lines1K  = Config::get_integer(section, "mega_lines1K", 0, 32);  // number of lines touched in 1K to trigger mega
   prefetch_megaratio = lineSize * mega_lines1K / 1024.0;
   if (prefetch_megaratio == 0 || prefetch_megaratio > 1) {
@@ -160,8 +177,8 @@ CCache::CCache(Memory_system* gms, const std::string& sec, const std::string& n)
     }
     uint32_t MaxRequests = Config::get_integer(section, "max_requests", 1, 8192);
 
-    mshr  = new MSHR(name, 128 * MaxRequests, lineSize2, MaxRequests);
-    pmshr = new MSHR(name + "sp", 128 * MaxRequests, lineSize2, MaxRequests);
+    mshr  = MSHR::create(section, name, lineSize2);
+    pmshr = new Hash_MSHR(name + "sp", 128 * MaxRequests, lineSize2, MaxRequests);
   }
 
   I(getLineSize() < 4096);  // To avoid bank selection conflict (insane CCache line)
@@ -233,6 +250,33 @@ void CCache::dropPrefetch(MemRequest* mreq) {
   }
 }
 
+void CCache::queuePrefetch(MemRequest* preq)
+/* an age tagged prefetch from this cache waits for an MSHR entry {{{1 */
+{
+  I(preq->isPrefetch() && preq->isHomeNode() && preq->getAge());
+
+  // Age order. With the queue full, the youngest is dropped: an older
+  // prefetch forces out a newer
+  nPrefetchQueued.inc(preq->has_stats());
+  auto it = std::upper_bound(prefetchQueue.begin(), prefetchQueue.end(), preq, [](const MemRequest* a, const MemRequest* b) {
+    return a->getAge() < b->getAge();
+  });
+  prefetchQueue.insert(it, preq);
+  if (!prefetchQueueScheduled) {
+    prefetchQueueScheduled = true;
+    issuePrefetchQueueCB.schedule(1);
+  }
+  if (prefetchQueue.size() <= prefetchQueueSize) {
+    return;
+  }
+
+  auto* youngest = prefetchQueue.back();
+  prefetchQueue.pop_back();
+  nPrefetchAgeDropped.inc(youngest != preq && youngest->has_stats());
+  dropPrefetch(youngest);
+}
+/* }}} */
+
 void CCache::displaceLine(Addr_t naddr, MemRequest* mreq, Line* l) {
   I(naddr != mreq->getAddr());  // naddr is the displace address, mreq is the trigger
   I(l->isValid());
@@ -312,6 +356,10 @@ CCache::Line* CCache::allocateLine(Addr_t addr, MemRequest* mreq) {
   if (l->isValid()) {
     if (l->isPrefetch() && !mreq->isPrefetch()) {
       nPrefetchWasteful.inc(mreq->has_stats());
+      prefetchAccuracy.sample(0, mreq->has_stats());
+    }
+    if (cachePref) {
+      cachePref->evict(rpl_addr, l->isPrefetch() && l->getSign() == cachePref->get_sign(), mreq->has_stats());
     }
 
     // TODO: add a port for evictions. Schedule the displaceLine accordingly
@@ -323,6 +371,9 @@ CCache::Line* CCache::allocateLine(Addr_t addr, MemRequest* mreq) {
   if (mreq->isPrefetch()) {
     nPrefetchLineFill.inc(mreq->has_stats());
   }
+  if (cachePref) {
+    cachePref->fill(addr, mreq->isPrefetch() && mreq->getSign() == cachePref->get_sign(), mreq->has_stats());
+  }
 
   if (prefetch_megaratio < 1) {
     static int conta = 0;
@@ -368,6 +419,9 @@ void CCache::mustForwardReqDown(MemRequest* mreq, bool miss) {
   if (!mreq->isPrefetch()) {
     s_reqMissLine[mreq->getAction()]->inc(miss && mreq->has_stats());
     s_reqMissState[mreq->getAction()]->inc(!miss && mreq->has_stats());
+    if (miss) {
+      prefetchCoverage.sample(0, mreq->has_stats());
+    }
   }
 
   if (mreq->getAction() == ma_setDirty) {
@@ -687,7 +741,16 @@ void CCache::doReq(MemRequest* mreq) {
     GI(!mreq->isPrefetch(), !mshr->canIssue(addr));  // the req is already queued if retrying
     I(!mreq->isPrefetch());
   } else {
-    if (!mshr->canIssue(addr)) {
+    bool write = MSHR::is_write(mreq);
+    if (!mreq->isPrefetch() && mshr->limits_targets() && !mshr->canIssue(addr, write) && !mshr->canAccept(addr, write)) {
+      nMSHRRetry.inc(mreq->has_stats());
+      MemRequest::redoReqCB::schedule(1, mreq, mreq->getPriority());  // no free MSHR target (mshr_targets)
+      return;
+    }
+    if (cachePref && !mreq->isPrefetch()) {
+      cachePref->demand(addr, mreq->has_stats());
+    }
+    if (!mshr->canIssue(addr, write)) {
       MTRACE("doReq queued");
 
       if (mreq->isPrefetch()) {
@@ -740,6 +803,10 @@ void CCache::doReq(MemRequest* mreq) {
     }
   }
 
+  if (cachePref && !retrying && !mreq->isPrefetch()) {
+    trainPrefetcher(mreq, l);
+  }
+
   if (l && mreq->isPrefetch() && mreq->isHomeNode()) {
     nPrefetchDropped.inc(mreq->has_stats());
     mreq->setDropped();  // useless prefetch, already a hit
@@ -757,6 +824,8 @@ void CCache::doReq(MemRequest* mreq) {
 
   if (l->isPrefetch() && !mreq->isPrefetch()) {
     nPrefetchUseful.inc(mreq->has_stats());
+    prefetchAccuracy.sample(1, mreq->has_stats());
+    prefetchCoverage.sample(1, mreq->has_stats());
     I(!victim);  // Victim should not have prefetch lines
   }
 
@@ -1180,12 +1249,18 @@ void CCache::disp(MemRequest* mreq) {
   port.disp(mreq);
 }
 
-void CCache::tryPrefetch(Addr_t paddr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb) {
+void CCache::tryPrefetch(Addr_t paddr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb, Time_t age) {
+  sendPrefetch(paddr, doStats, degree, pref_sign, pc, cb, age);
+}
+
+bool CCache::sendPrefetch(Addr_t paddr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb, Time_t age)
+/* returns true if the prefetch was sent from this cache {{{1 */
+{
   if ((paddr >> 8) == 0) {
     if (cb) {
       cb->destroy();
     }
-    return;
+    return false;
   }
 
   I(degree < 40);
@@ -1198,15 +1273,19 @@ void CCache::tryPrefetch(Addr_t paddr, bool doStats, int degree, Addr_t pref_sig
       // static_cast<IndirectAddressPredictor::performedCB *>(cb)->setParam1(this);
       cb->call();
     }
-    return;
+    return false;
   }
 
-  if (!mshr->canIssue(paddr)) {
+  // Age tagged prefetches wait for a free MSHR entry behind the older ones.
+  // Untagged ones do not use the queue and issue whenever the MSHR takes them
+  bool queue = prefetchQueueSize && age && (!mshr->hasFreeEntries() || !prefetchQueue.empty());
+
+  if (!queue && !mshr->canIssue(paddr)) {
     nPrefetchHitPending.inc(doStats);
     if (cb) {
       cb->destroy();
     }
-    return;
+    return false;
   }
 
   // jose_original_prefetch_working
@@ -1215,28 +1294,94 @@ void CCache::tryPrefetch(Addr_t paddr, bool doStats, int degree, Addr_t pref_sig
     Addr_t page_addr = (paddr >> 10) << 10;
     if (pref_sign != PSIGN_MEGA || page_addr != paddr) {
       nPrefetchHitBusy.inc(doStats);
-      router->tryPrefetch(paddr, doStats, degree, pref_sign, pc, cb);
-      return;
+      router->tryPrefetch(paddr, doStats, degree, pref_sign, pc, cb, age);
+      return false;
     }
   }
 
   if (port.isBusy(paddr) || degree > prefetch_degree || victim) {
     nPrefetchHitBusy.inc(doStats);
-    router->tryPrefetch(paddr, doStats, degree, pref_sign, pc, cb);
-    return;
+    router->tryPrefetch(paddr, doStats, degree, pref_sign, pc, cb, age);
+    return false;
   }
 
-  nSendPrefetch.inc(doStats);
   if (cb) {
     // I(pref_sign==PSIGN_STRIDE);
     // static_cast<IndirectAddressPredictor::performedCB *>(cb)->setParam1(this);
   }
-  MemRequest* preq = MemRequest::createReqReadPrefetch(this, doStats, paddr, pref_sign, degree, pc, cb);
+  MemRequest* preq = MemRequest::createReqReadPrefetch(this, doStats, paddr, pref_sign, degree, pc, cb, age);
   preq->trySetTopCoherentNode(this);
+
+  if (queue) {
+    queuePrefetch(preq);
+    return false;
+  }
+
+  issuePrefetch(preq);
+
+  return true;
+}
+/* }}} */
+
+void CCache::issuePrefetch(MemRequest* preq) {
+  nSendPrefetch.inc(preq->has_stats());
   port.startPrefetch(preq);
   router->scheduleReq(preq, 1);
-  mshr->blockEntry(paddr, preq);
+  mshr->blockEntry(preq->getAddr(), preq);
+}
+
+void CCache::issuePrefetchQueue()
+/* send the waiting prefetches, oldest first, while the MSHR has space {{{1 */
+{
+  prefetchQueueScheduled = false;
+
+  while (!prefetchQueue.empty() && mshr->hasFreeEntries()) {
+    auto* preq  = prefetchQueue.front();
+    auto  paddr = preq->getAddr();
+    if (port.isBusy(paddr)) {
+      break;
+    }
+    prefetchQueue.pop_front();
+
+    if (cacheBank->findLineNoEffect(paddr, paddr, 0xbaadbaad)) {
+      nPrefetchHitLine.inc(preq->has_stats());
+      preq->ack();  // the line arrived meanwhile
+    } else if (!mshr->canIssue(paddr)) {
+      nPrefetchHitPending.inc(preq->has_stats());
+      preq->setDropped();
+      preq->ack();
+    } else {
+      issuePrefetch(preq);
+    }
+  }
+
+  if (!prefetchQueue.empty()) {
+    prefetchQueueScheduled = true;
+    issuePrefetchQueueCB.schedule(1);
+  }
+}
+/* }}} */
+
+void CCache::trainPrefetcher(MemRequest* mreq, Line* l)
+/* demand access to the attached prefetcher, issue its candidates {{{1 */
+{
+  bool doStats      = mreq->has_stats();
+  bool prefetch_hit = l && l->isPrefetch() && l->getSign() == cachePref->get_sign();
+
+  prefCandidates.clear();
+  cachePref->train(mreq->getAddr(), mreq->getPC(), l == nullptr, prefetch_hit, doStats, prefCandidates);
+
+  for (auto paddr : prefCandidates) {
+    if (!mshr->hasFreeEntries() || port.isBusy(paddr)) {
+      cachePref->throttled(doStats);
+      return;  // leave room for demand misses
+    }
+    if (sendPrefetch(paddr, doStats, 0, cachePref->get_sign(), mreq->getPC(), nullptr, 0)) {
+      cachePref->issued(paddr, doStats);
+    }
+  }
 }
+/* }}} */
 
 bool CCache::isBusy(Addr_t addr) const {
   if (port.isBusy(addr)) {
@@ -2,9 +2,12 @@
 
 #pragma once
 
+#include <deque>
+#include <memory>
 #include <vector>
 
 #include "cache_port.hpp"
+#include "cache_prefetcher.hpp"
 #include "cachecore.hpp"
 #include "estl.hpp"
 #include "gprocessor.hpp"
@@ -151,6 +154,15 @@ protected:
   int32_t prefetch_degree;
   double  prefetch_megaratio;
 
+  std::unique_ptr<Cache_prefetcher> cachePref;  // optional prefetcher = "section"
+  std::vector<Addr_t>               prefCandidates;
+
+  // prefetch_queue: age tagged prefetches wait here (oldest first) while the
+  // MSHR is full, instead of being sent. Untagged prefetches bypass it
+  uint32_t                prefetchQueueSize;
+  std::deque<MemRequest*> prefetchQueue;
+  bool                    prefetchQueueScheduled;
+
   int32_t moving_conf;
 
   bool coreCoupledFreq;
@@ -176,6 +188,7 @@ protected:
   Stats_cntr writeBack;
 
   Stats_cntr lineFill;
+  Stats_cntr nMSHRRetry;  // request to a pending line with no free MSHR target
 
   Stats_avg avgMissLat;
   Stats_avg avgMemLat;
@@ -197,6 +210,10 @@ protected:
   Stats_cntr nPrefetchHitPending;
   Stats_cntr nPrefetchHitBusy;
   Stats_cntr nPrefetchDropped;
+  Stats_cntr nPrefetchQueued;
+  Stats_cntr nPrefetchAgeDropped;  // a younger prefetch dropped for an older one
+  Stats_avg  prefetchAccuracy;
+  Stats_avg  prefetchCoverage;
 
   Stats_cntr* s_reqHit[ma_MAX];
   Stats_cntr* s_reqMissLine[ma_MAX];
@@ -220,6 +237,12 @@ protected:
   bool notifyHigherLevels(Line* l, MemRequest* mreq);
 
   void dropPrefetch(MemRequest* mreq);
+  void queuePrefetch(MemRequest* preq);
+  bool sendPrefetch(Addr_t paddr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb, Time_t age);
+  void issuePrefetch(MemRequest* preq);
+  void issuePrefetchQueue();
+  StaticCallbackMember0<CCache, &CCache::issuePrefetchQueue> issuePrefetchQueueCB;
+  void trainPrefetcher(MemRequest* mreq, Line* l);
 
   void
   cleanup();  // FIXME: Expose this to MemObj and call it from core on ctx switch or syscall (move to public and remove callback)
@@ -240,7 +263,7 @@ public:
   void setStateAck(MemRequest* req);
   void disp(MemRequest* req);
 
-  void tryPrefetch(Addr_t paddr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb = 0);
+  void tryPrefetch(Addr_t paddr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb = 0, Time_t age = 0);
 
   // This do the real work
   void doReq(MemRequest* req);
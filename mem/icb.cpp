@@ -0,0 +1,171 @@
+// See LICENSE for details.
+
+#include "icb.hpp"
+
+#include "config.hpp"
+
+Icb::Icb(Memory_system* current, const std::string& sec, const std::string& n)
+    : MemObj(sec, n)
+    , lineSizeBits(log2i(Config::get_power2(sec, "line_size", 1, 8192)))
+    , size(Config::get_integer(sec, "size", 1, 1024))
+    , maxMisses(Config::get_integer(sec, "max_misses", 1, size))
+    , hitDelay(Config::get_integer(sec, "delay", 0, 1024))
+    , nHit(fmt::format("{}:nHit", n))
+    , nMerge(fmt::format("{}:nMerge", n))
+    , nMiss(fmt::format("{}:nMiss", n))
+    , nForward(fmt::format("{}:nForward", n))
+    , nDrop(fmt::format("{}:nDrop", n))
+    , nOverflowStall(fmt::format("{}:nOverflowStall", n)) {
+  nPending = 0;
+  entries.reserve(size);
+
+  I(current);
+  MemObj* lower_level = current->declareMemoryObj(section, "lower_level");
+  if (lower_level) {
+    addLowerLevel(lower_level);
+
+    const auto& lsec = lower_level->getSection();
+    if (Config::has_entry(lsec, "line_size") && Config::get_integer(lsec, "line_size") != (1 << lineSizeBits)) {
+      Config::add_error(fmt::format("section [{}] line_size should match the line_size of its lower_level [{}]", sec, lsec));
+    }
+  }
+}
+
+Icb::Entry* Icb::find(Addr_t line) {
+  for (auto& e : entries) {
+    if (e.line == line) {
+      return &e;
+    }
+  }
+  return nullptr;
+}
+
+void Icb::access(MemRequest* mreq, Entry* e) {
+  if (e) {
+    if (!e->filled) {
+      // Merges into the pending IL1 read, pays the miss latency
+      nMerge.inc(mreq->has_stats());
+      e->waiting.push_back(mreq);
+      return;
+    }
+
+    nHit.inc(mreq->has_stats());
+    if (hitDelay) {
+      mreq->ack(hitDelay);
+    } else {
+      mreq->ack();
+    }
+    return;
+  }
+
+  nMiss.inc(mreq->has_stats());
+
+  // Make space dropping the oldest line that no instruction retired
+  if (entries.size() >= size) {
+    auto it = entries.begin();
+    while (!it->filled) {
+      ++it;
+      I(it != entries.end());
+    }
+    nDrop.inc(mreq->has_stats());
+    entries.erase(it);
+  }
+
+  auto line = mreq->getAddr() >> lineSizeBits;
+  entries.emplace_back(Entry{line, false, {mreq}});
+  nPending++;
+
+  // The IL1 lookup has no effect until retireFetch
+  MemRequest* sreq = MemRequest::createSpecReqRead(this, mreq->has_stats(), line << lineSizeBits, mreq->getPC());
+  router->scheduleReq(sreq, 0);
+}
+
+void Icb::doReq(MemRequest* mreq) {
+  auto* e = find(mreq->getAddr() >> lineSizeBits);
+
+  // Misses keep the fetch order once one had to wait
+  if (e == nullptr && (nPending >= maxMisses || !stalled.empty())) {
+    nOverflowStall.inc(mreq->has_stats());
+    stalled.push_back(mreq);
+    return;
+  }
+
+  access(mreq, e);
+}
+
+void Icb::doReqAck(MemRequest* mreq) {
+  if (!mreq->isHomeNode()) {
+    router->scheduleReqAck(mreq, 0);
+    return;
+  }
+
+  auto* e = find(mreq->getAddr() >> lineSizeBits);
+  I(e && !e->filled);
+  I(nPending);
+  nPending--;
+
+  e->filled = true;
+  for (auto* w : e->waiting) {
+    w->ack();
+  }
+  e->waiting.clear();
+  mreq->ack();
+
+  while (!stalled.empty() && nPending < maxMisses) {
+    auto* s = stalled.front();
+    stalled.pop_front();
+    access(s, find(s->getAddr() >> lineSizeBits));
+  }
+}
+
+void Icb::retireFetch(Addr_t pc, bool doStats) {
+  auto line = pc >> lineSizeBits;
+  for (auto it = entries.begin(); it != entries.end(); ++it) {
+    if (it->line == line) {
+      if (it->filled) {
+        nForward.inc(doStats);
+        router->sendCleanDisp(line << lineSizeBits, false, doStats);
+        entries.erase(it);
+      }
+      return;
+    }
+  }
+}
+
+void Icb::doDisp(MemRequest* mreq) { router->scheduleDisp(mreq, 0); }
+
+void Icb::doSetState(MemRequest* mreq) {
+  // The lines not in flight are dropped, the pending ones finish as usual
+  auto line = mreq->getAddr() >> lineSizeBits;
+  for (auto it = entries.begin(); it != entries.end(); ++it) {
+    if (it->line == line && it->filled) {
+      entries.erase(it);
+      break;
+    }
+  }
+
+  if (router->isTopLevel()) {
+    mreq->convert2SetStateAck(ma_setInvalid, false);
+    router->scheduleSetStateAck(mreq, 1);
+    return;
+  }
+  router->sendSetStateAll(mreq, mreq->getAction(), 0);
+}
+
+void Icb::doSetStateAck(MemRequest* mreq) {
+  if (mreq->isHomeNode()) {
+    mreq->ack();
+    return;
+  }
+  router->scheduleSetStateAck(mreq, 0);
+}
+
+bool Icb::isBusy(Addr_t addr) const { return router->isBusyPos(0, addr); }
+
+void Icb::tryPrefetch(Addr_t addr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb, Time_t age) {
+  router->tryPrefetch(addr, doStats, degree, pref_sign, pc, cb, age);
+}
+
+TimeDelta_t Icb::ffread(Addr_t addr) { return router->ffread(addr); }
+
+TimeDelta_t Icb::ffwrite(Addr_t addr) { return router->ffwrite(addr); }
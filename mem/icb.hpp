@@ -0,0 +1,83 @@
+// See LICENSE for details.
+
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include "memobj.hpp"
+#include "memory_system.hpp"
+#include "memrequest.hpp"
+#include "stats.hpp"
+
+// Instruction Cache Buffer. Sits between the fetch engine and the IL1 (il1 =
+// "icb_section NAME" in the core, with lower_level pointing to the IL1) and
+// keeps transient fetches from changing the IL1:
+//
+// -A fetch to a line not in the buffer allocates an entry and reads the IL1
+//  with a speculative request, which does not allocate nor update the LRU in
+//  a victim = true cache.
+//
+// -The line stays in the buffer until a non-transient instruction of the line
+//  reaches pre-retire (retireFetch). Then it is displaced to the IL1, which
+//  allocates it or updates its LRU, and the entry is freed.
+//
+// -Lines never retired (transient paths) are dropped, oldest first, when the
+//  buffer needs space.
+//
+// -Fetches wait in the buffer while max_misses reads to the IL1 are pending.
+class Icb : public MemObj {
+protected:
+  class Entry {
+  public:
+    Addr_t                   line;
+    bool                     filled;
+    std::vector<MemRequest*> waiting;  // fetches to the line while it is read
+  };
+
+  const uint32_t    lineSizeBits;
+  const uint32_t    size;
+  const uint32_t    maxMisses;
+  const TimeDelta_t hitDelay;
+
+  std::vector<Entry>      entries;  // allocation order
+  std::deque<MemRequest*> stalled;  // fetches waiting for a free miss slot
+  uint32_t                nPending;
+
+  Stats_cntr nHit;
+  Stats_cntr nMerge;
+  Stats_cntr nMiss;
+  Stats_cntr nForward;
+  Stats_cntr nDrop;
+  Stats_cntr nOverflowStall;
+
+  Entry* find(Addr_t line);
+  void   access(MemRequest* mreq, Entry* e);
+
+public:
+  Icb(Memory_system* current, const std::string& device_descr_section, const std::string& device_name = "");
+  ~Icb() {}
+
+  // Entry points to schedule that may schedule a do?? if needed
+  void req(MemRequest* req) { doReq(req); };
+  void reqAck(MemRequest* req) { doReqAck(req); };
+  void setState(MemRequest* req) { doSetState(req); };
+  void setStateAck(MemRequest* req) { doSetStateAck(req); };
+  void disp(MemRequest* req) { doDisp(req); }
+
+  // This do the real work
+  void doReq(MemRequest* r);
+  void doReqAck(MemRequest* req);
+  void doSetState(MemRequest* req);
+  void doSetStateAck(MemRequest* req);
+  void doDisp(MemRequest* req);
+
+  TimeDelta_t ffread(Addr_t addr);
+  TimeDelta_t ffwrite(Addr_t addr);
+
+  void tryPrefetch(Addr_t addr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb = 0, Time_t age = 0);
+
+  bool isBusy(Addr_t addr) const;
+
+  void retireFetch(Addr_t pc, bool doStats);
+};
@@ -0,0 +1,214 @@
+// See LICENSE for details.
+
+#include <fstream>
+
+#include "callback.hpp"
+#include "config.hpp"
+#include "dinst.hpp"
+#include "gtest/gtest.h"
+#include "memobj.hpp"
+#include "memory_system.hpp"
+#include "memrequest.hpp"
+#include "report.hpp"
+
+static int rd_pending = 0;
+
+static void rdDone(Dinst* dinst) {
+  rd_pending--;
+  dinst->scrap();
+}
+
+using rdDoneCB = CallbackFunction1<Dinst*, &rdDone>;
+
+static void doread(MemObj* mobj, Addr_t addr) {
+  auto* ld = Dinst::create(Instruction(Opcode::iLALU_LD, RegType::LREG_R1, RegType::LREG_R2, RegType::LREG_R3, RegType::LREG_R4),
+                           addr,
+                           addr,
+                           0,
+                           true);
+
+  while (mobj->isBusy(addr)) {
+    EventScheduler::advanceClock();
+  }
+
+  MemRequest::sendReqRead(mobj, ld->has_stats(), ld->getAddr(), ld->getPC(), rdDoneCB::create(ld, ld->getID()));
+  rd_pending++;
+}
+
+static void wait_reads() {
+  while (rd_pending) {
+    EventScheduler::advanceClock();
+  }
+}
+
+static void setup_config() {
+  std::ofstream file;
+
+  file.open("icb_test.toml");
+
+  file << "[soc]\n"
+          "core = [\"c0\"]\n"
+          "[c0]\n"
+          "type  = \"ooo\"\n"
+          "caches        = true\n"
+          "dl1           = \"l1_cache DL1\"\n"
+          "il1           = \"icb ICB\"\n"
+          "[icb]\n"
+          "type        = \"icb\"\n"
+          "size        = 2\n"
+          "max_misses  = 1\n"
+          "delay       = 1\n"
+          "line_size   = 64\n"
+          "lower_level = \"il1_cache IL1\"\n"
+          "[l1_cache]\n"
+          "type       = \"cache\"\n"
+          "cold_misses = true\n"
+          "size       = 32768\n"
+          "line_size  = 64\n"
+          "delay      = 2\n"
+          "miss_delay = 2\n"
+          "assoc      = 4\n"
+          "repl_policy = \"lru\"\n"
+          "port_occ   = 1\n"
+          "port_num   = 1\n"
+          "port_banks = 32\n"
+          "send_port_occ = 1\n"
+          "send_port_num = 1\n"
+          "max_requests  = 32\n"
+          "allocate_miss = true\n"
+          "victim        = false\n"
+          "coherent      = true\n"
+          "inclusive     = true\n"
+          "directory     = false\n"
+          "nlp_distance = 2\n"
+          "nlp_degree   = 0\n"
+          "nlp_stride   = 1\n"
+          "drop_prefetch = true\n"
+          "prefetch_degree = 0\n"
+          "mega_lines1K    = 0\n"
+          "lower_level = \"l2_cache L2\"\n"
+          "[il1_cache]\n"
+          "type       = \"cache\"\n"
+          "cold_misses = true\n"
+          "size       = 32768\n"
+          "line_size  = 64\n"
+          "delay      = 2\n"
+          "miss_delay = 2\n"
+          "assoc      = 4\n"
+          "repl_policy = \"lru\"\n"
+          "port_occ   = 1\n"
+          "port_num   = 1\n"
+          "port_banks = 32\n"
+          "send_port_occ = 1\n"
+          "send_port_num = 1\n"
+          "max_requests  = 32\n"
+          "allocate_miss = true\n"
+          "victim        = true\n"
+          "coherent      = true\n"
+          "inclusive     = true\n"
+          "directory     = false\n"
+          "nlp_distance = 2\n"
+          "nlp_degree   = 0\n"
+          "nlp_stride   = 1\n"
+          "drop_prefetch = true\n"
+          "prefetch_degree = 0\n"
+          "mega_lines1K    = 0\n"
+          "lower_level = \"l2_cache L2\"\n"
+          "[l2_cache]\n"
+          "type       = \"nice\"\n"
+          "line_size  = 64\n"
+          "delay      = 11\n"
+          "cold_misses = false\n"
+          "lower_level = \"\"\n";
+
+  file.close();
+}
+
+class Icb_test : public ::testing::Test {
+protected:
+  static inline MemObj* icb = nullptr;
+
+  static void SetUpTestSuite() {
+    setup_config();
+
+    Report::init();
+    Config::init("icb_test.toml");
+
+    auto* gms = new Memory_system(0);
+    Config::exit_on_error();
+    EventScheduler::advanceClock();
+
+    icb = gms->getIL1();
+  }
+
+  static double cntr(const std::string& name) { return Stats::get_cntr(name); }
+};
+
+// The tests share the buffer (size 2, max_misses 1) and run in order
+TEST_F(Icb_test, allocate_and_hit) {
+  ASSERT_EQ(icb->get_type(), "icb");
+
+  doread(icb, 0x1000);
+  wait_reads();
+  EXPECT_EQ(cntr("ICB(0):nMiss"), 1);
+  EXPECT_EQ(cntr("ICB(0):nHit"), 0);
+
+  doread(icb, 0x1010);  // same line, filled
+  wait_reads();
+  EXPECT_EQ(cntr("ICB(0):nMiss"), 1);
+  EXPECT_EQ(cntr("ICB(0):nHit"), 1);
+}
+
+TEST_F(Icb_test, merge_into_pending_line) {
+  auto hit = cntr("ICB(0):nHit");
+
+  doread(icb, 0x2000);
+  doread(icb, 0x2010);  // same line, still read from the IL1
+  wait_reads();
+
+  EXPECT_EQ(cntr("ICB(0):nMiss"), 2);
+  EXPECT_EQ(cntr("ICB(0):nMerge"), 1);
+  EXPECT_EQ(cntr("ICB(0):nHit"), hit);
+}
+
+TEST_F(Icb_test, forward_at_retire) {
+  // Buffer: 0x1000, 0x2000
+  icb->retireFetch(0x1020, true);
+  EXPECT_EQ(cntr("ICB(0):nForward"), 1);
+
+  icb->retireFetch(0x1020, true);  // no longer in the buffer
+  EXPECT_EQ(cntr("ICB(0):nForward"), 1);
+
+  // The entry is free, no line has to be dropped
+  doread(icb, 0x3000);
+  wait_reads();
+  EXPECT_EQ(cntr("ICB(0):nMiss"), 3);
+  EXPECT_EQ(cntr("ICB(0):nDrop"), 0);
+}
+
+TEST_F(Icb_test, drop_unretired) {
+  // Buffer: 0x2000, 0x3000. The oldest never retired line makes space
+  doread(icb, 0x4000);
+  wait_reads();
+  EXPECT_EQ(cntr("ICB(0):nDrop"), 1);
+
+  icb->retireFetch(0x2000, true);  // dropped, nothing to forward
+  EXPECT_EQ(cntr("ICB(0):nForward"), 1);
+
+  doread(icb, 0x3000);  // still buffered
+  wait_reads();
+  EXPECT_EQ(cntr("ICB(0):nMiss"), 4);
+}
+
+TEST_F(Icb_test, max_misses_stall) {
+  auto miss = cntr("ICB(0):nMiss");
+
+  doread(icb, 0x5000);
+  doread(icb, 0x6000);  // waits for the single miss slot
+  EXPECT_EQ(cntr("ICB(0):nOverflowStall"), 1);
+  EXPECT_EQ(rd_pending, 2);
+
+  wait_reads();
+  EXPECT_EQ(cntr("ICB(0):nMiss"), miss + 2);
+  EXPECT_EQ(cntr("ICB(0):nOverflowStall"), 1);
+}
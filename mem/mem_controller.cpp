@@ -2,10 +2,8 @@
 
 #include "mem_controller.hpp"
 
+#include <algorithm>
 #include <cmath>
-#include <iostream>
-#include <queue>
-#include <vector>
 
 #include "config.hpp"
 #include "memory_system.hpp"
@@ -14,263 +12,404 @@ MemController::MemController(Memory_system* current, const std::string& sec, con
     /* constructor {{{1 */
     : MemObj(sec, n)
     , delay(Config::get_integer(sec, "delay", 1, 1024))
-    , PreChargeLatency(Config::get_integer(sec, "PreChargeLatency", 1, 1024))
-    , RowAccessLatency(Config::get_integer(sec, "RowAccessLatency", 1, 1024))
-    , ColumnAccessLatency(Config::get_integer(sec, "ColumnAccessLatency", 4, 1024))
+    , numChannels(Config::get_power2(sec, "num_channels", 1, 64))
+    , numRanks(Config::get_power2(sec, "num_ranks", 1, 16))
+    , numBanks(Config::get_power2(sec, "num_banks", 1, 64))
+    , queueSize(Config::get_integer(sec, "queue_size", 1, 1024))
+    , starvationCap(Config::get_integer(sec, "starvation_cap", 1, 1000000))
+    , nRead(fmt::format("{}:nRead", n))
+    , nWrite(fmt::format("{}:nWrite", n))
+    , rowHit(fmt::format("{}:rowHit", n))
+    , rowEmpty(fmt::format("{}:rowEmpty", n))
+    , rowConflict(fmt::format("{}:rowConflict", n))
+    , nActivate(fmt::format("{}:nActivate", n))
     , nPrecharge(fmt::format("{}:nPrecharge", n))
-    , nColumnAccess(fmt::format("{}:nColumnAccess", n))
-    , nRowAccess(fmt::format("{}:nRowAccess", n))
-    , avgMemLat(fmt::format("{}_avgMemLat", n))
-    , readHit(fmt::format("{}:readHit", n))
-    , memRequestBufferSize(Config::get_integer(sec, "memRequestBufferSize", 1, 1024)) {
-  MemObj* lower_level = NULL;
-
-  NumUnits_t num = Config::get_integer(section, "port_num");
-
-  cmdPort = PortGeneric::create(name + "_cmd", num);
-
-  numBanks                = Config::get_power2(section, "NumBanks");
-  unsigned int numRows    = Config::get_power2(section, "NumRows");
-  unsigned int ColumnSize = Config::get_power2(section, "ColumnSize");
-  unsigned int numColumns = Config::get_power2(section, "NumColumns");
-
-  columnOffset = log2(ColumnSize);
-  columnMask   = numColumns - 1;
-  columnMask   = columnMask << columnOffset;  // FIXME: Use Addr_t
-
-  rowOffset = columnOffset + log2(numColumns);
-  rowMask   = numRows - 1;
-  rowMask   = rowMask << rowOffset;  // FIXME: use Addr_t
-
-  bankOffset = rowOffset + log2(numRows);
-  bankMask   = numBanks - 1;
-  bankMask   = bankMask << bankOffset;
-
-  bankState.resize(numBanks);
-  for (uint32_t curBank = 0; curBank < numBanks; curBank++) {
-    bankState[curBank].activeRow = 0;
-    bankState[curBank].state     = INIT;  // Changed from ACTIVE (LNB)
-    bankState[curBank].bankTime  = 0;     // added (LNB)
+    , nRefresh(fmt::format("{}:nRefresh", n))
+    , nStarved(fmt::format("{}:nStarved", n))
+    , nBytes(fmt::format("{}:nBytes", n))
+    , avgMemLat(fmt::format("{}_avgMemLat", n)) {
+  // globalClock runs at the fastest core frequency
+  double max_mhz = 0;
+  for (auto i = 0u; i < Config::get_array_size("soc", "core"); ++i) {
+    max_mhz = std::max<double>(max_mhz, Config::get_integer("soc", "core", i, "frequency_mhz", 1, 32000));
   }
+  auto   dram_mhz = Config::get_integer(sec, "frequency_mhz", 100, 10000);
+  double ratio    = max_mhz / dram_mhz;
+
+  auto to_core = [&](const std::string& param, int max) -> TimeDelta_t {
+    auto v = Config::get_integer(sec, param, 0, max);
+    return static_cast<TimeDelta_t>(std::ceil(v * ratio));
+  };
+  tCAS   = to_core("tCAS", 256);
+  tRCD   = to_core("tRCD", 256);
+  tRP    = to_core("tRP", 256);
+  tRAS   = to_core("tRAS", 512);
+  tFAW   = to_core("tFAW", 512);
+  tRRD   = to_core("tRRD", 256);
+  tWR    = to_core("tWR", 256);
+  tBURST = std::max<TimeDelta_t>(to_core("tBURST", 64), 1);
+  tREFI  = to_core("tREFI", 1000000);
+  tRFC   = to_core("tRFC", 10000);
+  if (tREFI && tREFI <= tRFC) {
+    Config::add_error(fmt::format("section {} tREFI should be larger than tRFC (or 0 to disable refresh)", sec));
+  }
+
+  auto line_size = Config::get_power2(sec, "line_size", 16, 4096);
+  auto row_size  = Config::get_power2(sec, "row_size", 256, 65536);
+  if (row_size < line_size) {
+    Config::add_error(fmt::format("section {} row_size {} smaller than line_size {}", sec, row_size, line_size));
+    row_size = line_size;
+  }
+
+  // Address map (low to high): line offset, channel, column, bank, rank, row
+  lineSizeBits = log2i(line_size);
+  channelBits  = log2i(numChannels);
+  columnBits   = log2i(row_size / line_size);
+  bankBits     = log2i(numBanks);
+  rankBits     = log2i(numRanks);
+
+  channels.resize(numChannels);
+  for (auto& ch : channels) {
+    ch.bus_free  = 0;
+    ch.scheduled = false;
+    ch.nqueued   = 0;
+  }
+
+  ranks.resize(numChannels * numRanks);
+  for (auto i = 0u; i < ranks.size(); ++i) {
+    // Stagger the ranks so that they do not refresh at the same time
+    ranks[i].next_refresh = tREFI ? tREFI + (tREFI * i) / ranks.size() : 0;
+    ranks[i].act_hist.fill(0);
+    ranks[i].act_pos = 0;
+  }
+
+  banks.resize(numChannels * numRanks * numBanks);
+  for (auto i = 0u; i < banks.size(); ++i) {
+    auto& b     = banks[i];
+    b.open      = false;
+    b.open_row  = 0;
+    b.act_ready = 0;
+    b.col_ready = 0;
+    b.pre_ready = 0;
+
+    auto ch     = i / (numRanks * numBanks);
+    auto rk     = (i / numBanks) % numRanks;
+    auto bk     = i % numBanks;
+    auto prefix = fmt::format("{}_ch{}_rank{}_bank{}", n, ch, rk, bk);
+    b.occupancy  = std::make_unique<Stats_avg>(fmt::format("{}:occupancy", prefix));
+    b.rowHitRate = std::make_unique<Stats_avg>(fmt::format("{}:rowHitRate", prefix));
+  }
+
   I(current);
-  lower_level = current->declareMemoryObj(section, "lower_level");
+  MemObj* lower_level = current->declareMemoryObj(section, "lower_level");
   if (lower_level) {
     addLowerLevel(lower_level);
   }
 }
 /* }}} */
 
+uint32_t MemController::getChannel(Addr_t addr) const { return (addr >> lineSizeBits) & (numChannels - 1); }
+
+uint32_t MemController::getBank(Addr_t addr) const {
+  auto a    = addr >> (lineSizeBits + channelBits + columnBits);
+  auto bank = a & (numBanks - 1);
+  auto rank = (a >> bankBits) & (numRanks - 1);
+
+  return (getChannel(addr) * numRanks + rank) * numBanks + bank;
+}
+
+uint64_t MemController::getRow(Addr_t addr) const {
+  return addr >> (lineSizeBits + channelBits + columnBits + bankBits + rankBits);
+}
+
 void MemController::doReq(MemRequest* mreq)
 /* request reaches the memory controller {{{1 */
 {
-  readHit.inc(mreq->has_stats());
+  nRead.inc(mreq->has_stats());
   addMemRequest(mreq);
 }
 /* }}} */
 
 void MemController::doReqAck([[maybe_unused]] MemRequest* mreq) { I(0); }
 
-void MemController::doDisp(MemRequest* mreq) { addMemRequest(mreq); }
+void MemController::doDisp(MemRequest* mreq)
+/* write back reaches the memory controller {{{1 */
+{
+  nWrite.inc(mreq->has_stats());
+  addMemRequest(mreq);
+}
+/* }}} */
 
 void MemController::doSetState([[maybe_unused]] MemRequest* mreq) { I(0); }
 
 void MemController::doSetStateAck([[maybe_unused]] MemRequest* mreq) {}
 
-bool MemController::isBusy(Addr_t addr) const {
-  (void)addr;
-  return false;
-}
+bool MemController::isBusy(Addr_t addr) const { return !channels[getChannel(addr)].overflow.empty(); }
 
-void MemController::tryPrefetch(Addr_t addr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb) {
+void MemController::tryPrefetch(Addr_t addr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb, Time_t age) {
   (void)addr;
   (void)doStats;
   (void)degree;
   (void)pref_sign;
   (void)pc;
+  (void)age;
   if (cb) {
     cb->destroy();
   }
   // FIXME:
 }
 
-TimeDelta_t MemController::ffread(Addr_t addr) {
-  (void)addr;
-  return delay + RowAccessLatency;
-}
+TimeDelta_t MemController::ffaccess(Addr_t addr)
+/* warmup access: tracks the open rows, no queuing {{{1 */
+{
+  auto& b   = banks[getBank(addr)];
+  auto  row = getRow(addr);
+
+  TimeDelta_t lat = delay + tCAS + tBURST;
+  if (!b.open) {
+    lat += tRCD;
+  } else if (b.open_row != row) {
+    lat += tRP + tRCD;
+  }
+  b.open     = true;
+  b.open_row = row;
 
-TimeDelta_t MemController::ffwrite(Addr_t addr) {
-  (void)addr;
-  return delay + RowAccessLatency;
+  return lat;
 }
+/* }}} */
 
-void MemController::addMemRequest(MemRequest* mreq) {
-  I(0);  // really, a new?? FIXME:
-  FCFSField* newEntry = new FCFSField;
+TimeDelta_t MemController::ffread(Addr_t addr) { return ffaccess(addr); }
 
-  newEntry->Bank        = getBank(mreq);
-  newEntry->Row         = getRow(mreq);
-  newEntry->Column      = getColumn(mreq);
-  newEntry->mreq        = mreq;
-  newEntry->TimeEntered = globalClock;
+TimeDelta_t MemController::ffwrite(Addr_t addr) { return ffaccess(addr); }
 
-  OverflowMemoryRequests.push(newEntry);
+void MemController::addMemRequest(MemRequest* mreq)
+/* queue the request in its bank (or the channel overflow) {{{1 */
+{
+  Bank_req* breq = reqPool.out();
+  breq->mreq     = mreq;
+  breq->entered  = globalClock;
+  breq->row      = getRow(mreq->getAddr());
+  breq->bank     = getBank(mreq->getAddr());
+
+  auto  ch_id = getChannel(mreq->getAddr());
+  auto& ch    = channels[ch_id];
+  if (ch.nqueued >= queueSize) {
+    ch.overflow.push_back(breq);
+    return;
+  }
+
+  auto& b = banks[breq->bank];
+  b.occupancy->sample(b.queue.size(), mreq->has_stats());
+  b.queue.push_back(breq);
+  ch.nqueued++;
 
-  manageRam();
+  if (!ch.scheduled) {
+    ch.scheduled = true;
+    ManageChannelCB::schedule(1, this, ch_id);
+  }
 }
+/* }}} */
 
-// This function implements the FR-FCFS memory scheduling algorithm
-void MemController::manageRam(void) {
-  // First, we need to determine if any actions (precharging, activating, or accessing) have been completed
-  for (uint32_t curBank = 0; curBank < numBanks; curBank++) {
-    if ((bankState[curBank].state == PRECHARGE) && (globalClock - bankState[curBank].bankTime >= PreChargeLatency)) {
-      bankState[curBank].state = IDLE;
+void MemController::refresh(uint32_t rank, Time_t when)
+/* lazy all-bank refresh: close the rows and block ACT for tRFC {{{1 */
+{
+  auto& r = ranks[rank];
+  if (tREFI == 0) {
+    return;
+  }
 
-    } else if ((bankState[curBank].state == ACTIVATING) && (globalClock - bankState[curBank].bankTime >= RowAccessLatency)) {
-      bankState[curBank].state = ACTIVE;
+  while (when >= r.next_refresh) {
+    auto start = r.next_refresh;
+    for (auto i = rank * numBanks; i < (rank + 1) * numBanks; ++i) {
+      auto& b     = banks[i];
+      b.open      = false;
+      b.act_ready = std::max(b.act_ready, std::max(start, b.pre_ready) + tRP + tRFC);
+    }
+    r.next_refresh += tREFI;
+    nRefresh.inc();
+  }
+}
+/* }}} */
 
-    } else if ((bankState[curBank].state == ACCESSING) && (globalClock - bankState[curBank].bankTime >= ColumnAccessLatency)) {
-      bankState[curBank].state = ACTIVE;
+void MemController::issue(uint32_t ch_id, Bank_req* breq, Time_t* first_cmd)
+/* commit the DRAM commands for breq, and schedule its completion {{{1 */
+{
+  auto& ch       = channels[ch_id];
+  auto& b        = banks[breq->bank];
+  auto  rank     = getRank(breq->bank);
+  auto& r        = ranks[rank];
+  bool  doStats  = breq->mreq->has_stats();
+  bool  is_write = breq->mreq->isDisp();
+
+  Time_t col;
+  if (b.open && b.open_row == breq->row) {
+    col        = std::max<Time_t>(globalClock, b.col_ready);
+    *first_cmd = col;
+    rowHit.inc(doStats);
+    b.rowHitRate->sample(1, doStats);
+  } else {
+    Time_t act;
+    if (b.open) {
+      auto pre   = std::max<Time_t>(globalClock, b.pre_ready);
+      act        = std::max<Time_t>(pre + tRP, b.act_ready);
+      *first_cmd = pre;
+      nPrecharge.inc(doStats);
+      rowConflict.inc(doStats);
+    } else {
+      act        = std::max<Time_t>(globalClock, b.act_ready);
+      *first_cmd = act;
+      rowEmpty.inc(doStats);
+    }
+    // tRRD from the last ACT in the rank, tFAW from the 4th last one
+    auto last_act = r.act_hist[(r.act_pos + 3) % 4];
+    act           = std::max<Time_t>(act, last_act + tRRD);
+    act           = std::max<Time_t>(act, r.act_hist[r.act_pos] + tFAW);
+
+    r.act_hist[r.act_pos] = act;
+    r.act_pos             = (r.act_pos + 1) % 4;
+
+    b.open      = true;
+    b.open_row  = breq->row;
+    b.col_ready = act + tRCD;
+    b.pre_ready = act + tRAS;
+    col         = b.col_ready;
+    nActivate.inc(doStats);
+    b.rowHitRate->sample(0, doStats);
+  }
 
-      for (FCFSList::iterator it = curMemRequests.begin(); it != curMemRequests.end(); it++) {
-        FCFSField* tempMem = *it;
+  auto data_start = std::max<Time_t>(col + tCAS, ch.bus_free);
+  auto done       = data_start + tBURST;
+  ch.bus_free     = done;
+  b.col_ready     = std::max<Time_t>(b.col_ready, col + tBURST);
+  if (is_write) {
+    b.pre_ready = std::max<Time_t>(b.pre_ready, done + tWR);
+  }
 
-        // If current memory request has completed, finish processing the request by sending the proper ACK
-        if ((curBank == tempMem->Bank) && (bankState[curBank].activeRow == tempMem->Row)) {
-          I(tempMem->mreq);
+  nBytes.add(1 << lineSizeBits, doStats);
+
+  MemRequest* mreq = breq->mreq;
+  TimeDelta_t lat  = done - globalClock + delay;
+  if (is_write) {
+    mreq->ack(lat);
+  } else {
+    avgMemLat.sample(done + delay - breq->entered, doStats);
+    if (mreq->getAction() == ma_setValid || mreq->getAction() == ma_setExclusive) {
+      mreq->convert2ReqAck(ma_setExclusive);
+    } else {
+      mreq->convert2ReqAck(ma_setDirty);
+    }
+    router->scheduleReqAck(mreq, lat);
+  }
 
-          if (tempMem->mreq->isDisp()) {
-            tempMem->mreq->ack();  // Fixed doDisp Acknowledge -- LNB 5/28/2014
-          } else {
-            MemRequest* mreq = tempMem->mreq;
-            I(mreq->isReq());
+  reqPool.in(breq);
+}
+/* }}} */
 
-            if (mreq->getAction() == ma_setValid || mreq->getAction() == ma_setExclusive) {
-              mreq->convert2ReqAck(ma_setExclusive);
-            } else {
-              mreq->convert2ReqAck(ma_setDirty);
-            }
+void MemController::manageChannel(uint32_t ch_id)
+/* FR-FCFS: pick one request per decision {{{1 */
+{
+  auto& ch     = channels[ch_id];
+  ch.scheduled = false;
 
-            Time_t delta = globalClock - tempMem->TimeEntered;
+  auto bank_start = ch_id * numRanks * numBanks;
+  auto bank_end   = bank_start + numRanks * numBanks;
 
-            router->scheduleReqAck(mreq, 1);  //  Fixed doReq acknowledge -- LNB 5/28/2014
-            avgMemLat.sample(delta, mreq->has_stats());
-          }
-#ifndef NDEBUG
-          tempMem->mreq = 0;
-#endif
+  for (auto rk = ch_id * numRanks; rk < (ch_id + 1) * numRanks; ++rk) {
+    refresh(rk, globalClock);
+  }
 
-          curMemRequests.erase(it);
+  // Per bank candidate: oldest if starving, else oldest row hit, else oldest.
+  // Across banks: starving first, then the candidates whose next command can
+  // issue now (row hits before the rest), then the earliest ready one. Ties
+  // go to the oldest request.
+  Bank_req* best          = nullptr;
+  uint32_t  best_pos      = 0;
+  int       best_priority = -1;
+  Time_t    best_ready    = 0;
+  for (auto i = bank_start; i < bank_end; ++i) {
+    auto& b = banks[i];
+    if (b.queue.empty()) {
+      continue;
+    }
 
+    uint32_t pos      = 0;
+    bool     hit      = false;
+    bool     starving = globalClock - b.queue.front()->entered >= starvationCap;
+    if (!starving && b.open) {
+      for (auto j = 0u; j < b.queue.size(); ++j) {
+        if (b.queue[j]->row == b.open_row) {
+          pos = j;
+          hit = true;
           break;
         }
       }
     }
-  }
-
-  // Call function to replace any deleted address with a new one from queue
-  transferOverflowMemory();
-  // Call function to determine what the next action should begin
-  scheduleNextAction();
-}
-
-// This function adds any pending references in the queue to the buffer if there is space available
-void MemController::transferOverflowMemory(void) {
-  while ((curMemRequests.size() <= memRequestBufferSize) && (!OverflowMemoryRequests.empty())) {
-    curMemRequests.push_back(OverflowMemoryRequests.front());
-    OverflowMemoryRequests.pop();
-  }
-}
-
-// This function determines what action can be performed next and schedules a callback for when that action completes
-void MemController::scheduleNextAction(void) {
-  uint32_t oldestReadyColsBank = numBanks + 1;
-  uint32_t oldestReadyRowsBank = numBanks + 1;
-  uint32_t oldestReadyRow      = 0;
-  uint32_t oldestbank          = 0;
-
-  bool oldestColumnFound = false;
-  bool oldestRowFound    = false;
-  bool oldestBankFound   = false;
-
-  // Go through memory references in buffer to determine what actions are ready to begin
-  for (uint32_t curReference = 0; curReference < curMemRequests.size(); curReference++) {
-    auto curBank = curMemRequests[curReference]->Bank;
-    auto curRow  = curMemRequests[curReference]->Row;
-    if (!oldestColumnFound) {
-      if ((bankState[curBank].state == ACTIVE) && (bankState[curBank].activeRow == curRow)) {
-        bankState[curBank].cpend = true;
-        oldestColumnFound        = true;
-        //   if(bankState[oldestReadyColsBank].bankTime > bankState[curBank].bankTime){
-        oldestReadyColsBank = curBank;
-        //   }
-      }
+    hit = hit || (b.open && b.queue.front()->row == b.open_row);
+
+    Time_t ready;
+    if (hit) {
+      ready = b.col_ready;
+    } else if (b.open) {
+      ready = b.pre_ready;
+    } else {
+      ready = b.act_ready;
     }
-    if ((bankState[curBank].state == ACTIVE) && (bankState[curBank].activeRow != curRow)) {
-      bankState[curBank].bpend = true;
+    ready = std::max<Time_t>(ready, globalClock);
+
+    int priority;  // 3 starving, 2 ready hit, 1 ready, 0 not ready
+    if (starving) {
+      priority = 3;
+    } else if (ready == globalClock) {
+      priority = hit ? 2 : 1;
+    } else {
+      priority = 0;
     }
-    if (!oldestRowFound) {
-      if (bankState[curBank].state == IDLE) {
-        oldestRowFound = true;
-        //    if(bankState[oldestReadyRowsBank].bankTime > bankState[curBank].bankTime){
-        oldestReadyRow      = curMemRequests[curReference]->Row;
-        oldestReadyRowsBank = curBank;
-        //    }
-      }
+
+    auto* cand = b.queue[pos];
+    bool  better;
+    if (priority != best_priority) {
+      better = priority > best_priority;
+    } else if (priority == 0 && ready != best_ready) {
+      better = ready < best_ready;
+    } else {
+      better = cand->entered < best->entered;
     }
-    if (bankState[curBank].state == INIT) {
-      oldestBankFound = true;
-      oldestbank      = curBank;
+    if (better) {
+      best          = cand;
+      best_pos      = pos;
+      best_priority = priority;
+      best_ready    = ready;
     }
   }
 
-  //... and determine if a bank has no pending column references
-  for (uint32_t curBank = 0; curBank < numBanks; curBank++) {
-    if ((bankState[curBank].bpend) && (!bankState[curBank].cpend)) {
-      oldestBankFound = true;
-      if (bankState[oldestbank].bankTime > bankState[curBank].bankTime) {
-        oldestbank = curBank;
-      }
-    }
-    bankState[curBank].bpend = false;
-    bankState[curBank].cpend = false;
+  if (best == nullptr) {
+    return;
   }
-
-  // Now determine which of the ready actions should be start and when the callback should occur
-  if (oldestBankFound) {
-    bankState[oldestbank].state    = PRECHARGE;
-    bankState[oldestbank].bankTime = globalClock;
-
-    nPrecharge.inc();
-
-    ManageRamCB::schedule(PreChargeLatency, this);
-  } else if (oldestColumnFound) {
-    bankState[oldestReadyColsBank].state    = ACCESSING;
-    bankState[oldestReadyColsBank].bankTime = globalClock;
-
-    nColumnAccess.inc();
-
-    ManageRamCB::schedule(ColumnAccessLatency, this);
-  } else if (oldestRowFound) {
-    bankState[oldestReadyRowsBank].state     = ACTIVATING;
-    bankState[oldestReadyRowsBank].bankTime  = globalClock;
-    bankState[oldestReadyRowsBank].activeRow = oldestReadyRow;
-
-    nRowAccess.inc();
-
-    ManageRamCB::schedule(RowAccessLatency, this);
+  if (best_priority == 3) {
+    nStarved.inc(best->mreq->has_stats());
   }
-}
 
-uint32_t MemController::getBank(MemRequest* mreq) const {
-  uint32_t bank = (mreq->getAddr() & bankMask) >> bankOffset;
-  return bank;
-}
-uint32_t MemController::getRow(MemRequest* mreq) const {
-  uint32_t row = (mreq->getAddr() & rowMask) >> rowOffset;
-  return row;
-}
+  auto& q = banks[best->bank].queue;
+  q.erase(q.begin() + best_pos);
+  ch.nqueued--;
+
+  Time_t first_cmd;
+  issue(ch_id, best, &first_cmd);
+
+  // Refill from the overflow
+  while (ch.nqueued < queueSize && !ch.overflow.empty()) {
+    auto* breq = ch.overflow.front();
+    ch.overflow.pop_front();
+    auto& b = banks[breq->bank];
+    b.occupancy->sample(b.queue.size(), breq->mreq->has_stats());
+    b.queue.push_back(breq);
+    ch.nqueued++;
+  }
 
-uint32_t MemController::getColumn(MemRequest* mreq) const {
-  uint32_t column = (mreq->getAddr() & columnMask) >> columnOffset;
-  return column;
+  // Next decision once this command is on the command bus
+  if (ch.nqueued) {
+    ch.scheduled = true;
+    ManageChannelCB::scheduleAbs(std::max<Time_t>(first_cmd, globalClock) + 1, this, ch_id);
+  }
 }
+/* }}} */
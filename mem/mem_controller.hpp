@@ -2,73 +2,115 @@
 
 #pragma once
 
-#include <queue>
+#include <array>
+#include <deque>
+#include <memory>
 #include <vector>
 
-#include "cachecore.hpp"
 #include "callback.hpp"
 #include "config.hpp"
 #include "memory_system.hpp"
 #include "memrequest.hpp"
-#include "port.hpp"
+#include "pool.hpp"
 #include "snippets.hpp"
 #include "stats.hpp"
 
+// DRAM controller with channels, ranks and banks. Each channel runs an
+// FR-FCFS scheduler over per bank queues: row buffer hits first, then the
+// oldest request, unless the oldest request waited more than starvation_cap
+// cycles. Timing (tCAS, tRCD, tRP, tRAS, tFAW, tRRD, tWR, tBURST, tREFI,
+// tRFC) is given in DRAM cycles and converted to core cycles.
 class MemController : public MemObj {
 protected:
-  class FCFSField {
+  class Bank_req {
   public:
-    uint32_t    Bank;
-    uint32_t    Row;
-    uint32_t    Column;
-    Time_t      TimeEntered;
     MemRequest* mreq;
+    Time_t      entered;
+    uint64_t    row;
+    uint32_t    bank;  // global bank id
   };
-  TimeDelta_t delay;
-  TimeDelta_t PreChargeLatency;
-  TimeDelta_t RowAccessLatency;
-  TimeDelta_t ColumnAccessLatency;
+  static inline pool<Bank_req> reqPool{1024, "MemController::Bank_req"};
 
-  Stats_cntr nPrecharge;
-  Stats_cntr nColumnAccess;
-  Stats_cntr nRowAccess;
-  Stats_avg  avgMemLat;
-  Stats_cntr readHit;
-
-  enum STATE {
-    IDLE = 0,
-    ACTIVATING,
-    PRECHARGE,
-    ACTIVE,
-    ACCESSING,
-    INIT  // Added LNB 5/31/2014
+  class Bank {
+  public:
+    std::deque<Bank_req*> queue;
+
+    bool     open;
+    uint64_t open_row;
+    Time_t   act_ready;  // earliest ACT (after PRE + tRP, or refresh)
+    Time_t   col_ready;  // earliest RD/WR (after ACT + tRCD)
+    Time_t   pre_ready;  // earliest PRE (after ACT + tRAS, and write recovery)
+
+    std::unique_ptr<Stats_avg> occupancy;
+    std::unique_ptr<Stats_avg> rowHitRate;
+  };
+
+  class Rank {
+  public:
+    Time_t                next_refresh;
+    std::array<Time_t, 4> act_hist;  // last 4 ACT, for tFAW
+    uint32_t              act_pos;
   };
-  std::shared_ptr<PortGeneric> cmdPort;
-
-  uint32_t rowMask;
-  uint32_t columnMask;
-  uint32_t bankMask;
-  uint32_t rowOffset;
-  uint32_t columnOffset;
-  uint32_t bankOffset;
-  uint32_t numBanks;
-  uint32_t memRequestBufferSize;
-
-  class BankStatus {
+
+  class Channel {
   public:
-    int      state;
-    uint32_t activeRow;
-    bool     bpend;
-    bool     cpend;
-    Time_t   bankTime;
+    Time_t                bus_free;  // data bus available
+    bool                  scheduled;
+    size_t                nqueued;
+    std::deque<Bank_req*> overflow;
   };
 
-  std::vector<BankStatus> bankState;
+  const TimeDelta_t delay;  // controller + interconnect, each way
+  const uint32_t    numChannels;
+  const uint32_t    numRanks;
+  const uint32_t    numBanks;
+  const size_t      queueSize;  // per channel
+  const TimeDelta_t starvationCap;
+
+  // In core cycles
+  TimeDelta_t tCAS;
+  TimeDelta_t tRCD;
+  TimeDelta_t tRP;
+  TimeDelta_t tRAS;
+  TimeDelta_t tFAW;
+  TimeDelta_t tRRD;
+  TimeDelta_t tWR;
+  TimeDelta_t tBURST;
+  TimeDelta_t tREFI;
+  TimeDelta_t tRFC;
+
+  uint32_t lineSizeBits;
+  uint32_t channelBits;
+  uint32_t columnBits;
+  uint32_t bankBits;
+  uint32_t rankBits;
+
+  std::vector<Channel> channels;
+  std::vector<Rank>    ranks;
+  std::vector<Bank>    banks;
+
+  Stats_cntr nRead;
+  Stats_cntr nWrite;
+  Stats_cntr rowHit;
+  Stats_cntr rowEmpty;
+  Stats_cntr rowConflict;
+  Stats_cntr nActivate;
+  Stats_cntr nPrecharge;
+  Stats_cntr nRefresh;
+  Stats_cntr nStarved;
+  Stats_cntr nBytes;
+  Stats_avg  avgMemLat;
+
+  [[nodiscard]] uint32_t getChannel(Addr_t addr) const;
+  [[nodiscard]] uint32_t getBank(Addr_t addr) const;  // global bank id
+  [[nodiscard]] uint64_t getRow(Addr_t addr) const;
+  [[nodiscard]] uint32_t getRank(uint32_t bank) const { return bank / numBanks; }
 
-  using FCFSList = std::vector<FCFSField*>;
-  FCFSList curMemRequests;
-  using FCFSQueue = std::queue<FCFSField*>;
-  FCFSQueue OverflowMemoryRequests;
+  void addMemRequest(MemRequest* mreq);
+  void refresh(uint32_t rank, Time_t when);
+  void issue(uint32_t ch, Bank_req* breq, Time_t* first_cmd);
+
+  TimeDelta_t ffaccess(Addr_t addr);
 
 public:
   MemController(Memory_system* current, const std::string& device_descr_section, const std::string& device_name = "");
@@ -88,29 +130,14 @@ public:
   void doSetStateAck(MemRequest* req);
   void doDisp(MemRequest* req);
 
-  void tryPrefetch(Addr_t addr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb = nullptr);
+  void tryPrefetch(Addr_t addr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb = nullptr, Time_t age = 0);
 
   [[nodiscard]] TimeDelta_t ffread(Addr_t addr);
   [[nodiscard]] TimeDelta_t ffwrite(Addr_t addr);
 
   [[nodiscard]] bool isBusy(Addr_t addr) const;
 
-  [[nodiscard]] uint16_t getLineSize() const;
-
-  void manageRam(void);
-
-  using ManageRamCB = CallbackMember0<MemController, &MemController::manageRam>;
-  // typedef CallbackMember0<MemController, &MemController::manageRam>   ManageRamCB;  // Added by LNB 5/27/2014
-
-  // TimeDelta_t ffread(Addr_t addr, DataType data);
-  // TimeDelta_t ffwrite(Addr_t addr, DataType data);
-  // void        ffinvalidate(Addr_t addr, int32_t lineSize);
-private:
-  uint32_t getBank(MemRequest* mreq) const;
-  uint32_t getRow(MemRequest* mreq) const;
-  uint32_t getColumn(MemRequest* mreq) const;
-  void     addMemRequest(MemRequest* mreq);
+  void manageChannel(uint32_t ch);
 
-  void transferOverflowMemory(void);
-  void scheduleNextAction(void);
+  using ManageChannelCB = CallbackMember1<MemController, uint32_t, &MemController::manageChannel>;
 };
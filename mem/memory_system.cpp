@@ -9,9 +9,14 @@
 #include "ccache.hpp"
 #include "config.hpp"
 #include "drawarch.hpp"
+#include "icb.hpp"
 #include "mem_controller.hpp"
 #include "memxbar.hpp"
 #include "nice_cache.hpp"
+#include "noc.hpp"
+#include "page_walker.hpp"
+#include "stack_profiler.hpp"
+#include "tlb.hpp"
 #include "unmemxbar.hpp"
 
 extern DrawArch arch;
@@ -36,12 +41,27 @@ MemObj* Memory_system::buildMemoryObj(const std::string& device_type, const std:
   } else if (device_type == "bus") {
     mdev    = new Bus(this, dev_section, dev_name);
     devtype = 2;
+  } else if (device_type == "tlb") {
+    mdev    = new Tlb(this, dev_section, dev_name);
+    devtype = 3;
+  } else if (device_type == "walker") {
+    mdev    = new Page_walker(this, dev_section, dev_name);
+    devtype = 3;
   } else if (device_type == "memxbar") {
     mdev    = new MemXBar(this, dev_section, dev_name);
     devtype = 4;
   } else if (device_type == "memcontroller") {
     mdev    = new MemController(this, dev_section, dev_name);
     devtype = 5;
+  } else if (device_type == "stackdist") {
+    mdev    = new Stack_profiler(this, dev_section, dev_name);
+    devtype = 6;
+  } else if (device_type == "noc") {
+    mdev    = new Noc(this, dev_section, dev_name);
+    devtype = 7;
+  } else if (device_type == "icb") {
+    mdev    = new Icb(this, dev_section, dev_name);
+    devtype = 8;
   } else {
     Config::add_error(fmt::format("unknown memory type:{} from section:{}", device_type, dev_section));
     return nullptr;
@@ -58,7 +78,7 @@ MemObj* Memory_system::buildMemoryObj(const std::string& device_type, const std:
     case 2:  // bus
       mystr += "\"[shape=record,sides=5,peripheries=1,color=lightpink,style=filled]";
       break;
-    case 3:  // tlb
+    case 3:  // Tlb, Page_walker
       mystr += "\"[shape=record,sides=5,peripheries=1,color=lavender,style=filled]";
       break;
     case 4:  // MemXBar
@@ -67,6 +87,15 @@ MemObj* Memory_system::buildMemoryObj(const std::string& device_type, const std:
     case 5:  // void
       mystr += "\"[shape=record,sides=5,peripheries=1,color=skyblue,style=filled]";
       break;
+    case 6:  // Stack_profiler
+      mystr += "\"[shape=record,sides=5,peripheries=1,color=khaki,style=filled]";
+      break;
+    case 7:  // Noc
+      mystr += "\"[shape=record,sides=5,peripheries=1,color=plum,style=filled]";
+      break;
+    case 8:  // Icb
+      mystr += "\"[shape=record,sides=5,peripheries=1,color=wheat,style=filled]";
+      break;
     default: mystr += "\"[shape=record,sides=5,peripheries=3,color=white,style=filled]"; break;
   }
   arch.addObj(mystr);
@@ -122,11 +122,11 @@ bool MemXBar::isBusy(Addr_t addr) const
 }
 /* }}} */
 
-void MemXBar::tryPrefetch(Addr_t addr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb)
+void MemXBar::tryPrefetch(Addr_t addr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb, Time_t age)
 /* fast forward reads {{{1 */
 {
   uint32_t pos = addrHash(addr);
-  router->tryPrefetchPos(pos, addr, degree, doStats, pref_sign, pc, cb);
+  router->tryPrefetchPos(pos, addr, degree, doStats, pref_sign, pc, cb, age);
 }
 /* }}} */
 
@@ -36,7 +36,7 @@ public:
   void doSetStateAck(MemRequest* req);
   void doDisp(MemRequest* req);
 
-  void tryPrefetch(Addr_t addr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb = nullptr);
+  void tryPrefetch(Addr_t addr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb = nullptr, Time_t age = 0);
 
   [[nodiscard]] TimeDelta_t ffread(Addr_t addr);
   [[nodiscard]] TimeDelta_t ffwrite(Addr_t addr);
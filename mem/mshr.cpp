@@ -8,9 +8,33 @@
 #include "memrequest.hpp"
 #include "snippets.hpp"
 
-MSHR::MSHR(const std::string& n, int32_t size, int16_t lineSize, int16_t nsub)
-    : name(n)
-    , Log2LineSize(log2i(lineSize))
+MSHR::MSHR(const std::string& n, int16_t lineSize) : name(n), Log2LineSize(log2i(lineSize)) {
+  I(lineSize >= 0 && Log2LineSize < (8 * sizeof(Addr_t) - 1));
+}
+
+MSHR* MSHR::create(const std::string& section, const std::string& name, int16_t lineSize) {
+  int32_t maxRequests = Config::get_integer(section, "max_requests", 1, 8192);
+
+  std::string type = "hash";
+  if (Config::has_entry(section, "mshr_type")) {
+    type = Config::get_string(section, "mshr_type", {"hash", "line"});
+  }
+
+  if (type == "line") {
+    return new Line_MSHR(name,
+                         Config::get_integer(section, "mshr_read_entries", 1, 8192),
+                         Config::get_integer(section, "mshr_write_entries", 1, 8192),
+                         Config::get_integer(section, "mshr_targets", 1, 1024),
+                         lineSize);
+  }
+
+  return new Hash_MSHR(name, 128 * maxRequests, lineSize, maxRequests);
+}
+
+/* Hash_MSHR {{{1 */
+
+Hash_MSHR::Hash_MSHR(const std::string& n, int32_t size, int16_t lineSize, int16_t nsub)
+    : MSHR(n, lineSize)
     , nEntries(size)
     , nSubEntries(nsub)
     , avgUse(fmt::format("{}_MSHR_avgUse", n))
@@ -22,8 +46,6 @@ MSHR::MSHR(const std::string& n, int32_t size, int16_t lineSize, int16_t nsub)
 
   nFreeEntries = size;
 
-  I(lineSize >= 0 && Log2LineSize < (8 * sizeof(Addr_t) - 1));
-
   entry.resize(MSHRSize);
 
   for (int32_t i = 0; i < MSHRSize; i++) {
@@ -32,7 +54,7 @@ MSHR::MSHR(const std::string& n, int32_t size, int16_t lineSize, int16_t nsub)
   }
 }
 
-bool MSHR::canAccept(Addr_t addr) const {
+bool Hash_MSHR::canAccept(Addr_t addr, [[maybe_unused]] bool write) const {
   if (nFreeEntries <= 0) {
     return false;
   }
@@ -45,7 +67,7 @@ bool MSHR::canAccept(Addr_t addr) const {
   return true;
 }
 
-bool MSHR::canIssue(Addr_t addr) const {
+bool Hash_MSHR::canIssue(Addr_t addr, [[maybe_unused]] bool write) const {
   uint32_t pos = calcEntry(addr);
   if (entry[pos].nUse) {
     return false;
@@ -56,7 +78,7 @@ bool MSHR::canIssue(Addr_t addr) const {
   return true;
 }
 
-void MSHR::addEntry(Addr_t addr, CallbackBase* c, MemRequest* mreq) {
+void Hash_MSHR::addEntry(Addr_t addr, CallbackBase* c, MemRequest* mreq) {
   I(mreq->isRetrying());
   I(nFreeEntries <= nEntries);
   nFreeEntries--;  // it can go negative because invalidate and writeback requests
@@ -82,7 +104,7 @@ void MSHR::addEntry(Addr_t addr, CallbackBase* c, MemRequest* mreq) {
 #endif
 }
 
-void MSHR::blockEntry(Addr_t addr, MemRequest* mreq) {
+void Hash_MSHR::blockEntry(Addr_t addr, MemRequest* mreq) {
   I(!mreq->isRetrying());
   I(nFreeEntries <= nEntries);
   nFreeEntries--;  // it can go negative because invalidate and writeback requests
@@ -102,7 +124,7 @@ void MSHR::blockEntry(Addr_t addr, MemRequest* mreq) {
 #endif
 }
 
-bool MSHR::retire(Addr_t addr, MemRequest* mreq) {
+bool Hash_MSHR::retire(Addr_t addr, MemRequest* mreq) {
   I(mreq);
   uint32_t pos = calcEntry(addr);
   I(entry[pos].nUse);
@@ -144,7 +166,7 @@ bool MSHR::retire(Addr_t addr, MemRequest* mreq) {
   return false;
 }
 
-void MSHR::dump() const {
+void Hash_MSHR::dump() const {
   fmt::print("MSHR[{}]", name);
   for (int i = 0; i < MSHRSize; i++) {
     if (entry[i].nUse) {
@@ -155,3 +177,142 @@ void MSHR::dump() const {
   }
   fmt::print("\n");
 }
+
+/* }}} */
+
+bool MSHR::is_write(const MemRequest* mreq) { return mreq->getAction() == ma_setDirty || mreq->getAction() == ma_setExclusive; }
+
+/* Line_MSHR {{{1 */
+
+Line_MSHR::Line_MSHR(const std::string& n, int32_t nRead, int32_t nWrite, int32_t targets, int16_t lineSize)
+    : MSHR(n, lineSize)
+    , nTargets(targets)
+    , readPool(fmt::format("{}_MSHR_readOccupancy", n), nRead)
+    , writePool(fmt::format("{}_MSHR_writeOccupancy", n), nWrite)
+    , nPrimary(fmt::format("{}_MSHR:nPrimary", n))
+    , nSecondary(fmt::format("{}_MSHR:nSecondary", n))
+    , nStallFull(fmt::format("{}_MSHR:nStallFull", n))
+    , histMerged(fmt::format("{}_MSHR_merged", n)) {
+  entries.reserve(nRead + nWrite);
+}
+
+void Line_MSHR::allocate(Addr_t line, bool write, bool doStats) {
+  I(!entries.contains(line));
+
+  auto& e   = entries[line];
+  e.nUse    = 1;
+  e.nMerged = 0;
+  e.write   = write;
+
+  auto& pool = get_pool(write);
+  pool.nUsed++;
+  pool.occupancy.sample(pool.nUsed, doStats);
+  nPrimary.inc(doStats);
+}
+
+bool Line_MSHR::canAccept(Addr_t addr, [[maybe_unused]] bool write) const {
+  auto it = entries.find(calcLineAddr(addr));
+  if (it != entries.end()) {
+    return it->second.nUse < nTargets;
+  }
+  return true;  // issues, or waits for a free entry of its pool
+}
+
+bool Line_MSHR::canIssue(Addr_t addr, bool write) const {
+  if (entries.contains(calcLineAddr(addr))) {
+    return false;
+  }
+  const auto& pool = get_pool(write);
+  return pool.nUsed < pool.size;
+}
+
+void Line_MSHR::addEntry(Addr_t addr, CallbackBase* c, MemRequest* mreq) {
+  I(mreq->isRetrying());
+  I(c);
+
+  auto line = calcLineAddr(addr);
+  auto it   = entries.find(line);
+  if (it != entries.end()) {
+    auto& e = it->second;
+    I(e.nUse < nTargets);  // canAccept
+    e.nUse++;
+    e.nMerged++;
+    e.targets.push_back(c);
+
+    nSecondary.inc(mreq->has_stats());
+    return;
+  }
+
+  auto& pool = get_pool(is_write(mreq));
+  I(pool.nUsed >= pool.size);
+  nStallFull.inc(mreq->has_stats());
+  pool.waiting.push_back(Waiting{line, c});
+}
+
+void Line_MSHR::blockEntry(Addr_t addr, MemRequest* mreq) {
+  I(!mreq->isRetrying());
+
+  allocate(calcLineAddr(addr), is_write(mreq), mreq->has_stats());
+}
+
+bool Line_MSHR::retire(Addr_t addr, MemRequest* mreq) {
+  I(mreq);
+
+  auto it = entries.find(calcLineAddr(addr));
+  I(it != entries.end());
+  auto& e = it->second;
+
+  I(e.nUse > 0);
+  e.nUse--;
+
+  if (!e.targets.empty()) {
+    auto* cb = e.targets.front();
+    e.targets.pop_front();
+    cb->call();
+    return true;
+  }
+  I(e.nUse == 0);
+
+  histMerged.sample(e.nMerged, mreq->has_stats());
+
+  bool  write = e.write;
+  auto& pool  = get_pool(write);
+  entries.erase(it);
+  pool.nUsed--;
+
+  // Wake the oldest miss waiting for this pool. Waiters for a line that got
+  // an entry in the meantime become its secondary targets, or keep waiting
+  // while the entry has no free target
+  auto wit = pool.waiting.begin();
+  while (wit != pool.waiting.end()) {
+    auto w   = *wit;
+    auto it2 = entries.find(w.line);
+    if (it2 == entries.end()) {
+      pool.waiting.erase(wit);
+      allocate(w.line, write, mreq->has_stats());
+      w.cb->call();
+      return true;
+    }
+
+    if (it2->second.nUse >= nTargets) {
+      ++wit;
+      continue;
+    }
+    it2->second.nUse++;
+    it2->second.nMerged++;
+    it2->second.targets.push_back(w.cb);
+    wit = pool.waiting.erase(wit);
+  }
+
+  return false;
+}
+
+void Line_MSHR::dump() const {
+  fmt::print("MSHR[{}] read {}/{} write {}/{}", name, readPool.nUsed, readPool.size, writePool.nUsed, writePool.size);
+  for (const auto& [line, e] : entries) {
+    fmt::print(" [{:#x}].nUse={}", line << Log2LineSize, e.nUse);
+  }
+  fmt::print("\n");
+}
+
+/* }}} */
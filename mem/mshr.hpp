@@ -2,8 +2,10 @@
 
 #pragma once
 
+#include <deque>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "callback.hpp"
 #include "dinst.hpp"
 #include "estl.hpp"
@@ -14,21 +16,55 @@
 
 class MemRequest;
 
+// Miss status holding registers of a cache. A request that can not issue
+// (canIssue false) is queued with addEntry and called back after a retire of
+// the same line. With limits_targets, the cache only queues it if canAccept
+// allows it (else it retries it later); otherwise queueing never fails.
+// Requests that issue call blockEntry, and every request (issued or queued)
+// calls retire once when done.
+//
+// mshr_type in the cache section selects the implementation: "hash" (default)
+// or "line".
 class MSHR {
-private:
 protected:
   const std::string name;
   const uint32_t    Log2LineSize;
-  const int32_t     nEntries;
-  const int32_t     nSubEntries;
+
+  Addr_t calcLineAddr(Addr_t addr) const { return addr >> Log2LineSize; }
+
+  MSHR(const std::string& name, int16_t lineSize);
+
+public:
+  virtual ~MSHR() {}
+
+  static MSHR* create(const std::string& section, const std::string& name, int16_t lineSize);
+  static bool  is_write(const MemRequest* mreq);
+
+  virtual bool hasFreeEntries(bool write = false) const = 0;
+  virtual bool limits_targets() const { return false; }
+
+  virtual bool canAccept(Addr_t paddr, bool write = false) const        = 0;
+  virtual bool canIssue(Addr_t addr, bool write = false) const          = 0;
+  virtual void addEntry(Addr_t addr, CallbackBase* c, MemRequest* mreq) = 0;
+  virtual void blockEntry(Addr_t addr, MemRequest* mreq)                = 0;
+  virtual bool retire(Addr_t addr, MemRequest* mreq)                    = 0;
+  virtual void dump() const                                             = 0;
+};
+
+// Hashed table of entries. Different lines can alias into the same entry
+// (nStallConflict), and the entries are not a limit (size is sized for
+// max_requests).
+class Hash_MSHR : public MSHR {
+private:
+protected:
+  const int32_t nEntries;
+  const int32_t nSubEntries;
 
   int32_t nFreeEntries;
 
   Stats_avg avgUse;
   Stats_avg avgSubUse;
 
-  Addr_t calcLineAddr(Addr_t addr) const { return addr >> Log2LineSize; }
-
   Stats_cntr nStallConflict;
 
   const int32_t MSHRSize;
@@ -58,12 +94,73 @@ protected:
   std::vector<EntryType> entry;
 
 public:
-  MSHR(const std::string& name, int32_t size, int16_t lineSize, int16_t nSubEntries);
-  virtual ~MSHR() {}
-  bool hasFreeEntries() const { return (nFreeEntries > 0); }
+  Hash_MSHR(const std::string& name, int32_t size, int16_t lineSize, int16_t nSubEntries);
+  bool hasFreeEntries([[maybe_unused]] bool write = false) const { return (nFreeEntries > 0); }
+
+  bool canAccept(Addr_t paddr, bool write = false) const;
+  bool canIssue(Addr_t addr, bool write = false) const;
+  void addEntry(Addr_t addr, CallbackBase* c, MemRequest* mreq);
+  void blockEntry(Addr_t addr, MemRequest* mreq);
+  bool retire(Addr_t addr, MemRequest* mreq);
+  void dump() const;
+};
+
+// Fully associative MSHR with exact line match and separate pools for read
+// and write misses (mshr_read_entries, mshr_write_entries). The first miss to
+// a line is the primary target; later requests to the line are secondary
+// targets of the same entry, served in order as the previous one retires. An
+// entry holds up to mshr_targets targets (canAccept false with all of them in
+// use, the cache retries the request). A miss to a new line with its pool
+// full waits for a free entry of the pool (nStallFull).
+class Line_MSHR : public MSHR {
+protected:
+  class Entry {
+  public:
+    std::deque<CallbackBase*> targets;  // queued secondary requests
+    int32_t                   nUse;     // primary + secondary not retired
+    int32_t                   nMerged;  // secondary targets so far
+    bool                      write;
+  };
+  class Waiting {
+  public:
+    Addr_t        line;
+    CallbackBase* cb;
+  };
+  class Pool {
+  public:
+    Pool(const std::string& stats_name, int32_t _size) : size(_size), nUsed(0), occupancy(stats_name) {}
+
+    const int32_t       size;
+    int32_t             nUsed;
+    std::deque<Waiting> waiting;  // misses to new lines while the pool is full
+    Stats_hist          occupancy;
+  };
+
+  const int32_t nTargets;
+
+  absl::flat_hash_map<Addr_t, Entry> entries;  // by line address
+
+  Pool readPool;
+  Pool writePool;
+
+  Stats_cntr nPrimary;
+  Stats_cntr nSecondary;
+  Stats_cntr nStallFull;
+  Stats_hist histMerged;  // secondary targets per entry
+
+  [[nodiscard]] Pool& get_pool(bool write) { return write ? writePool : readPool; }
+  [[nodiscard]] const Pool& get_pool(bool write) const { return write ? writePool : readPool; }
+
+  void allocate(Addr_t line, bool write, bool doStats);
+
+public:
+  Line_MSHR(const std::string& name, int32_t nRead, int32_t nWrite, int32_t targets, int16_t lineSize);
+
+  bool hasFreeEntries(bool write = false) const { return get_pool(write).nUsed < get_pool(write).size; }
+  bool limits_targets() const { return true; }
 
-  bool canAccept(Addr_t paddr) const;
-  bool canIssue(Addr_t addr) const;
+  bool canAccept(Addr_t paddr, bool write = false) const;
+  bool canIssue(Addr_t addr, bool write = false) const;
   void addEntry(Addr_t addr, CallbackBase* c, MemRequest* mreq);
   void blockEntry(Addr_t addr, MemRequest* mreq);
   bool retire(Addr_t addr, MemRequest* mreq);
@@ -1,16 +1,155 @@
 // This file is distributed under the BSD 3-Clause License. See LICENSE for details.
 
+#include "mshr.hpp"
+
+#include <fstream>
+#include <vector>
+
 #include "config.hpp"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "memobj.hpp"
+#include "memrequest.hpp"
+#include "report.hpp"
+
+// Keeps the requests sent to it, so that the test drives the MSHR by hand
+class Capture_obj : public DummyMemObj {
+public:
+  Capture_obj() : DummyMemObj("mshr_obj", "mshr_obj") {}
+
+  std::vector<MemRequest*> reqs;
+
+  void req(MemRequest* mreq) override { reqs.push_back(mreq); }
+};
+
+static int nWake = 0;
+static void wake() { nWake++; }
+using wakeCB = CallbackFunction0<&wake>;
 
 class MSHR_test : public ::testing::Test {
 protected:
-  void SetUp() override {}
+  static inline Capture_obj* obj = nullptr;
 
-  void TearDown() override {
-    // Graph_library::sync_all();
+  static void SetUpTestSuite() {
+    std::ofstream file("mshr_test.toml");
+    file << "[mshr_obj]\n"
+            "type        = \"void\"\n"
+            "lower_level = \"\"\n";
+    file.close();
+
+    Report::init();
+    Config::init("mshr_test.toml");
+    obj = new Capture_obj();
+  }
+
+  void SetUp() override { nWake = 0; }
+
+  static MemRequest* read(Addr_t addr) {
+    MemRequest::sendReqRead(obj, true, addr, 0x100);
+    return obj->reqs.back();
+  }
+  static MemRequest* write(Addr_t addr) {
+    MemRequest::sendReqWrite(obj, true, addr, 0x200);
+    return obj->reqs.back();
+  }
+
+  // What CCache::doReq does with a request that can not issue
+  static void queue(MSHR& mshr, MemRequest* mreq) {
+    mreq->setRetrying();
+    mshr.addEntry(mreq->getAddr(), wakeCB::create(), mreq);
   }
 };
 
-TEST_F(MSHR_test, trivial) { EXPECT_EQ(true, true); }
+TEST_F(MSHR_test, line_target_limit) {
+  Line_MSHR mshr("line_targets", 4, 2, 2, 64);
+
+  auto* r1 = read(0x1000);
+  ASSERT_TRUE(mshr.canIssue(0x1000));
+  mshr.blockEntry(0x1000, r1);
+
+  // Same line: secondary target while there are free targets
+  auto* r2 = read(0x1010);
+  EXPECT_FALSE(mshr.canIssue(0x1010));
+  EXPECT_TRUE(mshr.canAccept(0x1010));
+  queue(mshr, r2);
+
+  // Primary plus one secondary use the 2 targets
+  EXPECT_FALSE(mshr.canAccept(0x1020));
+  EXPECT_TRUE(mshr.canAccept(0x2000));  // other lines are not affected
+
+  // The primary retires, the secondary is served and a target frees
+  EXPECT_TRUE(mshr.retire(0x1000, r1));
+  EXPECT_EQ(nWake, 1);
+  EXPECT_TRUE(mshr.canAccept(0x1020));
+
+  EXPECT_FALSE(mshr.retire(0x1010, r2));
+  EXPECT_TRUE(mshr.canIssue(0x1000));
+}
+
+TEST_F(MSHR_test, line_read_write_pools) {
+  Line_MSHR mshr("line_pools", 2, 1, 4, 64);
+
+  auto* r1 = read(0x1000);
+  auto* r2 = read(0x2000);
+  mshr.blockEntry(0x1000, r1);
+  mshr.blockEntry(0x2000, r2);
+
+  // Read pool full, the write pool is independent
+  EXPECT_FALSE(mshr.hasFreeEntries());
+  EXPECT_TRUE(mshr.hasFreeEntries(true));
+  EXPECT_FALSE(mshr.canIssue(0x3000, false));
+  EXPECT_TRUE(mshr.canIssue(0x3000, true));
+
+  auto* w1 = write(0x3000);
+  ASSERT_TRUE(MSHR::is_write(w1));
+  mshr.blockEntry(0x3000, w1);
+  EXPECT_FALSE(mshr.hasFreeEntries(true));
+  EXPECT_FALSE(mshr.canIssue(0x4000, true));
+
+  // A read miss to a new line waits for a read entry, not for the write
+  auto* r3 = read(0x4000);
+  EXPECT_TRUE(mshr.canAccept(0x4000));
+  queue(mshr, r3);
+
+  EXPECT_FALSE(mshr.retire(0x3000, w1));
+  EXPECT_EQ(nWake, 0);
+  EXPECT_TRUE(mshr.hasFreeEntries(true));
+
+  // The read entry is handed to the waiting miss
+  EXPECT_TRUE(mshr.retire(0x1000, r1));
+  EXPECT_EQ(nWake, 1);
+  EXPECT_FALSE(mshr.hasFreeEntries());
+  EXPECT_FALSE(mshr.canIssue(0x4000));
+
+  EXPECT_FALSE(mshr.retire(0x4000, r3));
+  EXPECT_FALSE(mshr.retire(0x2000, r2));
+  EXPECT_TRUE(mshr.hasFreeEntries());
+}
+
+TEST_F(MSHR_test, line_waiter_respects_targets) {
+  Line_MSHR mshr("line_waiters", 1, 1, 1, 64);
+
+  auto* r1 = read(0x1000);
+  mshr.blockEntry(0x1000, r1);
+
+  // Waits for the read pool
+  auto* r2 = read(0x2000);
+  queue(mshr, r2);
+
+  EXPECT_TRUE(mshr.retire(0x1000, r1));
+  EXPECT_EQ(nWake, 1);
+  EXPECT_FALSE(mshr.canAccept(0x2000));  // 1 target: only the primary
+
+  EXPECT_FALSE(mshr.retire(0x2000, r2));
+  EXPECT_TRUE(mshr.hasFreeEntries());
+}
+
+TEST_F(MSHR_test, only_line_limits_targets) {
+  Line_MSHR line("line_limits", 1, 1, 1, 64);
+  Hash_MSHR hash("hash_limits", 128, 64, 1);
+
+  // The cache retries on canAccept only for the line MSHR, the hashed one
+  // keeps queueing in addEntry
+  EXPECT_TRUE(line.limits_targets());
+  EXPECT_FALSE(hash.limits_targets());
+}
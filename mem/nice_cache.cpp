@@ -72,7 +72,8 @@ void Nice_cache::doDisp(MemRequest* mreq) {
 bool Nice_cache::isBusy([[maybe_unused]] Addr_t addr) const { return false; }
 
 void Nice_cache::tryPrefetch([[maybe_unused]] Addr_t addr, [[maybe_unused]] bool doStats, [[maybe_unused]] int degree,
-                             [[maybe_unused]] Addr_t pref_sign, [[maybe_unused]] Addr_t pc, CallbackBase* cb) {
+                             [[maybe_unused]] Addr_t pref_sign, [[maybe_unused]] Addr_t pc, CallbackBase* cb,
+                             [[maybe_unused]] Time_t age) {
   if (cb) {
     cb->destroy();
   }
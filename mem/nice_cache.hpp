@@ -56,7 +56,7 @@ public:
   void doSetStateAck(MemRequest* req);
   void doDisp(MemRequest* req);
 
-  void tryPrefetch(Addr_t addr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb = 0);
+  void tryPrefetch(Addr_t addr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb = 0, Time_t age = 0);
 
   TimeDelta_t ffread(Addr_t addr);
   TimeDelta_t ffwrite(Addr_t addr);
@@ -0,0 +1,156 @@
+// See LICENSE for details.
+
+#include "noc.hpp"
+
+#include "absl/strings/str_split.h"
+#include "config.hpp"
+
+Noc::Noc(Memory_system* current, const std::string& sec, const std::string& n)
+    /* constructor {{{1 */
+    : MemObj(sec, n) {
+  I(current);
+
+  net = std::make_unique<InterConnection>(section, name);
+
+  dropBits  = Config::get_integer(section, "drop_bits", 0, 40);
+  num_banks = Config::get_power2(section, "num_banks", 1, 1024);
+
+  auto line_size = Config::get_power2(section, "line_size", 4, 4096);
+  ctrlFlits      = 1;
+  dataFlits      = 1 + net->get_flits(line_size);  // header + payload
+  if (dataFlits > net->get_buffer_flits()) {
+    Config::add_error(fmt::format("noc section:{} buffer_flits must hold a whole data packet ({} flits)", section, dataFlits));
+  }
+
+  auto nrouters = net->get_num_routers();
+  bankRouter.resize(num_banks);
+  for (auto i = 0u; i < num_banks; ++i) {
+    bankRouter[i] = static_cast<uint32_t>((static_cast<uint64_t>(i) * nrouters) / num_banks);
+  }
+
+  std::vector<std::string> vPars = absl::StrSplit(Config::get_string(section, "lower_level"), ' ');
+  if (vPars.empty() || vPars[0].empty()) {
+    Config::add_error(fmt::format("invalid lower_level pointer in section:{}", section));
+    return;
+  }
+  std::string lower_name;
+  if (vPars.size() > 1) {
+    lower_name = vPars[1];
+  }
+
+  lower_level_banks.resize(num_banks);
+  for (auto i = 0u; i < num_banks; ++i) {
+    std::string tmp;
+    if (num_banks > 1) {
+      tmp = fmt::format("{}{}({})", name, lower_name, i);
+    } else {
+      tmp = fmt::format("{}{}", name, lower_name);
+    }
+
+    lower_level_banks[i] = current->declareMemoryObj_uniqueName(tmp, vPars[0]);
+    addLowerLevel(lower_level_banks[i]);
+  }
+}
+/* }}} */
+
+uint32_t Noc::getUpRouter(const MemRequest* mreq) const {
+  auto port = router->getCreatorPort(mreq);
+  if (port < 0) {
+    port = 0;  // created by this level or a lower one
+  }
+  return static_cast<uint32_t>(port) % net->get_num_routers();
+}
+
+void Noc::doReq(MemRequest* mreq)
+/* request from an upper level to a slice (down) {{{1 */
+{
+  auto pos = addrHash(mreq->getAddr());
+  auto cb  = deliverReqCB::create(this, mreq, mreq->getPriority());
+  net->send(getUpRouter(mreq), bankRouter[pos], ctrlFlits, InterConnection::Request, cb, mreq->has_stats());
+}
+/* }}} */
+
+void Noc::doReqAck(MemRequest* mreq)
+/* data back from a slice (up) {{{1 */
+{
+  if (mreq->isHomeNode()) {
+    mreq->ack();
+    return;
+  }
+
+  auto pos = addrHash(mreq->getAddr());
+  auto cb  = deliverReqAckCB::create(this, mreq, mreq->getPriority());
+  net->send(bankRouter[pos], getUpRouter(mreq), dataFlits, InterConnection::Response, cb, mreq->has_stats());
+}
+/* }}} */
+
+void Noc::doSetState(MemRequest* mreq)
+/* forward set state to all the upper nodes {{{1 */
+{
+  if (router->isTopLevel()) {
+    mreq->convert2SetStateAck(ma_setInvalid, false);
+    router->scheduleSetStateAck(mreq, 1);
+    return;
+  }
+  router->sendSetStateAll(mreq, mreq->getAction(), net->get_max_zero_load_latency(ctrlFlits));
+}
+/* }}} */
+
+void Noc::doSetStateAck(MemRequest* mreq)
+/* set state ack back to the slice (down) {{{1 */
+{
+  if (mreq->isHomeNode()) {
+    mreq->ack();
+    return;
+  }
+
+  auto pos = addrHash(mreq->getAddr());
+  auto cb  = deliverSetStateAckCB::create(this, mreq, mreq->getPriority());
+  net->send(getUpRouter(mreq), bankRouter[pos], ctrlFlits, InterConnection::Response, cb, mreq->has_stats());
+}
+/* }}} */
+
+void Noc::doDisp(MemRequest* mreq)
+/* writeback to a slice (down) {{{1 */
+{
+  auto pos = addrHash(mreq->getAddr());
+  auto cb  = deliverDispCB::create(this, mreq, mreq->getPriority());
+  net->send(getUpRouter(mreq), bankRouter[pos], dataFlits, InterConnection::Request, cb, mreq->has_stats());
+}
+/* }}} */
+
+void Noc::deliverReq(MemRequest* mreq) { router->scheduleReqPos(addrHash(mreq->getAddr()), mreq); }
+
+void Noc::deliverReqAck(MemRequest* mreq) { router->scheduleReqAck(mreq); }
+
+void Noc::deliverSetStateAck(MemRequest* mreq) { router->scheduleSetStateAckPos(addrHash(mreq->getAddr()), mreq); }
+
+void Noc::deliverDisp(MemRequest* mreq) { router->scheduleDispPos(addrHash(mreq->getAddr()), mreq); }
+
+bool Noc::isBusy(Addr_t addr) const {
+  auto pos = addrHash(addr);
+  return router->isBusyPos(pos, addr);
+}
+
+void Noc::tryPrefetch(Addr_t addr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb, Time_t age) {
+  auto pos = addrHash(addr);
+  router->tryPrefetchPos(pos, addr, degree, doStats, pref_sign, pc, cb, age);
+}
+
+TimeDelta_t Noc::ffread(Addr_t addr)
+/* fast forward reads {{{1 */
+{
+  auto pos = addrHash(addr);
+  auto lat = net->get_zero_load_latency(0, bankRouter[pos], ctrlFlits) + net->get_zero_load_latency(bankRouter[pos], 0, dataFlits);
+  return lat + router->ffreadPos(pos, addr);
+}
+/* }}} */
+
+TimeDelta_t Noc::ffwrite(Addr_t addr)
+/* fast forward writes {{{1 */
+{
+  auto pos = addrHash(addr);
+  auto lat = net->get_zero_load_latency(0, bankRouter[pos], ctrlFlits) + net->get_zero_load_latency(bankRouter[pos], 0, dataFlits);
+  return lat + router->ffwritePos(pos, addr);
+}
+/* }}} */
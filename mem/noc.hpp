@@ -0,0 +1,72 @@
+// See LICENSE for details.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "interconn.hpp"
+#include "memobj.hpp"
+#include "memory_system.hpp"
+#include "memrequest.hpp"
+#include "stats.hpp"
+
+// Network on chip between the upper levels (e.g. private L2s) and
+// num_banks lower level slices (e.g. LLC slices), interleaved by address
+// like MemXBar. Upper level i sits at router i % routers, and slice j at
+// router j * routers / num_banks. Requests and setStateAcks are single flit
+// control packets; reqAcks and disps carry a line.
+//
+// setState (invalidations) are broadcast to all the upper levels with the
+// zero load latency to the farthest router; they do not use the network.
+class Noc : public MemObj {
+protected:
+  std::unique_ptr<InterConnection> net;
+
+  std::vector<MemObj*>  lower_level_banks;
+  std::vector<uint32_t> bankRouter;
+  uint32_t              num_banks;
+  uint32_t              dropBits;
+  uint16_t              ctrlFlits;
+  uint16_t              dataFlits;
+
+  [[nodiscard]] uint32_t getUpRouter(const MemRequest* mreq) const;
+
+public:
+  Noc(Memory_system* current, const std::string& device_descr_section, const std::string& device_name = "");
+  ~Noc() = default;
+
+  // Entry points to schedule that may schedule a do?? if needed
+  void req(MemRequest* req) { doReq(req); };
+  void reqAck(MemRequest* req) { doReqAck(req); };
+  void setState(MemRequest* req) { doSetState(req); };
+  void setStateAck(MemRequest* req) { doSetStateAck(req); };
+  void disp(MemRequest* req) { doDisp(req); }
+
+  // This do the real work
+  void doReq(MemRequest* req);
+  void doReqAck(MemRequest* req);
+  void doSetState(MemRequest* req);
+  void doSetStateAck(MemRequest* req);
+  void doDisp(MemRequest* req);
+
+  void tryPrefetch(Addr_t addr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb = nullptr, Time_t age = 0);
+
+  [[nodiscard]] TimeDelta_t ffread(Addr_t addr);
+  [[nodiscard]] TimeDelta_t ffwrite(Addr_t addr);
+
+  [[nodiscard]] bool isBusy(Addr_t addr) const;
+
+  [[nodiscard]] uint32_t addrHash(Addr_t addr) const { return (addr >> dropBits) & (num_banks - 1); }
+
+  // Called when the packet is ejected at its destination router
+  void deliverReq(MemRequest* mreq);
+  void deliverReqAck(MemRequest* mreq);
+  void deliverSetStateAck(MemRequest* mreq);
+  void deliverDisp(MemRequest* mreq);
+
+  using deliverReqCB         = CallbackMember1<Noc, MemRequest*, &Noc::deliverReq>;
+  using deliverReqAckCB      = CallbackMember1<Noc, MemRequest*, &Noc::deliverReqAck>;
+  using deliverSetStateAckCB = CallbackMember1<Noc, MemRequest*, &Noc::deliverSetStateAck>;
+  using deliverDispCB        = CallbackMember1<Noc, MemRequest*, &Noc::deliverDisp>;
+};
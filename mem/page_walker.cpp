@@ -0,0 +1,250 @@
+// See LICENSE for details.
+
+#include "page_walker.hpp"
+
+#include <algorithm>
+
+#include "config.hpp"
+
+// Page tables live in a physical range that the emulated programs do not use
+static constexpr Addr_t pt_base = 0x40000000000ULL;  // 4TB
+
+static uint64_t region_hash(Addr_t x) { return (x * 0x9E3779B97F4A7C15ULL) >> 32; }
+
+Page_walker::Page_walker(Memory_system* current, const std::string& sec, const std::string& n)
+    /* constructor {{{1 */
+    : MemObj(sec, n)
+    , delay(Config::get_integer(sec, "delay", 1, 1024))
+    , hugeRatio2M(Config::get_integer(sec, "huge_2m_ratio", 0, 100))
+    , hugeRatio1G(Config::get_integer(sec, "huge_1g_ratio", 0, 100))
+    , maxWalks(Config::get_integer(sec, "max_walks", 1, 64))
+    , array(Config::get_integer(sec, "size", 1, 65536), Config::get_integer(sec, "assoc", 1, 65536))
+    , nHit(fmt::format("{}:nHit", n))
+    , nMiss(fmt::format("{}:nMiss", n))
+    , nMerged(fmt::format("{}:nMerged", n))
+    , nPWCHit(fmt::format("{}:nPWCHit", n))
+    , nPTERead(fmt::format("{}:nPTERead", n))
+    , nWalk4K(fmt::format("{}:nWalk4K", n))
+    , nWalk2M(fmt::format("{}:nWalk2M", n))
+    , nWalk1G(fmt::format("{}:nWalk1G", n))
+    , avgWalkLat(fmt::format("{}_avgWalkLat", n))
+    , avgQueueLat(fmt::format("{}_avgQueueLat", n)) {
+  I(current);
+  Tlb_array::check(sec);
+
+  auto pwc_size = Config::get_integer(sec, "pwc_size", 1, 1024);
+
+  for (auto level = 2u; level <= num_levels; ++level) {
+    pwc.emplace_back(pwc_size, pwc_size);
+  }
+  walks.resize(maxWalks);
+  for (auto& w : walks) {
+    w.busy = false;
+  }
+  nActive = 0;
+
+  MemObj* lower_level = current->declareMemoryObj(section, "lower_level");
+  if (lower_level) {
+    addLowerLevel(lower_level);
+    router->fillRouteTables();  // top level, like the core L1s (see Gmemory_system)
+  } else {
+    Config::add_error(fmt::format("section [{}] lower_level is needed for the page table reads", sec));
+  }
+}
+/* }}} */
+
+uint32_t Page_walker::get_page_bits(Addr_t vaddr) const {
+  if (hugeRatio1G && region_hash(vaddr >> 30) % 100 < hugeRatio1G) {
+    return 30;
+  }
+  if (hugeRatio2M && region_hash(vaddr >> 21) % 100 < hugeRatio2M) {
+    return 21;
+  }
+  return 12;
+}
+
+Addr_t Page_walker::get_pte_addr(Addr_t vaddr, uint32_t level) {
+  // Each table is a 4K page placed by a hash of the address range it maps
+  auto prefix = vaddr >> level_shift(level + 1);
+  auto table  = ((prefix * 0x9E3779B97F4A7C15ULL) ^ level) >> 40;  // 16M table pages
+  auto index  = (vaddr >> level_shift(level)) & 511;
+
+  return pt_base + (table << 12) + index * 8;
+}
+
+uint32_t Page_walker::first_level(Addr_t vaddr, uint32_t page_bits) {
+  // The deepest walk cache hit gives the table to start from
+  for (auto level = leaf_level(page_bits) + 1; level <= num_levels; ++level) {
+    if (pwc[level - 2].lookup(Tlb_array::make_key(vaddr, level_shift(level)))) {
+      return level - 1;
+    }
+  }
+  return num_levels;
+}
+
+void Page_walker::translate(Addr_t vaddr, bool doStats, CallbackBase* cb)
+/* L1 TLB miss {{{1 */
+{
+  auto page_bits = get_page_bits(vaddr);
+  auto key       = Tlb_array::make_key(vaddr, page_bits);
+
+  for (auto& w : walks) {
+    if (w.busy && w.key == key) {
+      nMerged.inc(doStats);
+      w.waiters.push_back(cb);
+      return;
+    }
+  }
+
+  auto it = std::find_if(walks.begin(), walks.end(), [](const Walk& w) { return !w.busy; });
+  if (it == walks.end()) {
+    walks.emplace_back();  // lookups in flight are not limited, only the walks
+    it = walks.end() - 1;
+  }
+
+  it->vaddr     = vaddr;
+  it->key       = key;
+  it->start     = globalClock;
+  it->page_bits = page_bits;
+  it->level     = num_levels;
+  it->doStats   = doStats;
+  it->busy      = true;
+  it->waiters.push_back(cb);
+
+  lookupCB::schedule(delay, this, static_cast<uint32_t>(it - walks.begin()));
+}
+/* }}} */
+
+void Page_walker::lookup(uint32_t walk_id) {
+  auto& w = walks[walk_id];
+
+  if (array.lookup(w.key)) {
+    nHit.inc(w.doStats);
+    finish_walk(walk_id);
+    return;
+  }
+  nMiss.inc(w.doStats);
+
+  if (nActive >= maxWalks) {
+    pending.push_back(walk_id);
+    return;
+  }
+  start_walk(walk_id);
+}
+
+void Page_walker::start_walk(uint32_t walk_id) {
+  auto& w = walks[walk_id];
+
+  nActive++;
+  avgQueueLat.sample(globalClock - w.start - delay, w.doStats);
+
+  if (w.page_bits == 30) {
+    nWalk1G.inc(w.doStats);
+  } else if (w.page_bits == 21) {
+    nWalk2M.inc(w.doStats);
+  } else {
+    nWalk4K.inc(w.doStats);
+  }
+
+  w.level = first_level(w.vaddr, w.page_bits);
+  if (w.level < num_levels) {
+    nPWCHit.inc(w.doStats);
+  }
+  read_pte(walk_id);
+}
+
+void Page_walker::read_pte(uint32_t walk_id) {
+  auto& w = walks[walk_id];
+
+  nPTERead.inc(w.doStats);
+  MemRequest::sendReqRead(this, w.doStats, get_pte_addr(w.vaddr, w.level), 0, pteDoneCB::create(this, walk_id));
+}
+
+void Page_walker::pte_done(uint32_t walk_id) {
+  auto& w = walks[walk_id];
+
+  if (w.level > leaf_level(w.page_bits)) {
+    pwc[w.level - 2].insert(Tlb_array::make_key(w.vaddr, level_shift(w.level)));
+    w.level--;
+    read_pte(walk_id);
+    return;
+  }
+
+  array.insert(w.key);
+  avgWalkLat.sample(globalClock - w.start, w.doStats);
+
+  I(nActive > 0);
+  nActive--;
+  finish_walk(walk_id);
+
+  if (!pending.empty()) {
+    auto next = pending.front();
+    pending.pop_front();
+    start_walk(next);
+  }
+}
+
+void Page_walker::finish_walk(uint32_t walk_id) {
+  std::vector<CallbackBase*> waiters;
+  std::swap(waiters, walks[walk_id].waiters);  // a waiter may start a new translation
+  walks[walk_id].busy = false;
+
+  for (auto* cb : waiters) {
+    cb->call();
+  }
+}
+
+void Page_walker::fftranslate(Addr_t vaddr) {
+  auto page_bits = get_page_bits(vaddr);
+  auto key       = Tlb_array::make_key(vaddr, page_bits);
+  if (array.lookup(key)) {
+    return;
+  }
+
+  auto leaf = leaf_level(page_bits);
+  for (auto level = first_level(vaddr, page_bits); level >= leaf; --level) {
+    router->ffread(get_pte_addr(vaddr, level));
+    if (level > leaf) {
+      pwc[level - 2].insert(Tlb_array::make_key(vaddr, level_shift(level)));
+    }
+  }
+  array.insert(key);
+}
+
+void Page_walker::doReq(MemRequest* mreq) { router->scheduleReq(mreq, 0); }
+
+void Page_walker::doDisp(MemRequest* mreq) { router->scheduleDisp(mreq, 0); }
+
+void Page_walker::doReqAck(MemRequest* mreq) {
+  if (mreq->isHomeNode()) {
+    mreq->ack();
+    return;
+  }
+
+  router->scheduleReqAck(mreq, 0);
+}
+
+void Page_walker::doSetState(MemRequest* mreq) {
+  // No coherent state: the walk caches are not kept coherent with the page table lines
+  I(router->isTopLevel());
+  mreq->convert2SetStateAck(ma_setInvalid, false);
+  router->scheduleSetStateAck(mreq, 1);
+}
+
+void Page_walker::doSetStateAck(MemRequest* mreq) {
+  if (mreq->isHomeNode()) {
+    mreq->ack();
+    return;
+  }
+  router->scheduleSetStateAck(mreq, 0);
+}
+
+bool Page_walker::isBusy(Addr_t addr) const { return router->isBusyPos(0, addr); }
+
+void Page_walker::tryPrefetch(Addr_t addr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb, Time_t age) {
+  router->tryPrefetch(addr, doStats, degree, pref_sign, pc, cb, age);
+}
+
+TimeDelta_t Page_walker::ffread(Addr_t addr) { return router->ffread(addr); }
+
+TimeDelta_t Page_walker::ffwrite(Addr_t addr) { return router->ffwrite(addr); }
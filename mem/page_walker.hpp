@@ -0,0 +1,111 @@
+// See LICENSE for details.
+
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include "callback.hpp"
+#include "memory_system.hpp"
+#include "memrequest.hpp"
+#include "stats.hpp"
+#include "tlb.hpp"
+
+// Shared L2 TLB and page table walker for the first level TLBs of a core.
+//
+// A translation looks up the L2 TLB (delay cycles). On a miss a walk reads
+// one PTE per level of a 4 level radix page table (4K pages read 4 levels,
+// 2M pages 3 and 1G pages 2). The PTE reads are MemRequests sent to
+// lower_level, so they compete for the caches with the core. Page walk
+// caches keep the upper level entries (one per level, pwc_size entries) and
+// skip the reads above the deepest hit. Up to max_walks walks proceed in
+// parallel; misses to a page being walked wait for that walk.
+//
+// The page size of an address is fixed: huge_1g_ratio percent of the 1G
+// regions and huge_2m_ratio percent of the remaining 2M regions are huge
+// pages (chosen by a hash of the region), the rest are 4K pages.
+class Page_walker : public MemObj {
+public:
+  Page_walker(Memory_system* current, const std::string& device_descr_section, const std::string& device_name = "");
+  ~Page_walker() {}
+
+  [[nodiscard]] uint32_t get_page_bits(Addr_t vaddr) const;
+
+  // cb is called when the translation is in the L2 TLB
+  void translate(Addr_t vaddr, bool doStats, CallbackBase* cb);
+  // Warmup: update the L2 TLB, walk caches and PTE lines without timing
+  void fftranslate(Addr_t vaddr);
+
+  // Entry points to schedule that may schedule a do?? if needed
+  void req(MemRequest* req) { doReq(req); };
+  void reqAck(MemRequest* req) { doReqAck(req); };
+  void setState(MemRequest* req) { doSetState(req); };
+  void setStateAck(MemRequest* req) { doSetStateAck(req); };
+  void disp(MemRequest* req) { doDisp(req); }
+
+  // This do the real work
+  void doReq(MemRequest* r);
+  void doReqAck(MemRequest* req);
+  void doSetState(MemRequest* req);
+  void doSetStateAck(MemRequest* req);
+  void doDisp(MemRequest* req);
+
+  TimeDelta_t ffread(Addr_t addr);
+  TimeDelta_t ffwrite(Addr_t addr);
+
+  void tryPrefetch(Addr_t addr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb = 0, Time_t age = 0);
+
+  bool isBusy(Addr_t addr) const;
+
+protected:
+  static constexpr uint32_t num_levels = 4;
+
+  class Walk {
+  public:
+    Addr_t                     vaddr;
+    Addr_t                     key;  // Tlb_array key of the page
+    Time_t                     start;
+    std::vector<CallbackBase*> waiters;
+    uint32_t                   page_bits;
+    uint32_t                   level;  // level of the PTE being read (num_levels is the root)
+    bool                       doStats;
+    bool                       busy;
+  };
+
+  const TimeDelta_t delay;
+  const uint32_t    hugeRatio2M;
+  const uint32_t    hugeRatio1G;
+  const uint32_t    maxWalks;
+
+  Tlb_array              array;
+  std::vector<Tlb_array> pwc;  // pwc[k] caches the entries of level k+2
+  std::vector<Walk>      walks;
+  std::deque<uint32_t>   pending;  // walks waiting for a free walker
+  uint32_t               nActive;
+
+  Stats_cntr nHit;
+  Stats_cntr nMiss;
+  Stats_cntr nMerged;
+  Stats_cntr nPWCHit;
+  Stats_cntr nPTERead;
+  Stats_cntr nWalk4K;
+  Stats_cntr nWalk2M;
+  Stats_cntr nWalk1G;
+  Stats_avg  avgWalkLat;
+  Stats_avg  avgQueueLat;
+
+  [[nodiscard]] static uint32_t level_shift(uint32_t level) { return 12 + 9 * (level - 1); }
+  [[nodiscard]] static uint32_t leaf_level(uint32_t page_bits) { return (page_bits - 12) / 9 + 1; }
+  [[nodiscard]] static Addr_t   get_pte_addr(Addr_t vaddr, uint32_t level);
+
+  [[nodiscard]] uint32_t first_level(Addr_t vaddr, uint32_t page_bits);
+
+  void lookup(uint32_t walk_id);
+  void start_walk(uint32_t walk_id);
+  void read_pte(uint32_t walk_id);
+  void pte_done(uint32_t walk_id);
+  void finish_walk(uint32_t walk_id);
+
+  using lookupCB  = CallbackMember1<Page_walker, uint32_t, &Page_walker::lookup>;
+  using pteDoneCB = CallbackMember1<Page_walker, uint32_t, &Page_walker::pte_done>;
+};
@@ -0,0 +1,159 @@
+// See LICENSE for details.
+
+#include <fstream>
+
+#include "ccache.hpp"
+#include "config.hpp"
+#include "gtest/gtest.h"
+#include "memobj.hpp"
+#include "memory_system.hpp"
+#include "memrequest.hpp"
+#include "report.hpp"
+
+static void setup_config() {
+  std::ofstream file;
+
+  file.open("prefetch_queue_test.toml");
+
+  file << "[soc]\n"
+          "core = [\"c0\"]\n"
+          "[c0]\n"
+          "type  = \"ooo\"\n"
+          "caches        = true\n"
+          "dl1           = \"dl1_cache DL1\"\n"
+          "il1           = \"il1_cache IL1\"\n"
+          "[dl1_cache]\n"
+          "type       = \"cache\"\n"
+          "cold_misses = true\n"
+          "size       = 32768\n"
+          "line_size  = 64\n"
+          "delay      = 2\n"
+          "miss_delay = 2\n"
+          "assoc      = 4\n"
+          "repl_policy = \"lru\"\n"
+          "port_occ   = 1\n"
+          "port_num   = 1\n"
+          "port_banks = 32\n"
+          "send_port_occ = 1\n"
+          "send_port_num = 1\n"
+          "max_requests  = 32\n"
+          "mshr_type          = \"line\"\n"
+          "mshr_read_entries  = 1\n"
+          "mshr_write_entries = 1\n"
+          "mshr_targets       = 4\n"
+          "allocate_miss = true\n"
+          "victim        = false\n"
+          "coherent      = true\n"
+          "inclusive     = true\n"
+          "directory     = false\n"
+          "nlp_distance = 2\n"
+          "nlp_degree   = 0\n"
+          "nlp_stride   = 1\n"
+          "drop_prefetch = true\n"
+          "prefetch_degree = 1\n"
+          "prefetch_queue  = 2\n"
+          "mega_lines1K    = 0\n"
+          "lower_level = \"l2_cache L2\"\n"
+          "[il1_cache]\n"
+          "type       = \"cache\"\n"
+          "cold_misses = true\n"
+          "size       = 32768\n"
+          "line_size  = 64\n"
+          "delay      = 2\n"
+          "miss_delay = 2\n"
+          "assoc      = 4\n"
+          "repl_policy = \"lru\"\n"
+          "port_occ   = 1\n"
+          "port_num   = 1\n"
+          "port_banks = 32\n"
+          "send_port_occ = 1\n"
+          "send_port_num = 1\n"
+          "max_requests  = 32\n"
+          "allocate_miss = true\n"
+          "victim        = false\n"
+          "coherent      = true\n"
+          "inclusive     = true\n"
+          "directory     = false\n"
+          "nlp_distance = 2\n"
+          "nlp_degree   = 0\n"
+          "nlp_stride   = 1\n"
+          "drop_prefetch = true\n"
+          "prefetch_degree = 0\n"
+          "mega_lines1K    = 0\n"
+          "lower_level = \"l2_cache L2\"\n"
+          "[l2_cache]\n"
+          "type       = \"nice\"\n"
+          "line_size  = 64\n"
+          "delay      = 11\n"
+          "cold_misses = false\n"
+          "lower_level = \"\"\n";
+
+  file.close();
+}
+
+class Prefetch_queue_test : public ::testing::Test {
+protected:
+  static inline CCache* dl1 = nullptr;
+
+  static void SetUpTestSuite() {
+    setup_config();
+
+    Report::init();
+    Config::init("prefetch_queue_test.toml");
+
+    auto* gms = new Memory_system(0);
+    Config::exit_on_error();
+    EventScheduler::advanceClock();
+
+    ASSERT_EQ(gms->getDL1()->get_type(), "cache");
+    dl1 = static_cast<CCache*>(gms->getDL1());
+  }
+
+  static void prefetch(Addr_t addr, Time_t age) { dl1->tryPrefetch(addr, true, 0, 0xF00D, 0x100, nullptr, age); }
+
+  static double cntr(const std::string& name) { return Stats::get_cntr(name); }
+};
+
+TEST_F(Prefetch_queue_test, age_order_and_youngest_drop) {
+  // Untagged, takes the single MSHR read entry
+  prefetch(0x10000, 0);
+  EXPECT_EQ(cntr("DL1(0):nSendPrefetch"), 1);
+
+  // Untagged with the MSHR full: not queued
+  prefetch(0x20000, 0);
+  EXPECT_EQ(cntr("DL1(0):nPrefetchQueued"), 0);
+  EXPECT_EQ(cntr("DL1(0):nSendPrefetch"), 1);
+
+  prefetch(0x30000, 30);
+  prefetch(0x40000, 10);
+  EXPECT_EQ(cntr("DL1(0):nPrefetchQueued"), 2);
+  EXPECT_EQ(cntr("DL1(0):nPrefetchDropped"), 0);
+
+  // Queue full: the older one forces out age 30
+  prefetch(0x50000, 20);
+  EXPECT_EQ(cntr("DL1(0):nPrefetchAgeDropped"), 1);
+  EXPECT_EQ(cntr("DL1(0):nPrefetchDropped"), 1);
+
+  // The youngest is the new one, dropped without displacing anything
+  prefetch(0x60000, 40);
+  EXPECT_EQ(cntr("DL1(0):nPrefetchQueued"), 4);
+  EXPECT_EQ(cntr("DL1(0):nPrefetchAgeDropped"), 1);
+  EXPECT_EQ(cntr("DL1(0):nPrefetchDropped"), 2);
+
+  // Oldest first as the MSHR entry frees up
+  while (dl1->Invalid(0x40000)) {
+    EXPECT_TRUE(dl1->Invalid(0x50000));
+    EventScheduler::advanceClock();
+    ASSERT_LT(globalClock, 10000);
+  }
+  while (dl1->Invalid(0x50000)) {
+    EventScheduler::advanceClock();
+    ASSERT_LT(globalClock, 10000);
+  }
+
+  EXPECT_FALSE(dl1->Invalid(0x10000));
+  EXPECT_TRUE(dl1->Invalid(0x20000));
+  EXPECT_TRUE(dl1->Invalid(0x30000));
+  EXPECT_TRUE(dl1->Invalid(0x60000));
+  EXPECT_EQ(cntr("DL1(0):nSendPrefetch"), 3);
+}
@@ -0,0 +1,120 @@
+// See LICENSE for details.
+
+#include "stack_profiler.hpp"
+
+#include <algorithm>
+#include <bit>
+
+#include "config.hpp"
+
+Stack_profiler::Stack_profiler(Memory_system* current, const std::string& sec, const std::string& n)
+    : MemObj(sec, n)
+    , lineSizeBits(log2i(Config::get_power2(sec, "line_size", 1, 4096)))
+    , maxAssocBits(log2i(Config::get_power2(sec, "max_assoc", 1, 1024)))
+    , faMaxLinesBits(std::max<uint32_t>(log2i(Config::get_power2(sec, "fa_max_size", 1024, 1 << 30)), lineSizeBits) - lineSizeBits)
+    , profile_warmup(Config::get_bool(sec, "profile_warmup"))
+    , fa_hist(fmt::format("{}_fa:hitLines", n))
+    , nAccess(fmt::format("{}:nAccess", n))
+    , nDisp(fmt::format("{}:nDisp", n)) {
+  if (Config::get_integer(sec, "fa_max_size") < (1 << lineSizeBits)) {
+    Config::add_error(fmt::format("section [{}] fa_max_size should not be smaller than line_size {}", sec, 1 << lineSizeBits));
+  }
+
+  auto min_sets = Config::get_power2(sec, "min_sets", 1, 1 << 24);
+  auto max_sets = Config::get_power2(sec, "max_sets", 1, 1 << 24);
+  if (min_sets > max_sets) {
+    Config::add_error(fmt::format("section [{}] min_sets {} should not be larger than max_sets {}", sec, min_sets, max_sets));
+    max_sets = min_sets;
+  }
+
+  auto max_assoc = 1u << maxAssocBits;
+  for (auto nsets = min_sets; nsets && nsets <= max_sets; nsets <<= 1) {
+    set_profiles.emplace_back(nsets, max_assoc);
+    set_hists.emplace_back(std::make_unique<Stats_hist>(fmt::format("{}_sets({}):hitWays", n, nsets)));
+  }
+
+  I(current);
+  MemObj* lower_level = current->declareMemoryObj(section, "lower_level");
+  if (lower_level) {
+    addLowerLevel(lower_level);
+  }
+}
+
+void Stack_profiler::access(Addr_t addr, bool doStats) {
+  auto line = addr >> lineSizeBits;
+
+  // key is log2 of the smallest power-of-two ways (lines for fa) that hits. Misses go one past the largest
+  for (auto i = 0u; i < set_profiles.size(); ++i) {
+    auto dist = set_profiles[i].access(line);
+    set_hists[i]->sample(std::bit_width(dist), doStats);
+  }
+
+  auto fa_dist = fa_profile.access(line);
+  if (fa_dist >= (1ULL << faMaxLinesBits)) {
+    fa_hist.sample(faMaxLinesBits + 1, doStats);
+  } else {
+    fa_hist.sample(std::bit_width(fa_dist), doStats);
+  }
+
+  nAccess.inc(doStats);
+}
+
+void Stack_profiler::doReq(MemRequest* mreq) {
+  access(mreq->getAddr(), mreq->has_stats() || profile_warmup);
+
+  router->scheduleReq(mreq, 0);
+}
+
+void Stack_profiler::doDisp(MemRequest* mreq) {
+  // Displacements install the line in the lower level, but they are not demand accesses to profile
+  auto line = mreq->getAddr() >> lineSizeBits;
+  for (auto& prof : set_profiles) {
+    prof.access(line);
+  }
+  fa_profile.access(line);
+  nDisp.inc(mreq->has_stats());
+
+  router->scheduleDisp(mreq, 0);
+}
+
+void Stack_profiler::doReqAck(MemRequest* mreq) {
+  if (mreq->isHomeNode()) {
+    mreq->ack();
+    return;
+  }
+
+  router->scheduleReqAck(mreq, 0);
+}
+
+void Stack_profiler::doSetState(MemRequest* mreq) {
+  if (router->isTopLevel()) {
+    mreq->convert2SetStateAck(ma_setInvalid, false);
+    router->scheduleSetStateAck(mreq, 1);
+    return;
+  }
+  router->sendSetStateAll(mreq, mreq->getAction(), 0);
+}
+
+void Stack_profiler::doSetStateAck(MemRequest* mreq) {
+  if (mreq->isHomeNode()) {
+    mreq->ack();
+    return;
+  }
+  router->scheduleSetStateAck(mreq, 0);
+}
+
+bool Stack_profiler::isBusy(Addr_t addr) const { return router->isBusyPos(0, addr); }
+
+void Stack_profiler::tryPrefetch(Addr_t addr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb, Time_t age) {
+  router->tryPrefetch(addr, doStats, degree, pref_sign, pc, cb, age);
+}
+
+TimeDelta_t Stack_profiler::ffread(Addr_t addr) {
+  access(addr, profile_warmup);
+  return router->ffread(addr);
+}
+
+TimeDelta_t Stack_profiler::ffwrite(Addr_t addr) {
+  access(addr, profile_warmup);
+  return router->ffwrite(addr);
+}
@@ -0,0 +1,64 @@
+// See LICENSE for details.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "memobj.hpp"
+#include "memory_system.hpp"
+#include "memrequest.hpp"
+#include "stack_distance.hpp"
+#include "stats.hpp"
+
+// Transparent (zero latency) MemObj that profiles LRU stack distances of the
+// stream that reaches its lower level. One pass produces the miss ratio curve
+// of every power-of-two set count in [min_sets..max_sets] and associativity up
+// to max_assoc, plus the fully associative curve up to fa_max_size.
+//
+// For a configuration with S sets and 2^k ways: miss ratio is the fraction of
+// samples in "NAME_sets(S):hitWays" with key > k. Same for "NAME_fa:hitLines"
+// with 2^k lines.
+class Stack_profiler : public MemObj {
+protected:
+  const uint32_t lineSizeBits;
+  const uint32_t maxAssocBits;
+  const uint32_t faMaxLinesBits;
+  const bool     profile_warmup;
+
+  std::vector<Set_stack_distance>          set_profiles;
+  std::vector<std::unique_ptr<Stats_hist>> set_hists;
+
+  Stack_distance fa_profile;
+  Stats_hist     fa_hist;
+
+  Stats_cntr nAccess;
+  Stats_cntr nDisp;
+
+  void access(Addr_t addr, bool doStats);
+
+public:
+  Stack_profiler(Memory_system* current, const std::string& device_descr_section, const std::string& device_name = "");
+  ~Stack_profiler() {}
+
+  // Entry points to schedule that may schedule a do?? if needed
+  void req(MemRequest* req) { doReq(req); };
+  void reqAck(MemRequest* req) { doReqAck(req); };
+  void setState(MemRequest* req) { doSetState(req); };
+  void setStateAck(MemRequest* req) { doSetStateAck(req); };
+  void disp(MemRequest* req) { doDisp(req); }
+
+  // This do the real work
+  void doReq(MemRequest* r);
+  void doReqAck(MemRequest* req);
+  void doSetState(MemRequest* req);
+  void doSetStateAck(MemRequest* req);
+  void doDisp(MemRequest* req);
+
+  TimeDelta_t ffread(Addr_t addr);
+  TimeDelta_t ffwrite(Addr_t addr);
+
+  void tryPrefetch(Addr_t addr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb = 0, Time_t age = 0);
+
+  bool isBusy(Addr_t addr) const;
+};
@@ -0,0 +1,163 @@
+// See LICENSE for details.
+
+#include "tlb.hpp"
+
+#include <algorithm>
+#include <bit>
+
+#include "config.hpp"
+#include "page_walker.hpp"
+
+Tlb_array::Tlb_array(uint32_t size, uint32_t _assoc)
+    : assoc(_assoc), setMask(std::bit_floor(std::max(size / _assoc, 1u)) - 1), useCounter(0) {
+  entries.resize((setMask + 1) * assoc, Entry{0, 0});
+}
+
+bool Tlb_array::check(const std::string& section) {
+  auto size  = Config::get_integer(section, "size");
+  auto assoc = Config::get_integer(section, "assoc");
+  if (size % assoc || !std::has_single_bit(static_cast<uint32_t>(size / assoc))) {
+    Config::add_error(fmt::format("section [{}] size {} should be assoc {} times a power of two", section, size, assoc));
+    return false;
+  }
+  return true;
+}
+
+bool Tlb_array::lookup(Addr_t key) {
+  auto set = get_set(key);
+  for (auto i = set; i < set + assoc; ++i) {
+    if (entries[i].key == key) {
+      entries[i].last_use = ++useCounter;
+      return true;
+    }
+  }
+  return false;
+}
+
+void Tlb_array::insert(Addr_t key) {
+  auto  set    = get_set(key);
+  auto* victim = &entries[set];
+  for (auto i = set; i < set + assoc; ++i) {
+    if (entries[i].key == key) {
+      victim = &entries[i];
+      break;
+    }
+    if (entries[i].last_use < victim->last_use) {
+      victim = &entries[i];
+    }
+  }
+  victim->key      = key;
+  victim->last_use = ++useCounter;
+}
+
+Tlb::Tlb(Memory_system* current, const std::string& sec, const std::string& n)
+    /* constructor {{{1 */
+    : MemObj(sec, n)
+    , delay(Config::get_integer(sec, "delay", 0, 1024))
+    , array(Config::get_integer(sec, "size", 1, 65536), Config::get_integer(sec, "assoc", 1, 65536))
+    , walker(nullptr)
+    , nHit(fmt::format("{}:nHit", n))
+    , nMiss(fmt::format("{}:nMiss", n))
+    , avgMissLat(fmt::format("{}_avgMissLat", n)) {
+  I(current);
+  Tlb_array::check(sec);
+
+  MemObj* lower_level = current->declareMemoryObj(section, "lower_level");
+  if (lower_level) {
+    addLowerLevel(lower_level);
+
+    // The core reads line_size from its il1/dl1 section
+    auto line_size = Config::get_power2(section, "line_size");
+    if (line_size != Config::get_integer(lower_level->getSection(), "line_size")) {
+      Config::add_error(fmt::format("section [{}] line_size should match the lower_level cache", section));
+    }
+  }
+
+  MemObj* w = nullptr;
+  if (Config::has_entry(section, "walker")) {
+    w = current->declareMemoryObj(section, "walker");
+  }
+  if (w && w->get_type() == "walker") {
+    walker = static_cast<Page_walker*>(w);
+  } else {
+    Config::add_error(fmt::format("section [{}] walker should point to a type = \"walker\" section", section));
+  }
+}
+/* }}} */
+
+Addr_t Tlb::page_key(Addr_t addr) const {
+  // Without walker (config error) every access is a 4K page hit
+  return Tlb_array::make_key(addr, walker ? walker->get_page_bits(addr) : 12);
+}
+
+void Tlb::doReq(MemRequest* mreq) {
+  auto addr = mreq->getAddr();
+
+  if (walker == nullptr || array.lookup(page_key(addr))) {
+    nHit.inc(mreq->has_stats());
+    router->scheduleReq(mreq, delay);
+    return;
+  }
+
+  nMiss.inc(mreq->has_stats());
+  walker->translate(addr, mreq->has_stats(), translatedCB::create(this, mreq, globalClock));
+}
+
+void Tlb::translated(MemRequest* mreq, Time_t start) {
+  array.insert(page_key(mreq->getAddr()));
+
+  avgMissLat.sample(globalClock - start, mreq->has_stats());
+  router->scheduleReq(mreq, delay);
+}
+
+void Tlb::doDisp(MemRequest* mreq) { router->scheduleDisp(mreq, 0); }
+
+void Tlb::doReqAck(MemRequest* mreq) {
+  if (mreq->isHomeNode()) {
+    mreq->ack();
+    return;
+  }
+
+  router->scheduleReqAck(mreq, 0);
+}
+
+void Tlb::doSetState(MemRequest* mreq) {
+  if (router->isTopLevel()) {
+    mreq->convert2SetStateAck(ma_setInvalid, false);
+    router->scheduleSetStateAck(mreq, 1);
+    return;
+  }
+  router->sendSetStateAll(mreq, mreq->getAction(), 0);
+}
+
+void Tlb::doSetStateAck(MemRequest* mreq) {
+  if (mreq->isHomeNode()) {
+    mreq->ack();
+    return;
+  }
+  router->scheduleSetStateAck(mreq, 0);
+}
+
+bool Tlb::isBusy(Addr_t addr) const { return router->isBusyPos(0, addr); }
+
+void Tlb::tryPrefetch(Addr_t addr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb, Time_t age) {
+  router->tryPrefetch(addr, doStats, degree, pref_sign, pc, cb, age);
+}
+
+TimeDelta_t Tlb::ffread(Addr_t addr) {
+  auto key = page_key(addr);
+  if (walker && !array.lookup(key)) {
+    walker->fftranslate(addr);
+    array.insert(key);
+  }
+  return router->ffread(addr);
+}
+
+TimeDelta_t Tlb::ffwrite(Addr_t addr) {
+  auto key = page_key(addr);
+  if (walker && !array.lookup(key)) {
+    walker->fftranslate(addr);
+    array.insert(key);
+  }
+  return router->ffwrite(addr);
+}
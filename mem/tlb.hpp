@@ -0,0 +1,93 @@
+// See LICENSE for details.
+
+#pragma once
+
+#include <vector>
+
+#include "callback.hpp"
+#include "memory_system.hpp"
+#include "memrequest.hpp"
+#include "stats.hpp"
+
+class Page_walker;
+
+// Set associative LRU array of translations. The key has the virtual page
+// number and the page size, so 4K, 2M and 1G entries share the array.
+class Tlb_array {
+public:
+  Tlb_array(uint32_t size, uint32_t assoc);
+
+  // size and assoc of the section give a power of two number of sets
+  static bool check(const std::string& section);
+
+  [[nodiscard]] static Addr_t make_key(Addr_t vaddr, uint32_t page_bits) { return ((vaddr >> page_bits) << 6) | page_bits; }
+
+  bool lookup(Addr_t key);  // updates the LRU
+  void insert(Addr_t key);
+
+private:
+  class Entry {
+  public:
+    Addr_t   key;  // 0 is invalid
+    uint64_t last_use;
+  };
+
+  std::vector<Entry> entries;
+  const uint32_t     assoc;
+  const uint32_t     setMask;
+  uint64_t           useCounter;
+
+  [[nodiscard]] size_t get_set(Addr_t key) const {
+    auto vpn = key >> 6;
+    return ((vpn ^ (vpn >> 11)) & setMask) * assoc;
+  }
+};
+
+// First level TLB, placed as the il1 or dl1 of a core in front of the L1
+// cache. Requests that hit go down after delay cycles. Misses ask the
+// walker (shared L2 TLB and page table walker) and wait for the translation.
+//
+// The emulator gives physical addresses, so they are used as virtual
+// addresses with an identity mapping: only the translation timing and the
+// page table walk traffic are modeled.
+class Tlb : public MemObj {
+protected:
+  const TimeDelta_t delay;
+
+  Tlb_array    array;
+  Page_walker* walker;
+
+  Stats_cntr nHit;
+  Stats_cntr nMiss;
+  Stats_avg  avgMissLat;
+
+  [[nodiscard]] Addr_t page_key(Addr_t addr) const;
+
+  void translated(MemRequest* mreq, Time_t start);
+  using translatedCB = CallbackMember2<Tlb, MemRequest*, Time_t, &Tlb::translated>;
+
+public:
+  Tlb(Memory_system* current, const std::string& device_descr_section, const std::string& device_name = "");
+  ~Tlb() {}
+
+  // Entry points to schedule that may schedule a do?? if needed
+  void req(MemRequest* req) { doReq(req); };
+  void reqAck(MemRequest* req) { doReqAck(req); };
+  void setState(MemRequest* req) { doSetState(req); };
+  void setStateAck(MemRequest* req) { doSetStateAck(req); };
+  void disp(MemRequest* req) { doDisp(req); }
+
+  // This do the real work
+  void doReq(MemRequest* r);
+  void doReqAck(MemRequest* req);
+  void doSetState(MemRequest* req);
+  void doSetStateAck(MemRequest* req);
+  void doDisp(MemRequest* req);
+
+  TimeDelta_t ffread(Addr_t addr);
+  TimeDelta_t ffwrite(Addr_t addr);
+
+  void tryPrefetch(Addr_t addr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb = 0, Time_t age = 0);
+
+  bool isBusy(Addr_t addr) const;
+};
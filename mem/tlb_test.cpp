@@ -0,0 +1,174 @@
+// See LICENSE for details.
+
+#include <fstream>
+
+#include "callback.hpp"
+#include "config.hpp"
+#include "dinst.hpp"
+#include "gtest/gtest.h"
+#include "memobj.hpp"
+#include "memory_system.hpp"
+#include "memrequest.hpp"
+#include "report.hpp"
+
+static int    rd_pending = 0;
+static Time_t rd_done    = 0;
+
+static void rdDone(Dinst* dinst) {
+  rd_pending--;
+  rd_done = globalClock;
+  dinst->scrap();
+}
+
+using rdDoneCB = CallbackFunction1<Dinst*, &rdDone>;
+
+static void doread(MemObj* mobj, Addr_t addr) {
+  auto* ld = Dinst::create(Instruction(Opcode::iLALU_LD, RegType::LREG_R1, RegType::LREG_R2, RegType::LREG_R3, RegType::LREG_R4),
+                           0xdeaddead,
+                           addr,
+                           0,
+                           true);
+
+  while (mobj->isBusy(addr)) {
+    EventScheduler::advanceClock();
+  }
+
+  MemRequest::sendReqRead(mobj, ld->has_stats(), ld->getAddr(), ld->getPC(), rdDoneCB::create(ld, ld->getID()));
+  rd_pending++;
+}
+
+// Cycles to complete a read
+static Time_t timed_read(MemObj* mobj, Addr_t addr) {
+  doread(mobj, addr);
+  auto start = globalClock;
+  while (rd_pending) {
+    EventScheduler::advanceClock();
+  }
+  return rd_done - start;
+}
+
+static void setup_config() {
+  std::ofstream file;
+
+  file.open("tlb_test.toml");
+
+  file << "[soc]\n"
+          "core = [\"c0\"]\n"
+          "[c0]\n"
+          "type  = \"ooo\"\n"
+          "caches        = true\n"
+          "dl1           = \"dtlb DTLB\"\n"
+          "il1           = \"l1_cache IL1\"\n"
+          "[dtlb]\n"
+          "type        = \"tlb\"\n"
+          "size        = 4\n"
+          "assoc       = 4\n"
+          "delay       = 0\n"
+          "line_size   = 64\n"
+          "walker      = \"stlb STLB\"\n"
+          "lower_level = \"l1_cache DL1\"\n"
+          "[stlb]\n"
+          "type          = \"walker\"\n"
+          "size          = 16\n"
+          "assoc         = 4\n"
+          "delay         = 7\n"
+          "pwc_size      = 4\n"
+          "max_walks     = 1\n"
+          "huge_2m_ratio = 0\n"
+          "huge_1g_ratio = 0\n"
+          "lower_level   = \"l2_cache L2\"\n"
+          "[l1_cache]\n"
+          "type       = \"cache\"\n"
+          "cold_misses = true\n"
+          "size       = 32768\n"
+          "line_size  = 64\n"
+          "delay      = 2\n"
+          "miss_delay = 2\n"
+          "assoc      = 4\n"
+          "repl_policy = \"lru\"\n"
+          "port_occ   = 1\n"
+          "port_num   = 1\n"
+          "port_banks = 32\n"
+          "send_port_occ = 1\n"
+          "send_port_num = 1\n"
+          "max_requests  = 32\n"
+          "allocate_miss = true\n"
+          "victim        = false\n"
+          "coherent      = true\n"
+          "inclusive     = true\n"
+          "directory     = false\n"
+          "nlp_distance = 2\n"
+          "nlp_degree   = 0\n"
+          "nlp_stride   = 1\n"
+          "drop_prefetch = true\n"
+          "prefetch_degree = 0\n"
+          "mega_lines1K    = 0\n"
+          "lower_level = \"l2_cache L2\"\n"
+          "[l2_cache]\n"
+          "type       = \"nice\"\n"
+          "line_size  = 64\n"
+          "delay      = 11\n"
+          "cold_misses = false\n"
+          "lower_level = \"\"\n";
+
+  file.close();
+}
+
+class Tlb_test : public ::testing::Test {
+protected:
+  static inline MemObj* dtlb = nullptr;
+
+  static void SetUpTestSuite() {
+    setup_config();
+
+    Report::init();
+    Config::init("tlb_test.toml");
+
+    auto* gms = new Memory_system(0);
+    Config::exit_on_error();
+    EventScheduler::advanceClock();
+
+    dtlb = gms->getDL1();
+  }
+
+  static double cntr(const std::string& name) { return Stats::get_cntr(name); }
+};
+
+TEST_F(Tlb_test, miss_walk_hit) {
+  ASSERT_EQ(dtlb->get_type(), "tlb");
+
+  auto miss_lat = timed_read(dtlb, 0x1000040);  // TLB, L2 TLB and cache miss
+  EXPECT_EQ(cntr("DTLB(0):nMiss"), 1);
+  EXPECT_EQ(cntr("STLB(0):nMiss"), 1);
+  EXPECT_EQ(cntr("STLB(0):nWalk4K"), 1);
+  EXPECT_EQ(cntr("STLB(0):nPTERead"), 4);  // all the levels, empty walk caches
+
+  auto hit_lat = timed_read(dtlb, 0x1000040);  // TLB and cache hit
+  EXPECT_EQ(cntr("DTLB(0):nHit"), 1);
+  EXPECT_EQ(cntr("STLB(0):nPTERead"), 4);
+  EXPECT_GT(miss_lat, hit_lat + 7);  // at least the L2 TLB delay plus the walk
+}
+
+TEST_F(Tlb_test, walk_cache) {
+  timed_read(dtlb, 0x2000000);
+  auto reads = cntr("STLB(0):nPTERead");
+  auto pwc   = cntr("STLB(0):nPWCHit");
+
+  // Same 2M region, another 4K page: the walk starts from the last level
+  timed_read(dtlb, 0x2001000);
+  EXPECT_EQ(cntr("STLB(0):nPWCHit"), pwc + 1);
+  EXPECT_EQ(cntr("STLB(0):nPTERead"), reads + 1);
+}
+
+TEST_F(Tlb_test, merged_walk) {
+  auto walks = cntr("STLB(0):nWalk4K");
+
+  doread(dtlb, 0x3000000);
+  doread(dtlb, 0x3000080);  // same page, waits for the same walk
+  while (rd_pending) {
+    EventScheduler::advanceClock();
+  }
+
+  EXPECT_EQ(cntr("STLB(0):nMerged"), 1);
+  EXPECT_EQ(cntr("STLB(0):nWalk4K"), walks + 1);
+}
@@ -0,0 +1,229 @@
+// See LICENSE for details.
+
+#include "interconn.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include "config.hpp"
+#include "fmt/format.h"
+#include "iassert.hpp"
+
+InterConnection::InterConnection(const std::string& section, const std::string& _name)
+    /* constructor {{{1 */
+    : name(_name)
+    , policy(Routing_policy::create(section))
+    , routerDelay(Config::get_integer(section, "router_delay", 1, 64))
+    , linkDelay(Config::get_integer(section, "link_delay", 1, 64))
+    , creditDelay(Config::get_integer(section, "credit_delay", 0, 64))
+    , bufferFlits(Config::get_integer(section, "buffer_flits", 1, 1024))
+    , flitBytes(Config::get_power2(section, "flit_bytes", 1, 1024))
+    , numPorts(policy->get_num_ports())
+    , numVCs(Msg_class_max * policy->get_num_datelines())
+    , nPackets(fmt::format("{}:nPackets", name))
+    , nFlits(fmt::format("{}:nFlits", name))
+    , nLinkFlits(fmt::format("{}:nLinkFlits", name))
+    , nCreditStall(fmt::format("{}:nCreditStall", name))
+    , avgLatency(fmt::format("{}_avgLatency", name))
+    , avgHops(fmt::format("{}_avgHops", name))
+    , avgContention(fmt::format("{}_avgContention", name)) {
+  auto nrouters = policy->get_num_routers();
+
+  routers.resize(nrouters);
+  for (auto& router : routers) {
+    router.inject.resize(numVCs);
+    router.eject_busy = 0;
+    router.wake_at    = std::numeric_limits<Time_t>::max();
+    router.rr         = 0;
+  }
+
+  links.resize(static_cast<size_t>(nrouters) * numPorts);
+  for (auto r = 0u; r < nrouters; ++r) {
+    for (auto p = 0u; p < numPorts; ++p) {
+      auto  id   = r * numPorts + p;
+      auto& link = links[id];
+
+      link.dst        = policy->get_neighbor(r, p);
+      link.busy_until = 0;
+      link.credits.resize(numVCs, bufferFlits);
+      link.buffer.resize(numVCs);
+
+      if (link.dst != Routing_policy::NO_ROUTER) {
+        routers[link.dst].in_links.push_back(id);
+      }
+    }
+  }
+}
+/* }}} */
+
+InterConnection::~InterConnection() {
+  for (auto& router : routers) {
+    for (auto& q : router.inject) {
+      for (auto* p : q) {
+        packetPool.in(p);
+      }
+    }
+  }
+  for (auto& link : links) {
+    for (auto& q : link.buffer) {
+      for (auto* p : q) {
+        packetPool.in(p);
+      }
+    }
+  }
+}
+
+TimeDelta_t InterConnection::get_zero_load_latency(uint32_t src, uint32_t dst, uint16_t flits) const {
+  return routerDelay + policy->get_hops(src, dst) * (linkDelay + routerDelay) + flits;
+}
+
+TimeDelta_t InterConnection::get_max_zero_load_latency(uint16_t flits) const {
+  return routerDelay + policy->get_diameter() * (linkDelay + routerDelay) + flits;
+}
+
+void InterConnection::send(uint32_t src, uint32_t dst, uint16_t flits, Msg_class cls, CallbackBase* cb, bool en)
+/* inject a packet at router src {{{1 */
+{
+  I(src < routers.size());
+  I(dst < routers.size());
+  I(flits > 0 && flits <= bufferFlits);  // virtual cut-through needs the whole packet to fit
+
+  auto* p     = packetPool.out();
+  p->cb       = cb;
+  p->injected = globalClock;
+  p->ready    = globalClock + routerDelay;
+  p->dst      = dst;
+  p->hops     = 0;
+  p->flits    = flits;
+  p->cls      = cls;
+  p->state    = 0;
+  p->en       = en;
+
+  routers[src].inject[get_vc(cls, 0)].push_back(p);
+  wake(src, p->ready);
+}
+/* }}} */
+
+void InterConnection::wake(uint32_t r, Time_t when) {
+  auto& router = routers[r];
+  if (router.wake_at <= when) {
+    return;  // an earlier arbitration reschedules itself if there is work left
+  }
+  router.wake_at = when;
+  ArbitrateCB::scheduleAbs(when, this, r);
+}
+
+void InterConnection::eject(uint32_t r, Packet* p)
+/* tail flit reaches the destination {{{1 */
+{
+  auto& router      = routers[r];
+  router.eject_busy = globalClock + p->flits;
+
+  auto lat = router.eject_busy - p->injected;
+  nPackets.inc(p->en);
+  nFlits.add(p->flits, p->en);
+  avgLatency.sample(lat, p->en);
+  avgHops.sample(p->hops, p->en);
+  avgContention.sample(lat - (routerDelay + p->hops * (linkDelay + routerDelay) + p->flits), p->en);
+
+  if (p->cb) {
+    p->cb->schedule(p->flits);
+  }
+  packetPool.in(p);
+}
+/* }}} */
+
+void InterConnection::arbitrate(uint32_t r)
+/* move the head packet of each input VC that can make progress {{{1 */
+{
+  auto& router = routers[r];
+  if (router.wake_at != globalClock) {
+    return;  // stale event
+  }
+  router.wake_at = std::numeric_limits<Time_t>::max();
+
+  const Time_t now  = globalClock;
+  Time_t       next = std::numeric_limits<Time_t>::max();
+
+  auto ninputs = router.in_links.size() + 1;  // last input is the network interface
+  for (auto k = 0u; k < ninputs; ++k) {
+    auto in_pos  = (router.rr + k) % ninputs;
+    bool is_link = in_pos < router.in_links.size();
+    auto& queues = is_link ? links[router.in_links[in_pos]].buffer : router.inject;
+
+    for (auto vc = 0u; vc < numVCs; ++vc) {
+      auto& q = queues[vc];
+      if (q.empty()) {
+        continue;
+      }
+      auto* p = q.front();
+      if (p->ready > now) {
+        next = std::min(next, p->ready);
+        continue;
+      }
+
+      auto flits = p->flits;
+      if (p->dst == r) {
+        if (router.eject_busy > now) {
+          next = std::min(next, router.eject_busy);
+          continue;
+        }
+        q.pop_front();
+        eject(r, p);
+      } else {
+        auto  state = p->state;
+        auto  port  = policy->route(r, p->dst, &state);
+        auto  nvc   = get_vc(p->cls, state);
+        auto& out   = links[r * numPorts + port];
+        I(out.dst != Routing_policy::NO_ROUTER);
+
+        if (out.busy_until > now) {
+          next = std::min(next, out.busy_until);
+          continue;
+        }
+        if (out.credits[nvc] < flits) {
+          nCreditStall.inc(p->en);
+          continue;  // return_credit wakes this router
+        }
+
+        q.pop_front();
+        out.credits[nvc] -= flits;
+        out.busy_until = now + flits;
+        nLinkFlits.add(flits, p->en);
+
+        p->state = state;
+        p->ready = now + linkDelay + routerDelay;
+        p->hops++;
+        out.buffer[nvc].push_back(p);
+        wake(out.dst, p->ready);
+      }
+
+      if (is_link) {
+        // The tail leaves this buffer after flits cycles; the upstream router gets the credits back later
+        uint64_t packed = (static_cast<uint64_t>(router.in_links[in_pos]) << 24) | (static_cast<uint64_t>(vc) << 16) | flits;
+        ReturnCreditCB::schedule(flits + creditDelay, this, packed);
+      }
+      if (!q.empty()) {
+        next = std::min(next, now + flits);  // one packet per input VC at a time
+      }
+    }
+  }
+  router.rr = (router.rr + 1) % ninputs;
+
+  if (next != std::numeric_limits<Time_t>::max()) {
+    wake(r, next);
+  }
+}
+/* }}} */
+
+void InterConnection::return_credit(uint64_t packed) {
+  auto link_id = static_cast<uint32_t>(packed >> 24);
+  auto vc      = static_cast<uint32_t>((packed >> 16) & 0xFF);
+  auto flits   = static_cast<int32_t>(packed & 0xFFFF);
+
+  auto& link = links[link_id];
+  link.credits[vc] += flits;
+  I(link.credits[vc] <= static_cast<int32_t>(bufferFlits));
+
+  wake(link_id / numPorts, globalClock);
+}
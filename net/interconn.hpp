@@ -0,0 +1,114 @@
+// See LICENSE for details.
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "callback.hpp"
+#include "pool.hpp"
+#include "routing_policy.hpp"
+#include "stats.hpp"
+
+// Packet level network with virtual cut-through and credit based flow
+// control. Each router input buffer has buffer_flits of space per virtual
+// channel; a packet only leaves a router when the downstream buffer has room
+// for all its flits and the output link is free. Credits return to the
+// upstream router credit_delay cycles after the tail flit leaves a buffer.
+//
+// There are two message classes (request and response) with their own VCs,
+// times the number of datelines of the topology. Ejection always accepts,
+// so requests can not block responses.
+//
+// Per hop cost: router_delay + link_delay, plus one cycle per flit on each
+// link (serialization). The callback passed to send() is scheduled when the
+// tail flit is ejected at the destination.
+class InterConnection {
+public:
+  enum Msg_class : uint8_t { Request = 0, Response, Msg_class_max };
+
+  InterConnection(const std::string& section, const std::string& name);
+  ~InterConnection();
+
+  void send(uint32_t src, uint32_t dst, uint16_t flits, Msg_class cls, CallbackBase* cb, bool en);
+
+  [[nodiscard]] uint32_t get_num_routers() const { return policy->get_num_routers(); }
+  [[nodiscard]] uint32_t get_flit_bytes() const { return flitBytes; }
+  [[nodiscard]] uint32_t get_buffer_flits() const { return bufferFlits; }
+  [[nodiscard]] uint16_t get_flits(uint32_t bytes) const { return static_cast<uint16_t>((bytes + flitBytes - 1) / flitBytes); }
+
+  [[nodiscard]] TimeDelta_t get_zero_load_latency(uint32_t src, uint32_t dst, uint16_t flits) const;
+  [[nodiscard]] TimeDelta_t get_max_zero_load_latency(uint16_t flits) const;
+
+  [[nodiscard]] const Routing_policy* get_policy() const { return policy.get(); }
+
+  void arbitrate(uint32_t r);
+  void return_credit(uint64_t packed);
+
+  using ArbitrateCB    = CallbackMember1<InterConnection, uint32_t, &InterConnection::arbitrate>;
+  using ReturnCreditCB = CallbackMember1<InterConnection, uint64_t, &InterConnection::return_credit>;
+
+protected:
+  class Packet {
+  public:
+    CallbackBase* cb;
+    Time_t        injected;
+    Time_t        ready;  // head flit can be routed
+    uint32_t      dst;
+    uint32_t      hops;
+    uint16_t      flits;
+    uint8_t       cls;
+    uint8_t       state;  // Routing_policy::route() state
+    bool          en;
+  };
+  static inline pool<Packet> packetPool{1024, "InterConnection::Packet"};
+
+  class Link {
+  public:
+    uint32_t                           dst;  // downstream router, NO_ROUTER if not wired
+    Time_t                             busy_until;
+    std::vector<int32_t>               credits;  // per VC, free flits in the downstream buffer
+    std::vector<std::deque<Packet*>>   buffer;   // per VC, the downstream input buffer
+  };
+
+  class Router {
+  public:
+    std::vector<uint32_t>            in_links;
+    std::vector<std::deque<Packet*>> inject;  // per VC, network interface queue (unbounded)
+    Time_t                           eject_busy;
+    Time_t                           wake_at;
+    uint32_t                         rr;  // round robin input pointer
+  };
+
+  const std::string name;
+
+  std::unique_ptr<Routing_policy> policy;
+
+  const TimeDelta_t routerDelay;
+  const TimeDelta_t linkDelay;
+  const TimeDelta_t creditDelay;
+  const uint32_t    bufferFlits;
+  const uint32_t    flitBytes;
+  const uint8_t     numPorts;
+  const uint8_t     numVCs;
+
+  std::vector<Link>   links;  // router * numPorts + port
+  std::vector<Router> routers;
+
+  Stats_cntr nPackets;
+  Stats_cntr nFlits;
+  Stats_cntr nLinkFlits;
+  Stats_cntr nCreditStall;
+  Stats_avg  avgLatency;
+  Stats_avg  avgHops;
+  Stats_avg  avgContention;  // latency over the zero load latency
+
+  [[nodiscard]] uint8_t get_vc(uint8_t cls, uint8_t state) const {
+    return cls * policy->get_num_datelines() + (state & Routing_policy::DATELINE);
+  }
+
+  void wake(uint32_t r, Time_t when);
+  void eject(uint32_t r, Packet* p);
+};
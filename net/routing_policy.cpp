@@ -0,0 +1,163 @@
+// See LICENSE for details.
+
+#include "routing_policy.hpp"
+
+#include <algorithm>
+
+#include "config.hpp"
+#include "fmt/format.h"
+#include "iassert.hpp"
+
+/*********************** Routing_policy */
+
+uint32_t Routing_policy::get_hops(uint32_t src, uint32_t dst) const {
+  uint32_t hops  = 0;
+  uint8_t  state = 0;
+  while (src != dst) {
+    auto port = route(src, dst, &state);
+    src       = get_neighbor(src, port);
+    I(src != NO_ROUTER);
+    ++hops;
+  }
+  return hops;
+}
+
+void Routing_policy::compute_diameter() {
+  diameter = 0;
+  for (auto src = 0u; src < num_routers; ++src) {
+    for (auto dst = 0u; dst < num_routers; ++dst) {
+      diameter = std::max(diameter, get_hops(src, dst));
+    }
+  }
+}
+
+std::unique_ptr<Routing_policy> Routing_policy::create(const std::string& section) {
+  auto topology = Config::get_string(section, "topology", {"mesh", "torus", "ring", "uniring", "fully"});
+  auto width    = Config::get_integer(section, "width", 1, 256);
+  auto height   = 1;
+  if (topology == "mesh" || topology == "torus") {
+    height = Config::get_integer(section, "height", 1, 256);
+  }
+  if (topology == "fully" && width > 256) {
+    Config::add_error(fmt::format("fully connected network in section:{} is limited to 256 routers", section));
+    width = 256;
+  }
+
+  if (topology == "mesh") {
+    return std::make_unique<Mesh_routing_policy>(width, height, false);
+  } else if (topology == "torus") {
+    return std::make_unique<Mesh_routing_policy>(width, height, true);
+  } else if (topology == "ring") {
+    return std::make_unique<Mesh_routing_policy>(width, 1, true);
+  } else if (topology == "uniring") {
+    return std::make_unique<Uniring_routing_policy>(width);
+  }
+  return std::make_unique<Fully_connected_routing_policy>(width);
+}
+
+/*********************** Mesh_routing_policy */
+
+Mesh_routing_policy::Mesh_routing_policy(uint32_t w, uint32_t h, bool _wrap)
+    : Routing_policy(w * h, 4, _wrap ? 2 : 1), width(w), height(h), wrap(_wrap) {
+  compute_diameter();
+}
+
+uint32_t Mesh_routing_policy::get_neighbor(uint32_t r, uint8_t port) const {
+  auto x = r % width;
+  auto y = r / width;
+
+  switch (port) {
+    case East:
+      if (x + 1 < width) {
+        return r + 1;
+      }
+      return (wrap && width > 1) ? r + 1 - width : NO_ROUTER;
+    case West:
+      if (x > 0) {
+        return r - 1;
+      }
+      return (wrap && width > 1) ? r + width - 1 : NO_ROUTER;
+    case North:
+      if (y + 1 < height) {
+        return r + width;
+      }
+      return (wrap && height > 1) ? x : NO_ROUTER;
+    case South:
+      if (y > 0) {
+        return r - width;
+      }
+      return (wrap && height > 1) ? r + width * (height - 1) : NO_ROUTER;
+    default: I(0);
+  }
+  return NO_ROUTER;
+}
+
+uint8_t Mesh_routing_policy::route_dim(uint32_t pos, uint32_t dpos, uint32_t size, uint8_t plus, uint8_t* state) const {
+  I(pos != dpos);
+  uint8_t minus = plus + 1;
+
+  if (!wrap) {
+    return dpos > pos ? plus : minus;
+  }
+
+  // Shortest direction, ties go plus. Crossing the wraparound link moves to the second dateline VC
+  auto fwd = (dpos + size - pos) % size;
+  if (fwd <= size - fwd) {
+    if (pos == size - 1) {
+      *state |= DATELINE;
+    }
+    return plus;
+  }
+  if (pos == 0) {
+    *state |= DATELINE;
+  }
+  return minus;
+}
+
+uint8_t Mesh_routing_policy::route(uint32_t cur, uint32_t dst, uint8_t* state) const {
+  I(cur != dst);
+
+  auto x  = cur % width;
+  auto dx = dst % width;
+  if (x != dx) {
+    I(!(*state & DIM_Y));
+    return route_dim(x, dx, width, East, state);
+  }
+
+  if (!(*state & DIM_Y)) {
+    *state = DIM_Y;  // turn to Y, back to the first dateline VC
+  }
+  return route_dim(cur / width, dst / width, height, North, state);
+}
+
+/*********************** Uniring_routing_policy */
+
+uint32_t Uniring_routing_policy::get_neighbor(uint32_t r, uint8_t port) const {
+  I(port == 0);
+  (void)port;
+  return (r + 1) % num_routers;
+}
+
+uint8_t Uniring_routing_policy::route(uint32_t cur, uint32_t dst, uint8_t* state) const {
+  I(cur != dst);
+  (void)dst;
+  if (cur == num_routers - 1) {
+    *state |= DATELINE;
+  }
+  return 0;
+}
+
+/*********************** Fully_connected_routing_policy */
+
+Fully_connected_routing_policy::Fully_connected_routing_policy(uint32_t routers)
+    : Routing_policy(routers, static_cast<uint8_t>(routers - 1), 1) {
+  compute_diameter();
+}
+
+uint32_t Fully_connected_routing_policy::get_neighbor(uint32_t r, uint8_t port) const { return (r + 1 + port) % num_routers; }
+
+uint8_t Fully_connected_routing_policy::route(uint32_t cur, uint32_t dst, uint8_t* state) const {
+  I(cur != dst);
+  (void)state;
+  return static_cast<uint8_t>((dst + num_routers - cur - 1) % num_routers);
+}
@@ -0,0 +1,91 @@
+// See LICENSE for details.
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+
+// Topology and routing function of an InterConnection. Routers are numbered
+// 0..num_routers-1 and each one has num_ports network output ports (the
+// local ejection port is not counted). Routing is deterministic, so a
+// packet from A to B always follows the same path.
+//
+// Deadlock freedom: mesh uses XY dimension order routing; torus and rings
+// also need a dateline, so packets move to the second dateline VC after
+// crossing a wraparound link (the dateline VC is reset when the packet turns
+// to the Y dimension).
+class Routing_policy {
+public:
+  static constexpr uint32_t NO_ROUTER = std::numeric_limits<uint32_t>::max();
+
+  // route() state: bit0 is the dateline VC, bit1 is set once the packet routes in Y
+  static constexpr uint8_t DATELINE = 1;
+  static constexpr uint8_t DIM_Y    = 2;
+
+  virtual ~Routing_policy() = default;
+
+  [[nodiscard]] uint32_t get_num_routers() const { return num_routers; }
+  [[nodiscard]] uint8_t  get_num_ports() const { return num_ports; }
+  [[nodiscard]] uint8_t  get_num_datelines() const { return num_datelines; }
+
+  // Router connected to the output port (NO_ROUTER if the port is not wired)
+  [[nodiscard]] virtual uint32_t get_neighbor(uint32_t r, uint8_t port) const = 0;
+
+  // Output port at cur for a packet going to dst (cur != dst). state starts at 0
+  [[nodiscard]] virtual uint8_t route(uint32_t cur, uint32_t dst, uint8_t* state) const = 0;
+
+  [[nodiscard]] uint32_t get_hops(uint32_t src, uint32_t dst) const;
+  [[nodiscard]] uint32_t get_diameter() const { return diameter; }
+
+  static std::unique_ptr<Routing_policy> create(const std::string& section);
+
+protected:
+  Routing_policy(uint32_t routers, uint8_t ports, uint8_t datelines)
+      : num_routers(routers), num_ports(ports), num_datelines(datelines), diameter(0) {}
+
+  const uint32_t num_routers;
+  const uint8_t  num_ports;
+  const uint8_t  num_datelines;
+  uint32_t       diameter;
+
+  void compute_diameter();
+};
+
+// 2D mesh (wrap=false) or torus (wrap=true). A torus with height 1 is a
+// bidirectional ring. Ports: 0 east (+x), 1 west (-x), 2 north (+y), 3 south (-y)
+class Mesh_routing_policy : public Routing_policy {
+public:
+  enum Port : uint8_t { East = 0, West, North, South };
+
+  Mesh_routing_policy(uint32_t width, uint32_t height, bool wrap);
+
+  [[nodiscard]] uint32_t get_neighbor(uint32_t r, uint8_t port) const override;
+  [[nodiscard]] uint8_t  route(uint32_t cur, uint32_t dst, uint8_t* state) const override;
+
+private:
+  const uint32_t width;
+  const uint32_t height;
+  const bool     wrap;
+
+  [[nodiscard]] uint8_t route_dim(uint32_t pos, uint32_t dpos, uint32_t size, uint8_t plus, uint8_t* state) const;
+};
+
+// Unidirectional ring, single output port towards r+1
+class Uniring_routing_policy : public Routing_policy {
+public:
+  explicit Uniring_routing_policy(uint32_t routers) : Routing_policy(routers, 1, 2) { compute_diameter(); }
+
+  [[nodiscard]] uint32_t get_neighbor(uint32_t r, uint8_t port) const override;
+  [[nodiscard]] uint8_t  route(uint32_t cur, uint32_t dst, uint8_t* state) const override;
+};
+
+// Every router has a direct link to every other router. Port p goes to r+1+p
+class Fully_connected_routing_policy : public Routing_policy {
+public:
+  explicit Fully_connected_routing_policy(uint32_t routers);
+
+  [[nodiscard]] uint32_t get_neighbor(uint32_t r, uint8_t port) const override;
+  [[nodiscard]] uint8_t  route(uint32_t cur, uint32_t dst, uint8_t* state) const override;
+};
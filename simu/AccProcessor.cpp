@@ -4,6 +4,8 @@
 
 #include <math.h>
 
+#include <fstream>
+
 #include "config.hpp"
 #include "fmt/format.h"
 #include "gmemory_system.hpp"
@@ -12,13 +14,72 @@
 AccProcessor::AccProcessor(std::shared_ptr<Gmemory_system> gm, Hartid_t i)
     /* constructor {{{1 */
     : Simu_base(gm, i)
-    , myAddr((i + 1) * 128 * 1024)
-    , addrIncr(Config::get_integer("soc", "core", i, "addr_incr"))
+    , addrBase(Config::has_entry("soc", "core", i, "addr_base") ? Config::get_integer("soc", "core", i, "addr_base", 0)
+                                                                 : (i + 1) * 128 * 1024)
+    , footprint(Config::get_power2("soc", "core", i, "footprint", 64, 1 << 30))
+    , lineSize(Config::get_integer(gm->getDL1()->getSection(), "line_size"))
+    , writeRatio(Config::get_integer("soc", "core", i, "write_ratio", 0, 100))
+    , maxOutstanding(Config::get_integer("soc", "core", i, "max_outstanding", 1, 65536))
+    , interval(Config::get_integer("soc", "core", i, "interval", 1, 1 << 20))
+    , burst(Config::get_integer("soc", "core", i, "burst", 1, 65536))
+    , maxRequests(Config::get_integer("soc", "core", i, "requests", 0))
+    , nextStream(0)
+    , tracePos(0)
+    , rng(Config::get_integer("soc", "core", i, "seed", 0) + i)
     , reqid(0)
+    , outstanding_accesses(0)
+    , windowDone(0)
     , accReads(fmt::format("P({})_acc_reads", i))
     , accWrites(fmt::format("P({})_acc_writes", i))
+    , accStallOutstanding(fmt::format("P({})_acc_stall_outstanding", i))
     , accReadLatency(fmt::format("P({})_acc_ave_read_latency", i))
-    , accWriteLatency(fmt::format("P({})_acc_ave_write_latency", i)) {}
+    , accWriteLatency(fmt::format("P({})_acc_ave_write_latency", i))
+    , accReadLatencyHist(fmt::format("P({})_acc_read_latency", i))
+    , accWriteLatencyHist(fmt::format("P({})_acc_write_latency", i))
+    , accBandwidth(fmt::format("P({})_acc_bandwidth", i))
+    , bwWindow(Config::get_integer("soc", "core", i, "bw_window", 1, 1 << 24)) {
+  auto p = Config::get_string("soc", "core", i, "pattern", {"stream", "strided", "random", "hotspot", "trace"});
+
+  stride       = lineSize;
+  hotspotSize  = 0;
+  hotspotRatio = 0;
+  if (p == "stream") {
+    pattern = Pattern::stream;
+    streamPos.push_back(0);
+  } else if (p == "strided") {
+    pattern    = Pattern::strided;
+    stride     = Config::get_integer("soc", "core", i, "stride", 1, 1 << 24);
+    auto nstrm = Config::get_integer("soc", "core", i, "nstreams", 1, 1024);
+    for (auto s = 0; s < nstrm; ++s) {
+      streamPos.push_back((footprint / nstrm * s) & ~(lineSize - 1));
+    }
+  } else if (p == "random") {
+    pattern = Pattern::random;
+  } else if (p == "hotspot") {
+    pattern      = Pattern::hotspot;
+    hotspotSize  = Config::get_power2("soc", "core", i, "hotspot_size", 64, 1 << 30);
+    hotspotRatio = Config::get_integer("soc", "core", i, "hotspot_ratio", 0, 100);
+    if (hotspotSize > footprint) {
+      Config::add_error(fmt::format("core {} hotspot_size {} is larger than footprint {}", i, hotspotSize, footprint));
+    }
+  } else {
+    pattern = Pattern::trace;
+
+    auto          fname = Config::get_string("soc", "core", i, "trace_file");
+    std::ifstream ifs(fname, std::ios::binary);
+    if (!ifs) {
+      Config::add_error(fmt::format("core {} could not open trace_file {}", i, fname));
+    } else {
+      uint64_t rec;
+      while (ifs.read(reinterpret_cast<char*>(&rec), sizeof(rec))) {
+        trace.push_back(rec);
+      }
+      if (trace.empty()) {
+        Config::add_error(fmt::format("core {} trace_file {} has no addresses", i, fname));
+      }
+    }
+  }
+}
 /* }}} */
 
 AccProcessor::~AccProcessor()
@@ -28,12 +89,85 @@ AccProcessor::~AccProcessor()
 }
 /* }}} */
 
+Addr_t AccProcessor::random_offset(Addr_t range) { return rng() & (range - 1) & ~(lineSize - 1); }
+
+bool AccProcessor::next_access(Addr_t& addr, bool& write)
+/* address and type of the next request, false when done {{{1 */
+{
+  if (maxRequests && reqid >= maxRequests) {
+    return false;
+  }
+
+  if (pattern == Pattern::trace) {
+    if (tracePos >= trace.size()) {
+      return false;
+    }
+    auto rec = trace[tracePos++];
+    write    = rec & 1;
+    addr     = rec & ~static_cast<uint64_t>(1);
+    return true;
+  }
+
+  write = (rng() % 100) < writeRatio;
+
+  Addr_t offset = 0;
+  switch (pattern) {
+    case Pattern::stream:
+    case Pattern::strided: {
+      auto& pos  = streamPos[nextStream];
+      offset     = pos;
+      pos        = (pos + stride) & (footprint - 1);
+      nextStream = (nextStream + 1) % streamPos.size();
+    } break;
+    case Pattern::random: offset = random_offset(footprint); break;
+    case Pattern::hotspot:
+      if ((rng() % 100) < hotspotRatio) {
+        offset = random_offset(hotspotSize);
+      } else {
+        offset = random_offset(footprint);
+      }
+      break;
+    default: I(false);
+  }
+
+  addr = addrBase + offset;
+  return true;
+}
+/* }}} */
+
+void AccProcessor::inject() {
+  for (auto n = 0u; n < burst; ++n) {
+    if (outstanding_accesses >= maxOutstanding) {
+      accStallOutstanding.inc(true);
+      return;
+    }
+
+    Addr_t addr;
+    bool   write;
+    if (!next_access(addr, write)) {
+      return;
+    }
+
+    outstanding_accesses++;
+    if (write) {
+      MemRequest::sendReqWrite(memorySystem->getDL1(), true, addr, 0, write_performedCB::create(this, reqid++, globalClock));
+    } else {
+      MemRequest::sendReqRead(memorySystem->getDL1(), true, addr, 0, read_performedCB::create(this, reqid++, globalClock));
+    }
+  }
+}
+
 void AccProcessor::read_performed(uint32_t id, Time_t startTime)
 // {{{1 callback for completed reads
 {
   (void)id;
+  I(outstanding_accesses > 0);
+  outstanding_accesses--;
+  windowDone++;
+
   accReads.inc(true);
   accReadLatency.sample(globalClock - startTime, true);
+  accReadLatencyHist.sample(static_cast<int32_t>(globalClock - startTime), true);
 }
 /* }}} */
 
@@ -41,8 +175,13 @@ void AccProcessor::write_performed(uint32_t id, Time_t startTime)
 // {{{1 callback for completed writes
 {
   (void)id;
+  I(outstanding_accesses > 0);
+  outstanding_accesses--;
+  windowDone++;
+
   accWrites.inc(true);
   accWriteLatency.sample(globalClock - startTime, true);
+  accWriteLatencyHist.sample(static_cast<int32_t>(globalClock - startTime), true);
 }
 /* }}} */
 
@@ -57,16 +196,13 @@ bool AccProcessor::advance_clock_drain() {
 }
 
 bool AccProcessor::advance_clock() {
-  if (globalClock > 500 && ((globalClock % 10) == (hid))) {
-    if (reqid & 1) {
-      MemRequest::sendReqWrite(memorySystem->getDL1(),
-                               true,
-                               myAddr += addrIncr,
-                               0,
-                               write_performedCB::create(this, reqid++, globalClock));
-    } else {
-      MemRequest::sendReqRead(memorySystem->getDL1(), true, myAddr, 0, read_performedCB::create(this, reqid++, globalClock));
-    }
+  if (globalClock > 500 && ((globalClock % interval) == (hid % interval))) {
+    inject();
+  }
+
+  if ((globalClock % bwWindow) == 0) {
+    accBandwidth.sample(static_cast<int32_t>(windowDone), true);
+    windowDone = 0;
   }
 
   return advance_clock_drain();
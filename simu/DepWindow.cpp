@@ -2,6 +2,9 @@
 
 #include "depwindow.hpp"
 
+#include <algorithm>
+#include <bit>
+
 #include "config.hpp"
 #include "dinst.hpp"
 #include "fmt/format.h"
@@ -10,16 +13,38 @@
 #include "tracer.hpp"
 
 DepWindow::DepWindow(uint32_t cpuid, int src_id, const std::string& clusterName, uint32_t pos)
-    : src_cluster_id(src_id), inter_cluster_fwd(fmt::format("P({})_{}{}_inter_cluster_fwd", cpuid, clusterName, pos)) {
+    : cpu_id(cpuid), src_cluster_id(src_id), inter_cluster_fwd(fmt::format("P({})_{}{}_inter_cluster_fwd", cpuid, clusterName, pos)) {
   auto cadena    = fmt::format("P(P{}_{}{}_sched", cpuid, clusterName, pos);
   auto sched_num = Config::get_integer(clusterName, "sched_num");
-  schedPort      = PortGeneric::create(cadena, sched_num, /*priority_managed=*/true);
+
+  readySelect = nullptr;
+  if (Config::has_entry(clusterName, "sched_bitvector") && Config::get_bool(clusterName, "sched_bitvector")) {
+    auto m      = std::make_shared<Ready_select>(fmt::format("{}_occ", cadena),
+                                            sched_num,
+                                            [this](Time_t when, Dinst* dinst) { do_schedule(when, dinst); });
+    readySelect = m.get();
+    schedPort   = m;
+    EventScheduler::register_drain_port(readySelect);
+
+    wakeupMatrix = std::make_unique<Wakeup_matrix>();
+  } else {
+    schedPort = PortGeneric::create(cadena, sched_num, /*priority_managed=*/true);
+  }
+
+  if (core_windows.size() <= cpuid) {
+    core_windows.resize(cpuid + 1);
+  }
+  auto& windows = core_windows[cpuid];
+  if (!windows.empty() && (windows.front()->wakeupMatrix == nullptr) != (wakeupMatrix == nullptr)) {
+    Config::add_error(fmt::format("core {} cluster {} sched_bitvector must match the other clusters of the core", cpuid, clusterName));
+  }
+  windows.push_back(this);
 
   sched_lat         = Config::get_integer(clusterName, "sched_lat", 0, 32);
   inter_cluster_lat = Config::get_integer("soc", "core", cpuid, "inter_cluster_lat");
 }
 
-DepWindow::~DepWindow() {}
+DepWindow::~DepWindow() { std::erase(core_windows[cpu_id], this); }
 
 StallCause DepWindow::canIssue(Dinst* dinst) const {
   (void)dinst;
@@ -33,6 +58,8 @@ void DepWindow::add_inst(Dinst* dinst) {
   if (!dinst->hasDeps()) {
     dinst->set_in_cluster();
     preSelect(dinst);
+  } else if (wakeupMatrix) {
+    wakeupMatrix->add(dinst);
   }
 }
 
@@ -53,6 +80,10 @@ void DepWindow::preSelect(Dinst* dinst) {
 }
 
 void DepWindow::select(Dinst* dinst) {
+  if (readySelect) {
+    readySelect->add(dinst);
+    return;
+  }
   schedPort->schedule(dinst->has_stats(),
                       dinst->getID(),
                       dinst->isTransient(),
@@ -81,7 +112,7 @@ void DepWindow::do_schedule(Time_t when, Dinst* dinst) {
   I(src_cluster_id == dinst->getCluster()->get_id());
   // only diff is the resource::receiving::schedTime same
   printf("DepWindow:::do_shedule:: Sendingto  execution Inst %lu at clock cycle %lu\n", dinst->getID(), globalClock);
-  Resource::executingCB::scheduleAbs(schedTime, dinst->getClusterResource().get(), dinst, dinst->getID());
+  Resource::executingCB::scheduleAbs(schedTime, dinst->getClusterResource(), dinst, dinst->getID());
 }
 
 void DepWindow::executed_flushed(Dinst* dinst) {
@@ -136,44 +167,445 @@ void DepWindow::executed(Dinst* dinst) {
     return;
   }*/
 
+  if (wakeupMatrix) {
+    woken.clear();
+    for (auto* w : core_windows[cpu_id]) {
+      w->wakeupMatrix->wakeup(dinst, woken);
+    }
+    dinst->flush_first();  // every consumer link was dropped by its matrix
+
+    for (auto* dstReady : woken) {
+      wakeup_ready(dstReady);
+    }
+    return;
+  }
+
   while (dinst->hasPending()) {
     Dinst* dstReady = dinst->getNextPending();
     I(dstReady);
-    if (dstReady->is_to_be_destroyed() && !dstReady->hasDeps()) {
-      // dstReady->clear_to_be_destroyed_transient();
-      dstReady->destroyTransientInst();
-      continue;
+    if (!dstReady->hasDeps()) {
+      wakeup_ready(dstReady);
     }
+  }
+  // printf("DepWindow::Executed:: Leaving  executed for instID %llu at @Clockcycle %llu\n", dinst->getID(), globalClock);
 
-    I(!dstReady->isExecuted());
+  // dinst->flushfirst();//parent->first=0
+}
 
-    if (!dstReady->hasDeps()) {
-      // Check dstRes because dstReady may not be issued
-      I(dstReady->getCluster());
-      auto dst_cluster_id = dstReady->getCluster()->get_id();
-      I(dst_cluster_id);
-      printf("DepWindow::::Executed  dstReady Inst is Inst %ld at clockcycle %lu\n", dstReady->getID(), globalClock);
-      printf("DepWindow::::Executed DstReadyInst clusterID is  %d and src_cluster_id is %d\n", dst_cluster_id, src_cluster_id);
-
-      if (dst_cluster_id != src_cluster_id) {
-         printf("DepWindow::::Executed DstReadyInst clusterID!=src_cluster_id::dst_cluster_id is %d iand src_cluster_id is %d\n",
-               dst_cluster_id,
-               src_cluster_id);
-        inter_cluster_fwd.inc(dstReady->has_stats());
-        dstReady->markInterCluster();
-        printf("DepWindow::::Executed markInterCluster DstReadyInst markInterCluster for dstReady Inst %lu\n", dstReady->getID());
-      } else {
-        printf("DepWindow::::Executed !markInterCluster DstReadyInst !markInterCluster for dstReady Inst %lu\n",
-                dstReady->getID());
+void DepWindow::wakeup_ready(Dinst* dstReady) {
+  if (dstReady->is_to_be_destroyed()) {
+    // dstReady->clear_to_be_destroyed_transient();
+    dstReady->destroyTransientInst();
+    return;
+  }
+
+  I(!dstReady->isExecuted());
+  I(!dstReady->hasDeps());
+  // Check dstRes because dstReady may not be issued
+  I(dstReady->getCluster());
+  auto dst_cluster_id = dstReady->getCluster()->get_id();
+  I(dst_cluster_id);
+  printf("DepWindow::::Executed  dstReady Inst is Inst %ld at clockcycle %lu\n", dstReady->getID(), globalClock);
+  printf("DepWindow::::Executed DstReadyInst clusterID is  %d and src_cluster_id is %d\n", dst_cluster_id, src_cluster_id);
+
+  if (dst_cluster_id != src_cluster_id) {
+     printf("DepWindow::::Executed DstReadyInst clusterID!=src_cluster_id::dst_cluster_id is %d iand src_cluster_id is %d\n",
+           dst_cluster_id,
+           src_cluster_id);
+    inter_cluster_fwd.inc(dstReady->has_stats());
+    dstReady->markInterCluster();
+    printf("DepWindow::::Executed markInterCluster DstReadyInst markInterCluster for dstReady Inst %lu\n", dstReady->getID());
+  } else {
+    printf("DepWindow::::Executed !markInterCluster DstReadyInst !markInterCluster for dstReady Inst %lu\n",
+            dstReady->getID());
+  }
+
+  // need todo resetInterCluster()
+  printf("DepWindow::::Executed dependency: DstReady sent to preselect :dstReadyInst %ld at clockcycle %lu\n", 
+      dstReady->getID(), globalClock);
+  preSelect(dstReady);
+}
+
+Ready_select::Ready_select(const std::string& name, NumUnits_t n, std::function<void(Time_t, Dinst*)> g)
+    /* constructor {{{1 */
+    : PortGeneric(name), nUnits(n), grant(std::move(g)), mask(255), lowID(0), highID(0), count(0) {
+  ready.resize((mask + 1) / 64, 0);
+  slot.resize(mask + 1, nullptr);
+}
+/* }}} */
+
+void Ready_select::align_cycle() {
+  if (granted_cycle != globalClock) {
+    granted_cycle      = globalClock;
+    granted_this_cycle = 0;
+  }
+}
+
+void Ready_select::insert(Dinst* dinst) {
+  auto i = dinst->getID() & mask;
+  I((ready[i >> 6] & (1ULL << (i & 63))) == 0);
+  ready[i >> 6] |= 1ULL << (i & 63);
+  slot[i] = dinst;
+}
+
+void Ready_select::grow()
+/* double the ring until it covers lowID..highID {{{1 */
+{
+  std::vector<Dinst*> old;
+  old.reserve(count);
+  for (size_t w = 0; w < ready.size(); ++w) {
+    for (auto bits = ready[w]; bits; bits &= bits - 1) {
+      old.push_back(slot[(w << 6) + std::countr_zero(bits)]);
+    }
+  }
+
+  auto size = mask + 1;
+  while (highID - lowID >= size) {
+    size <<= 1;
+  }
+  mask = size - 1;
+  ready.assign(size / 64, 0);
+  slot.assign(size, nullptr);
+
+  for (auto* d : old) {
+    insert(d);
+  }
+}
+/* }}} */
+
+void Ready_select::add(Dinst* dinst) {
+  auto id = dinst->getID();
+  if (count == 0) {
+    lowID  = id;
+    highID = id;
+  } else {
+    lowID  = std::min(lowID, id);
+    highID = std::max(highID, id);
+  }
+  if (highID - lowID > mask) {
+    grow();
+  }
+  insert(dinst);
+  count++;
+}
+
+size_t Ready_select::find_first() const
+/* slot of the oldest ready instruction {{{1 */
+{
+  I(count);
+  auto nwords = ready.size();
+  auto start  = lowID & mask;
+  auto w      = start >> 6;
+  auto bits   = ready[w] & (~0ULL << (start & 63));
+  for (size_t n = 0; n <= nwords; ++n) {
+    if (bits) {
+      return (w << 6) + std::countr_zero(bits);
+    }
+    w    = (w + 1) & (nwords - 1);
+    bits = ready[w];
+  }
+  I(false);
+  return 0;
+}
+/* }}} */
+
+Time_t Ready_select::nextSlot(bool /*en*/) {
+  I(0);  // priority-managed: use add()
+  return globalClock;
+}
+
+bool Ready_select::is_busy_for(TimeDelta_t /*clk*/) const { return false; }
+
+void Ready_select::flush_transient() {
+  for (size_t w = 0; w < ready.size(); ++w) {
+    for (auto bits = ready[w]; bits; bits &= bits - 1) {
+      auto i = (w << 6) + std::countr_zero(bits);
+      if (slot[i]->isTransient()) {
+        ready[w] &= ~(1ULL << (i & 63));
+        count--;
       }
+    }
+  }
+}
+
+void Ready_select::drain_pending() {
+  align_cycle();
+  while (count && (nUnits == 0 || granted_this_cycle < nUnits)) {
+    auto i = find_first();
+    ready[i >> 6] &= ~(1ULL << (i & 63));
+    count--;
+
+    auto* dinst = slot[i];
+    lowID       = dinst->getID();
+    avgTime.sample(0, dinst->has_stats());
+    grant(globalClock, dinst);
+    ++granted_this_cycle;
+  }
+}
 
-      // need todo resetInterCluster()
-      printf("DepWindow::::Executed dependency: DstReady sent to preselect :dstReadyInst %ld at clockcycle %lu\n", 
-          dstReady->getID(), globalClock);
-      preSelect(dstReady);
+bool Ready_select::has_pending() const {
+  if (count == 0) {
+    return false;
+  }
+  if (nUnits == 0 || granted_cycle != globalClock) {
+    return true;
+  }
+  return granted_this_cycle < nUnits;
+}
+
+
+Wakeup_matrix::Wakeup_matrix()
+    /* constructor {{{1 */
+    : nrows(0), ncols(0) {
+  resize(128, 256);
+}
+/* }}} */
+
+void Wakeup_matrix::set(size_t r, size_t c) {
+  auto w = c >> 6;
+  dep[r * (ncols / 64) + w] |= 1ULL << (c & 63);
+  dep_any[r * any_words() + (w >> 6)] |= 1ULL << (w & 63);
+  wait[c * (nrows / 64) + (r >> 6)] |= 1ULL << (r & 63);
+}
+
+void Wakeup_matrix::clear(size_t r, size_t c) {
+  auto  w    = c >> 6;
+  auto& word = dep[r * (ncols / 64) + w];
+  word &= ~(1ULL << (c & 63));
+  if (word == 0) {
+    dep_any[r * any_words() + (w >> 6)] &= ~(1ULL << (w & 63));
+  }
+  wait[c * (nrows / 64) + (r >> 6)] &= ~(1ULL << (r & 63));
+}
+
+bool Wakeup_matrix::row_empty(size_t r) const {
+  uint64_t any = 0;
+  for (size_t w = r * any_words(); w < (r + 1) * any_words(); ++w) {
+    any |= dep_any[w];
+  }
+  return any == 0;
+}
+
+bool Wakeup_matrix::col_empty(size_t c) const {
+  uint64_t any = 0;
+  for (size_t w = c * (nrows / 64); w < (c + 1) * (nrows / 64); ++w) {
+    any |= wait[w];
+  }
+  return any == 0;
+}
+
+bool Wakeup_matrix::valid(size_t r, size_t c) const
+/* the row instruction still has a link to the column producer {{{1 */
+{
+  const auto* dinst = row_dinst[r];
+  if (dinst == nullptr || dinst->getID() != row_id[r]) {
+    return false;  // recycled
+  }
+  for (const auto* p : {dinst->getParentSrc1(), dinst->getParentSrc2(), dinst->getParentSrc3()}) {
+    if (p && p->getID() == col_id[c]) {
+      return true;
     }
   }
-  // printf("DepWindow::Executed:: Leaving  executed for instID %llu at @Clockcycle %llu\n", dinst->getID(), globalClock);
+  return false;
+}
+/* }}} */
+
+bool Wakeup_matrix::free_row(size_t r) {
+  for (size_t w = 0; w < ncols / 64; ++w) {
+    for (auto bits = dep[r * (ncols / 64) + w]; bits; bits &= bits - 1) {
+      auto c = (w << 6) + std::countr_zero(bits);
+      if (valid(r, c)) {
+        return false;
+      }
+      clear(r, c);
+    }
+  }
+  return true;
+}
 
-  // dinst->flushfirst();//parent->first=0
+bool Wakeup_matrix::free_col(size_t c) {
+  for (size_t w = 0; w < nrows / 64; ++w) {
+    for (auto bits = wait[c * (nrows / 64) + w]; bits; bits &= bits - 1) {
+      auto r = (w << 6) + std::countr_zero(bits);
+      if (valid(r, c)) {
+        return false;
+      }
+      clear(r, c);
+      if (row_empty(r)) {
+        release(r);
+      }
+    }
+  }
+  return true;
+}
+
+size_t Wakeup_matrix::find_col(Time_t id) const {
+  auto base = (id & (ncols / col_ways - 1)) * col_ways;
+  for (auto c = base; c < base + col_ways; ++c) {
+    if (col_id[c] == id) {
+      return c;
+    }
+  }
+  return ncols;
+}
+
+size_t Wakeup_matrix::claim_col(Time_t id)
+/* the column of id, or a way with no live waiters; ncols if the set is full {{{1 */
+{
+  auto c = find_col(id);
+  if (c < ncols) {
+    return c;
+  }
+  auto base = (id & (ncols / col_ways - 1)) * col_ways;
+  for (c = base; c < base + col_ways; ++c) {
+    if (col_empty(c) || free_col(c)) {
+      col_id[c] = id;
+      return c;
+    }
+  }
+  return ncols;
+}
+/* }}} */
+
+void Wakeup_matrix::release(size_t r) {
+  if (row_dinst[r]) {
+    row_dinst[r] = nullptr;
+    free_rows.push_back(r);
+  }
+}
+
+void Wakeup_matrix::reclaim()
+/* free the rows of flushed instructions {{{1 */
+{
+  for (size_t r = 0; r < nrows; ++r) {
+    if (row_dinst[r] && free_row(r)) {
+      release(r);
+    }
+  }
+}
+/* }}} */
+
+void Wakeup_matrix::resize(size_t rows, size_t cols)
+/* rebuild with the live bits {{{1 */
+{
+  std::vector<std::pair<Dinst*, Time_t>> live;  // (consumer, producer ID)
+  for (size_t r = 0; r < nrows; ++r) {
+    for (size_t w = 0; w < ncols / 64; ++w) {
+      for (auto bits = dep[r * (ncols / 64) + w]; bits; bits &= bits - 1) {
+        auto c = (w << 6) + std::countr_zero(bits);
+        if (valid(r, c)) {
+          live.emplace_back(row_dinst[r], col_id[c]);
+        }
+      }
+    }
+  }
+
+  nrows = rows;
+  ncols = cols;
+  dep.assign(nrows * ncols / 64, 0);
+  dep_any.assign(nrows * any_words(), 0);
+  wait.assign(ncols * nrows / 64, 0);
+  row_dinst.assign(nrows, nullptr);
+  row_id.assign(nrows, 0);
+  col_id.assign(ncols, 0);
+
+  size_t r = 0;
+  for (size_t i = 0; i < live.size(); ++i) {
+    auto [dinst, pid] = live[i];
+    if (i && live[i - 1].first != dinst) {
+      ++r;
+    }
+    auto c = claim_col(pid);
+    I(r < nrows && c < ncols);  // a set only splits when ncols doubles
+    row_dinst[r] = dinst;
+    row_id[r]    = dinst->getID();
+    set(r, c);
+  }
+
+  free_rows.clear();
+  for (auto i = nrows; i > (live.empty() ? 0 : r + 1); --i) {
+    free_rows.push_back(i - 1);
+  }
+}
+/* }}} */
+
+void Wakeup_matrix::add(Dinst* dinst)
+/* one row for a waiting instruction, one bit per producer {{{1 */
+{
+  I(dinst->hasDeps());
+
+  const Dinst* parents[] = {dinst->getParentSrc1(), dinst->getParentSrc2(), dinst->getParentSrc3()};
+
+  while (true) {
+    if (free_rows.empty()) {
+      reclaim();
+      if (free_rows.empty()) {
+        resize(nrows * 2, ncols);
+      }
+    }
+    auto r = free_rows.back();
+    free_rows.pop_back();
+    row_dinst[r] = dinst;
+    row_id[r]    = dinst->getID();
+
+    // set as claimed so that a later parent does not take the same column
+    bool fits = true;
+    for (const auto* p : parents) {
+      if (p) {
+        auto c = claim_col(p->getID());
+        if (c == ncols) {
+          fits = false;
+          break;
+        }
+        set(r, c);
+      }
+    }
+    if (fits) {
+      return;
+    }
+
+    for (size_t c = 0; c < ncols; ++c) {
+      clear(r, c);
+    }
+    release(r);
+    resize(nrows, ncols * 2);
+  }
+}
+/* }}} */
+
+void Wakeup_matrix::wakeup(const Dinst* producer, std::vector<Dinst*>& ready)
+/* broadcast the producer tag, append the rows that became ready {{{1 */
+{
+  auto c = find_col(producer->getID());
+  if (c == ncols) {
+    return;
+  }
+
+  for (size_t w = 0; w < nrows / 64; ++w) {
+    auto& word = wait[c * (nrows / 64) + w];
+    while (word) {
+      auto r = (w << 6) + std::countr_zero(word);
+      clear(r, c);
+
+      auto* dinst = row_dinst[r];
+      if (dinst->getID() != row_id[r] || !dinst->waits_on(producer)) {
+        // stale, a flush dropped the link
+        if (row_empty(r)) {
+          release(r);
+        }
+        continue;
+      }
+      dinst->clear_pending_from(producer);
+
+      if (!row_empty(r) && !dinst->hasDeps()) {
+        free_row(r);  // the other producers were flushed
+      }
+      if (row_empty(r)) {
+        I(!dinst->hasDeps());
+        release(r);
+        ready.push_back(dinst);
+      }
+    }
+  }
 }
+/* }}} */
@@ -74,11 +74,11 @@ StallCause InOrderProcessor::add_inst(Dinst* dinst) {
     return SmallROBStall;
   }
 
-  auto cluster = dinst->getCluster();
+  auto* cluster = dinst->getCluster();
   if (!cluster) {
     auto res = clusterManager.getResource(dinst);
-    cluster  = res->getCluster();
-    dinst->set(cluster, res);
+    cluster  = res->getCluster().get();
+    dinst->set(cluster, res.get());
   }
 
   I(dinst->getFlowId() == hid);
@@ -145,6 +145,7 @@ void InOrderProcessor::retire() { /*{{{*/
     if (!done) {
       break;
     }
+    icb_preretire(dinst);
 
     rROB.push(dinst);
     ROB.pop();
@@ -155,6 +156,7 @@ void InOrderProcessor::retire() { /*{{{*/
   robUsed.sample(ROB.size(), stats);
   rrobUsed.sample(rROB.size(), stats);
 
+  int32_t nretired = 0;
   for (uint16_t i = 0; i < RetireWidth && !rROB.empty(); i++) {
     Dinst* dinst = rROB.top();
 
@@ -170,8 +172,10 @@ void InOrderProcessor::retire() { /*{{{*/
 
     bool done = dinst->getCluster()->retire(dinst, false);
     if (!done) {
-      return;
+      break;
     }
+    profile_retired(dinst);
+    nretired++;
 
 #ifndef NDEBUG
     if (!dinst->getInst()->isStore()) {  // Stores can perform after retirement
@@ -186,6 +190,7 @@ void InOrderProcessor::retire() { /*{{{*/
     rROB.pop();
   }
 
+  profile_stalled(nretired);
 } /*}}}*/
 
 void InOrderProcessor::replay(Dinst* dinst) { /*{{{*/
@@ -379,18 +379,18 @@ int32_t MRouter::sendSetStateAll(MemRequest* mreq, MsgAction ma, TimeDelta_t lat
 }
 /* }}} */
 
-void MRouter::tryPrefetch(Addr_t addr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb)
+void MRouter::tryPrefetch(Addr_t addr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb, Time_t age)
 /* propagate the prefetch to the lower level {{{1 */
 {
-  down_node[0]->tryPrefetch(addr, doStats, degree, pref_sign, pc, cb);
+  down_node[0]->tryPrefetch(addr, doStats, degree, pref_sign, pc, cb, age);
 }
 /* }}} */
 
-void MRouter::tryPrefetchPos(uint32_t pos, Addr_t addr, int degree, bool doStats, Addr_t pref_sign, Addr_t pc, CallbackBase* cb)
+void MRouter::tryPrefetchPos(uint32_t pos, Addr_t addr, int degree, bool doStats, Addr_t pref_sign, Addr_t pc, CallbackBase* cb, Time_t age)
 /* propagate the prefetch to the lower level {{{1 */
 {
   I(pos < down_node.size());
-  down_node[pos]->tryPrefetch(addr, doStats, degree, pref_sign, pc, cb);
+  down_node[pos]->tryPrefetch(addr, doStats, degree, pref_sign, pc, cb, age);
 }
 /* }}} */
 
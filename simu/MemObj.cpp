@@ -16,7 +16,7 @@ uint16_t MemObj::id_counter = 0;
 
 MemObj::MemObj(const std::string& sSection, const std::string& sName)
     /* constructor {{{1 */
-    : section(sSection), name(sName), id(id_counter++) {
+    : section(sSection), name(sName), id(id_counter++), hostSlot(&Host_profile::get(fmt::format("mem:{}", sName))) {
   mem_type = Config::get_string(section, "type");
 
   coreid        = -1;  // No first Level cache by default
@@ -155,7 +155,7 @@ TimeDelta_t DummyMemObj::ffwrite(Addr_t addr)
 }
 /* }}} */
 
-void DummyMemObj::tryPrefetch(Addr_t addr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb)
+void DummyMemObj::tryPrefetch(Addr_t addr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb, Time_t age)
 /* forward tryPrefetch {{{1 */
 {
   (void)addr;
@@ -163,6 +163,7 @@ void DummyMemObj::tryPrefetch(Addr_t addr, bool doStats, int degree, Addr_t pref
   (void)degree;
   (void)pref_sign;
   (void)pc;
+  (void)age;
   if (cb) {
     cb->destroy();
   }
@@ -186,6 +187,11 @@ void MemObj::updateXCoreStores(Addr_t addr) {
 }
 void MemObj::replayflush() { I(0); }
 void MemObj::plug() { I(0); }
+void MemObj::retireFetch(Addr_t pc, bool doStats) {
+  (void)pc;
+  (void)doStats;
+  I(0);
+}
 void MemObj::setNeedsCoherence() {
   // Only cache uses this
 }
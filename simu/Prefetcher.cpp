@@ -4,6 +4,7 @@
 
 #include <math.h>
 
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 
@@ -17,26 +18,70 @@
 Prefetcher::Prefetcher(MemObj* _l1, int hartid, std::shared_ptr<Store_buffer> _scb)
     /* constructor {{{1 */
     : DL1(_l1)
-    , scb(std::move(_scb))  
+    , scb(std::move(_scb))
     , avgPrefetchNum(fmt::format("P({})_pref_avgPrefetchNum", hartid))
     , avgPrefetchConf(fmt::format("P({})_pref__avgPrefetchConf", hartid))
     , histPrefetchDelta(fmt::format("P({})_pref__histPrefetchDelta", hartid))
-    , inducing_spec_load(false)
+    , nStreamAlloc(fmt::format("P({})_pref:nStreamAlloc", hartid))
+    , nStreamReplaced(fmt::format("P({})_pref:nStreamReplaced", hartid))
+    , avgActiveStreams(fmt::format("P({})_pref_avgActiveStreams", hartid))
+    , avgFeedbackDegree(fmt::format("P({})_pref_avgFeedbackDegree", hartid))
+    , nTrainCommit(fmt::format("P({})_pref:nTrainCommit", hartid))
+    , nTrainSquash(fmt::format("P({})_pref:nTrainSquash", hartid))
+    , nTrainFull(fmt::format("P({})_pref:nTrainFull", hartid))
+    , rrStream(0)
+    , scheduled(false)
+    , epochIssued(0)
+    , lastUseful(0)
+    , lastWasteful(0)
     , nextPrefetchCB(this) {
   auto section = Config::get_string("soc", "core", hartid, "prefetcher");
 
-  degree   = Config::get_integer(section, "degree", 1, 1024);
-  distance = Config::get_integer(section, "distance", 0, degree);
+  degree         = Config::get_integer(section, "degree", 1, 1024);
+  distance       = Config::get_integer(section, "distance", 0, degree);
+  feedbackDegree = degree;
 
-  pending_prefetch    = false;
-  pending_chain_fetch = 0;
-  pending_preq_conf   = 0;
-  curPrefetch         = 0;
+  auto num_streams = Config::has_entry(section, "num_streams") ? Config::get_integer(section, "num_streams", 1, 256) : 1;
+  issueWidth       = Config::has_entry(section, "issue_width") ? Config::get_integer(section, "issue_width", 1, 64) : 1;
+  issueInterval    = Config::has_entry(section, "issue_interval") ? Config::get_integer(section, "issue_interval", 1, 1024) : 1;
+  feedbackEpoch    = Config::has_entry(section, "feedback_epoch") ? Config::get_integer(section, "feedback_epoch", 0, 1 << 20) : 0;
 
-  std::string dl1_section = DL1->getSection();
+  retireTrain    = Config::has_entry(section, "train") && Config::get_string(section, "train", {"execute", "retire"}) == "retire";
+  trainQueueSize = Config::has_entry(section, "train_queue") ? Config::get_integer(section, "train_queue", 1, 1024) : 32;
+  if (retireTrain) {
+    trainQueue.reserve(trainQueueSize);
+  }
+
+  streams.resize(num_streams);
+  for (auto& st : streams) {
+    st.pc          = 0;
+    st.last_addr   = 0;
+    st.spec_addr   = 0;
+    st.chain_fetch = nullptr;
+    st.age         = 0;
+    st.last_use    = 0;
+    st.next_issue  = 0;
+    st.cur         = 0;
+    st.degree      = degree;
+    st.distance    = distance;
+    st.conf        = 0;
+    st.active      = false;
+    st.statsFlag   = false;
+    st.spec        = false;
+  }
+
+  const MemObj* l1 = DL1;
+  if (DL1->get_type() == "tlb") {
+    l1 = DL1->getRouter()->getDownNode();  // the cache behind the TLB
+  }
+
+  std::string dl1_section = l1->getSection();
   int         bsize       = Config::get_integer(dl1_section, "line_size");
   lineSizeBits            = log2i(bsize);
 
+  usefulName   = fmt::format("{}:nPrefetchUseful", l1->getName());
+  wastefulName = fmt::format("{}:nPrefetchWasteful", l1->getName());
+
   auto type = Config::get_string(section, "type", {"stride", "indirect", "tage", "void"});
 
   if (type == "stride") {
@@ -59,24 +104,83 @@ Prefetcher::Prefetcher(MemObj* _l1, int hartid, std::shared_ptr<Store_buffer> _s
 }
 /* }}} */
 
-void Prefetcher::exe(Dinst* dinst)
-/* forward bus read {{{1 */
+Prefetcher::Stream* Prefetcher::find_stream(Addr_t pc) {
+  if (pc == 0) {
+    return nullptr;  // free stream marker
+  }
+  for (auto& st : streams) {
+    if (st.pc == pc) {
+      return &st;
+    }
+  }
+  return nullptr;
+}
+
+Prefetcher::Stream* Prefetcher::alloc_stream()
+/* free stream, or the LRU one {{{1 */
 {
-  if(dinst->is_spec()){
-    //printf("Prefetcher::exe::Entering exe ()\n");
+  Stream* victim = nullptr;
+  for (auto& st : streams) {
+    if (!st.active) {
+      if (victim == nullptr || victim->active || st.last_use < victim->last_use) {
+        victim = &st;
+      }
+    } else if (victim == nullptr || (victim->active && st.last_use < victim->last_use)) {
+      victim = &st;
+    }
   }
+  I(victim);
+
+  if (victim->active) {
+    nStreamReplaced.inc(victim->statsFlag);
+    if ((victim->cur - victim->distance) > 0) {
+      avgPrefetchNum.sample(victim->cur - victim->distance, victim->statsFlag);
+    }
+    victim->active = false;
+  }
+  victim->degree = feedbackDegree;
+
+  return victim;
+}
+/* }}} */
 
+void Prefetcher::stop(Stream& st) {
+  st.active      = false;
+  st.chain_fetch = nullptr;
+  st.conf        = 0;
+}
+
+void Prefetcher::exe(Dinst* dinst)
+/* train and allocate the stream of the load {{{1 */
+{
   if (apred == nullptr) {
     return;
   }
 
-  if(dinst->is_spec()){
-    //printf("Prefetcher::exe::Prefetcher is executed ()\n");
+  Conf_level conf_level;
+  if (retireTrain) {
+    // Trained at ret, if the load is not transient. Loads execute out of
+    // order, the queue is kept in program (ID) order for ret
+    auto it = std::lower_bound(trainQueue.begin(), trainQueue.end(), dinst->getID(), [](const Train& t, Time_t id) {
+      return t.id < id;
+    });
+    if (it != trainQueue.end() && it->id == dinst->getID()) {
+      *it = Train{dinst->getID(), dinst->getPC(), dinst->getAddr(), dinst->getData()};  // replayed
+    } else if (trainQueue.size() < trainQueueSize) {
+      trainQueue.insert(it, Train{dinst->getID(), dinst->getPC(), dinst->getAddr(), dinst->getData()});
+    } else {
+      nTrainFull.inc(dinst->has_stats());
+    }
+    conf_level = apred->get_conf(dinst->getPC());
+  } else {
+    apred->ret_update(dinst->getPC(), dinst->getAddr(), dinst->getData());
+    conf_level = apred->exe_update(dinst->getPC(), dinst->getAddr(), dinst->getData());
   }
-  apred->ret_update(dinst->getPC(), dinst->getAddr(), dinst->getData());
-  auto conf_level = apred->exe_update(dinst->getPC(), dinst->getAddr(), dinst->getData());
+  auto conf = 4 * static_cast<int>(conf_level);
 
-  if (pending_preq_pc == dinst->getPC() && pending_preq_conf > 4 * static_cast<int>(conf_level)) {
+  auto* st = find_stream(dinst->getPC());
+  if (st && st->active && st->conf > conf) {
+    st->last_use = globalClock;
     return;  // Do not kill itself
   }
 
@@ -85,32 +189,49 @@ void Prefetcher::exe(Dinst* dinst)
   }
 
   avgPrefetchConf.sample(conf, dinst->has_stats());
-  if (pending_prefetch && (curPrefetch - distance) > 0) {
-    avgPrefetchNum.sample(curPrefetch - distance, pending_statsFlag);
-  }
-
-  pending_preq_pc   = dinst->getPC();
-  pending_preq_conf = 4 * static_cast<int>(conf_level);
-  pending_statsFlag = dinst->has_stats();
-  inducing_spec_load   = dinst->is_spec();  //NEW -- remember whether the inducing load is speculative
-  inducing_spec_load_addr = dinst->getAddr();  
 
+  bool was_active = false;
+  if (st == nullptr) {
+    st = alloc_stream();
+    nStreamAlloc.inc(dinst->has_stats());
+  } else if (st->active) {
+    was_active = true;
+    if ((st->cur - st->distance) > 0) {
+      avgPrefetchNum.sample(st->cur - st->distance, st->statsFlag);
+    }
+    st->degree = std::min(degree, st->degree + 1);  // the stream keeps going, ramp it up
+  } else {
+    st->degree = feedbackDegree;
+  }
 
+  st->pc        = dinst->getPC();
+  st->conf      = conf;
+  st->statsFlag = dinst->has_stats();
+  st->spec      = dinst->is_spec();
+  st->spec_addr = dinst->getAddr();
+  st->age       = dinst->getID();
+  st->last_use  = globalClock;
+  st->distance  = std::min(distance, st->degree - 1);
 
   if (dinst->getChained()) {
     I(dinst->getFetchEngine());
-    curPrefetch         = dinst->getChained();
-    pending_chain_fetch = dinst->getFetchEngine();
+    st->cur         = dinst->getChained();
+    st->chain_fetch = dinst->getFetchEngine();
   } else {
     I(!dinst->getFetchEngine());
-    curPrefetch         = distance;
-    pending_chain_fetch = 0;
+    st->cur         = st->distance;
+    st->chain_fetch = nullptr;
   }
-  pending_preq_addr = dinst->getAddr();
+  st->last_addr = dinst->getAddr();
 
-  if (!pending_prefetch) {
-    pending_prefetch = true;
+  if (!was_active) {
+    st->active     = true;
+    st->next_issue = globalClock + 1;
     dinst->markPrefetch();
+  }
+
+  if (!scheduled) {
+    scheduled = true;
     nextPrefetchCB.schedule(1);
   }
 }
@@ -123,6 +244,11 @@ void Prefetcher::ret(Dinst* dinst)
     return;
   }
 
+  if (retireTrain) {
+    retire_train(dinst);
+    return;
+  }
+
   if(dinst->is_spec()){
     printf("Prefetcher::ret::Prefetcher is updated at ret()\n");
   }
@@ -130,80 +256,163 @@ void Prefetcher::ret(Dinst* dinst)
 }
 // 1}}}
 
-void Prefetcher::nextPrefetch()
-// {{{1 Method called to trigger a prefetch
+void Prefetcher::retire_train(Dinst* dinst)
+// {{{1 apply the training queued at exe, in program order
 {
-  I(apred);
+  auto id = dinst->getID();
 
-  if (!pending_prefetch) {
-    return;
+  // Older entries not retired were transient (or the queue skipped their ret)
+  size_t i = 0;
+  while (i < trainQueue.size() && trainQueue[i].id < id) {
+    nTrainSquash.inc(dinst->has_stats());
+    ++i;
+  }
+
+  if (i < trainQueue.size() && trainQueue[i].id == id) {
+    const auto& t = trainQueue[i];
+    if (dinst->isTransient()) {
+      nTrainSquash.inc(dinst->has_stats());
+    } else {
+      apred->exe_update(t.pc, t.addr, t.data);
+      apred->ret_update(t.pc, t.addr, t.data);
+      nTrainCommit.inc(dinst->has_stats());
+    }
+    ++i;
   }
 
-  if (pending_preq_conf > 0) {
-    pending_preq_conf--;
+  trainQueue.erase(trainQueue.begin(), trainQueue.begin() + i);
+}
+// 1}}}
+
+void Prefetcher::issue(Stream& st)
+// {{{1 next prefetch of one stream
+{
+  I(apred);
+  I(st.active);
+
+  if (st.conf > 0) {
+    st.conf--;
   }
 
-  curPrefetch++;
+  st.cur++;
 
-  if (curPrefetch >= degree || pending_preq_conf <= 1) {
-    pending_prefetch    = false;
-    pending_chain_fetch = 0;
-    pending_preq_conf   = 0;
-    avgPrefetchNum.sample(curPrefetch - distance - 1, pending_statsFlag);
+  if (st.cur >= st.degree || st.conf <= 1) {
+    avgPrefetchNum.sample(st.cur - st.distance - 1, st.statsFlag);
+    stop(st);
     return;
   }
 
   Addr_t paddr;
-  if (pending_chain_fetch) {
-    paddr = apred->predict(pending_preq_pc, curPrefetch + 4, false);
-
+  if (st.chain_fetch) {
+    paddr = apred->predict(st.pc, st.cur + 4, false);
   } else {
-    paddr = apred->predict(pending_preq_pc, curPrefetch + (curPrefetch - distance), true);
+    paddr = apred->predict(st.pc, st.cur + (st.cur - st.distance), true);
   }
+
   if ((paddr >> 12) == 0) {
-    bool chain = apred->try_chain_predict(DL1, pending_preq_pc, curPrefetch + (curPrefetch - distance));
+    bool chain = apred->try_chain_predict(DL1, st.pc, st.cur + (st.cur - st.distance));
     if (!chain) {
-      if ((curPrefetch - distance - 1) > 0) {
-        avgPrefetchNum.sample(curPrefetch - distance - 1, pending_statsFlag);
+      if ((st.cur - st.distance - 1) > 0) {
+        avgPrefetchNum.sample(st.cur - st.distance - 1, st.statsFlag);
       }
-      pending_prefetch    = false;
-      pending_chain_fetch = 0;
-      pending_preq_conf   = 0;
-      return;
+      stop(st);
     }
-  } else {
+    return;
+  }
+
+  if (paddr == st.last_addr) {  // Offset 0
+    stop(st);
+    return;
+  }
+
 #ifdef PREFETCH_HIST
-    histPrefetchDelta.sample((paddr - pending_preq_addr), pending_statsFlag, 1);
+  histPrefetchDelta.sample((paddr - st.last_addr), st.statsFlag, 1);
 #endif
-    pending_preq_addr = paddr;
-    
-
-#ifdef ENABLE_SCB_SPEC                                                                        //NEW
-    if (inducing_spec_load && scb) {                                                              //NEW
-      // NEW: spec-induced prefetch -- stage it in the SCB (checked against L1 hit/miss inside
-      // add_prefetch), tagged with the load that induced it. Use pending_inducing_load_addr here,
-      // NOT pending_preq_addr -- that was just reassigned to paddr on the line above (fix 1).
-      //scb->try_prefetch(paddr, pending_statsFlag, curPrefetch, pref_sign, pending_preq_pc, inducing_spec_load_addr);  //NEW
-      scb->try_prefetch(paddr, pending_statsFlag, pending_preq_pc, inducing_spec_load_addr);  //NEW
-    } else                                                                                       //NEW
-#endif                                                                                            //NEW
-    {   
-      CallbackBase* cb  = 0;
-      if (pending_chain_fetch) {
-        cb = FetchEngine::chainPrefDoneCB::create(pending_chain_fetch, pending_preq_pc, curPrefetch + 4, paddr);
-      }
-      DL1->tryPrefetch(paddr, pending_statsFlag, curPrefetch, pref_sign, pending_preq_pc, cb);
-    }
+  st.last_addr = paddr;
+  epochIssued++;
+
+#ifdef ENABLE_SCB_SPEC
+  if (st.spec && scb) {
+    // Spec-induced prefetch: stage it in the SCB (checked against L1 hit/miss inside
+    // add_prefetch), tagged with the load that induced it (not last_addr, updated above)
+    scb->try_prefetch(paddr, st.statsFlag, st.pc, st.spec_addr);
+    return;
+  }
+#endif
+
+  CallbackBase* cb = nullptr;
+  if (st.chain_fetch) {
+    cb = FetchEngine::chainPrefDoneCB::create(st.chain_fetch, st.pc, st.cur + 4, paddr);
   }
+  DL1->tryPrefetch(paddr, st.statsFlag, st.cur, pref_sign, st.pc, cb, st.age);
+}
+// 1}}}
 
-  if (paddr == pending_preq_addr) {  // Offset 0
-    pending_prefetch    = false;
-    pending_chain_fetch = 0;
-    pending_preq_conf   = 0;
+void Prefetcher::feedback()
+// {{{1 adjust the degree of new streams with the DL1 prefetch accuracy
+{
+  epochIssued = 0;
+
+  auto useful   = Stats::get_cntr(usefulName);
+  auto wasteful = Stats::get_cntr(wastefulName);
+  if (useful < lastUseful || wasteful < lastWasteful) {  // stats were reset
+    lastUseful   = useful;
+    lastWasteful = wasteful;
     return;
   }
 
-  I(pending_prefetch);
-  nextPrefetchCB.schedule(1);
+  auto du      = useful - lastUseful;
+  auto dw      = wasteful - lastWasteful;
+  lastUseful   = useful;
+  lastWasteful = wasteful;
+  if (du + dw < 8) {
+    return;  // not enough evidence (or the DL1 does not track prefetches)
+  }
+
+  auto accuracy   = du / (du + dw);
+  auto min_degree = std::min(degree, distance + 2);
+  if (accuracy > 0.75) {
+    feedbackDegree = std::min(degree, feedbackDegree + std::max(1, feedbackDegree / 4));
+  } else if (accuracy < 0.40) {
+    feedbackDegree = std::max(min_degree, feedbackDegree / 2);
+  }
+  avgFeedbackDegree.sample(feedbackDegree, true);
+}
+// 1}}}
+
+void Prefetcher::nextPrefetch()
+// {{{1 Method called every cycle while there are active streams
+{
+  scheduled = false;
+
+  uint32_t nactive = 0;
+  uint32_t issued  = 0;
+  bool     en      = false;
+  for (auto k = 0u; k < streams.size(); ++k) {
+    auto& st = streams[(rrStream + k) % streams.size()];
+    if (!st.active) {
+      continue;
+    }
+    if (issued < issueWidth && st.next_issue <= globalClock) {
+      issue(st);
+      ++issued;
+      st.next_issue = globalClock + issueInterval;
+    }
+    if (st.active) {
+      ++nactive;
+      en |= st.statsFlag;
+    }
+  }
+  rrStream = (rrStream + 1) % streams.size();
+  avgActiveStreams.sample(nactive, en);
+
+  if (feedbackEpoch && epochIssued >= feedbackEpoch) {
+    feedback();
+  }
+
+  if (nactive) {
+    scheduled = true;
+    nextPrefetchCB.schedule(1);
+  }
 }
 // 1}}}
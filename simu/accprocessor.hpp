@@ -2,27 +2,77 @@
 
 #pragma once
 
+#include <random>
+#include <vector>
+
 #include "callback.hpp"
 #include "gmemory_system.hpp"
 #include "iassert.hpp"
 #include "simu_base.hpp"
 #include "stats.hpp"
 
+// Memory traffic generator (core type = "accel"). Every interval cycles it
+// injects a burst of up to burst requests to the DL1, with at most
+// max_outstanding requests in flight. The addresses follow pattern inside a
+// footprint of bytes starting at addr_base:
+//
+//  stream:  consecutive lines
+//  strided: nstreams interleaved streams with stride bytes between accesses
+//  random:  uniform random lines
+//  hotspot: hotspot_ratio percent of the accesses to the first hotspot_size
+//           bytes, the rest uniform random
+//  trace:   replay trace_file, little endian 64 bit addresses with bit 0 set
+//           for writes
+//
+// write_ratio percent of the generated accesses are writes (trace has its
+// own). requests stops the generator after that many requests (0 no limit).
 class AccProcessor : public Simu_base {
 private:
 protected:
-  Addr_t myAddr;
-  Addr_t addrIncr;
-  int    reqid;
-  int    total_accesses;
-  int    outstanding_accesses;
+  enum class Pattern { stream, strided, random, hotspot, trace };
+
+  Pattern        pattern;
+  const Addr_t   addrBase;
+  const Addr_t   footprint;
+  const Addr_t   lineSize;
+  const uint32_t writeRatio;
+  const uint32_t maxOutstanding;
+  const uint32_t interval;
+  const uint32_t burst;
+  const uint64_t maxRequests;
+
+  Addr_t              stride;
+  Addr_t              hotspotSize;
+  uint32_t            hotspotRatio;
+  std::vector<Addr_t> streamPos;  // offset of each stream in the footprint
+  uint32_t            nextStream;
+
+  std::vector<uint64_t> trace;
+  size_t                tracePos;
+
+  std::mt19937_64 rng;
+
+  uint64_t reqid;
+  uint32_t outstanding_accesses;
+  uint64_t windowDone;  // requests completed in the current bandwidth window
 
   Stats_cntr accReads;
   Stats_cntr accWrites;
+  Stats_cntr accStallOutstanding;
 
   Stats_avg accReadLatency;
   Stats_avg accWriteLatency;
 
+  Stats_hist accReadLatencyHist;
+  Stats_hist accWriteLatencyHist;
+  Stats_hist accBandwidth;  // requests completed per bw_window cycles
+
+  const Time_t bwWindow;
+
+  bool   next_access(Addr_t& addr, bool& write);
+  Addr_t random_offset(Addr_t range);
+  void   inject();
+
   void read_performed(uint32_t id, Time_t startTime);
   void write_performed(uint32_t id, Time_t startTime);
   typedef CallbackMember2<AccProcessor, uint32_t, Time_t, &AccProcessor::read_performed>  read_performedCB;
@@ -47,6 +47,9 @@ public:
   virtual bool       try_chain_predict(MemObj* dl1, Addr_t pc, int distance) = 0;
   virtual Conf_level exe_update(Addr_t pc, Addr_t addr, Data_t data = 0)     = 0;
   virtual Conf_level ret_update(Addr_t pc, Addr_t addr, Data_t data = 0)     = 0;
+
+  // Confidence of pc without updating the tables (retire trained prefetch)
+  virtual Conf_level get_conf(Addr_t pc) const = 0;
 };
 
 /**********************
@@ -132,6 +135,7 @@ public:
   bool       try_chain_predict(MemObj* dl1, Addr_t pc, int distance);
   Conf_level exe_update(Addr_t pc, Addr_t addr, Data_t data);
   Conf_level ret_update(Addr_t pc, Addr_t addr, Data_t data);
+  Conf_level get_conf(Addr_t pc) const { return bimodal.has_conf(pc); }
 };
 
 /*****************************
@@ -309,6 +313,7 @@ public:
   bool       try_chain_predict(MemObj* dl1, Addr_t pc, int distance);
   Conf_level exe_update(Addr_t pc, Addr_t addr, Data_t data);
   Conf_level ret_update(Addr_t pc, Addr_t addr, Data_t data);
+  Conf_level get_conf(Addr_t pc) const { return bimodal.has_conf(pc); }
 };
 
 // INDIRECT Address Predictor
@@ -334,4 +339,5 @@ public:
   bool       try_chain_predict(MemObj* dl1, Addr_t pc, int distance);
   Conf_level exe_update(Addr_t pc, Addr_t addr, Data_t data);
   Conf_level ret_update(Addr_t pc, Addr_t addr, Data_t data);
+  Conf_level get_conf(Addr_t pc) const { return bimodal.has_conf(pc); }
 };
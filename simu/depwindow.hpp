@@ -2,6 +2,9 @@
 
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include "iassert.hpp"
 #include "port.hpp"
 #include "resource.hpp"
@@ -10,9 +13,101 @@
 class Dinst;
 class Cluster;
 
+// Select for sched_bitvector = true. Ready instructions set a bit indexed by
+// their ID in a ring that covers the oldest to the youngest ready ID, and the
+// end of cycle drain grants up to nUnits (0 unlimited) of them oldest first
+// with a find first set from the oldest ID. Same grants as PortPipePriority
+// without a heap of callbacks.
+class Ready_select : public PortGeneric {
+private:
+  const NumUnits_t nUnits;
+
+  std::function<void(Time_t, Dinst*)> grant;
+
+  std::vector<uint64_t> ready;
+  std::vector<Dinst*>   slot;
+  Time_t                mask;
+  Time_t                lowID;   // no ready ID is older
+  Time_t                highID;  // no ready ID is younger
+  size_t                count;
+
+  NumUnits_t granted_this_cycle = 0;
+  Time_t     granted_cycle      = 0;
+
+  void   align_cycle();
+  void   grow();
+  void   insert(Dinst* dinst);
+  size_t find_first() const;
+
+public:
+  Ready_select(const std::string& name, NumUnits_t n, std::function<void(Time_t, Dinst*)> g);
+
+  void add(Dinst* dinst);
+
+  Time_t             nextSlot(bool en) override;
+  [[nodiscard]] bool is_busy_for(TimeDelta_t clk) const override;
+  void               flush_transient() override;
+  void               drain_pending() override;
+  [[nodiscard]] bool has_pending() const override;
+};
+
+// Wakeup for sched_bitvector = true, one per cluster. Rows are the
+// instructions waiting in the cluster window (taken from a free list), columns
+// the producers they wait on (4-way sets by producer ID). dep keeps the bits
+// by row (dep_any ORs each row word into one bit) and wait the same bits by
+// column. A producer broadcast walks its column with find first set, and a row
+// whose OR drops to zero is ready and freed. Rows and columns double when a
+// live entry is in the way.
+//
+// Flush and retire still walk the DinstNext lists, so wakeup drops the links
+// it clears (clear_pending_from). Bits whose link a flush already dropped are
+// stale and are cleaned when found.
+class Wakeup_matrix {
+private:
+  static constexpr size_t col_ways = 4;
+
+  size_t nrows;
+  size_t ncols;
+
+  std::vector<uint64_t> dep;        // nrows x ncols/64
+  std::vector<uint64_t> dep_any;    // nrows x any_words()
+  std::vector<uint64_t> wait;       // ncols x nrows/64
+  std::vector<Dinst*>   row_dinst;  // nullptr when free
+  std::vector<Time_t>   row_id;
+  std::vector<Time_t>   col_id;
+  std::vector<size_t>   free_rows;
+
+  size_t any_words() const { return (ncols / 64 + 63) / 64; }
+  void   set(size_t r, size_t c);
+  void   clear(size_t r, size_t c);
+  bool   row_empty(size_t r) const;
+  bool   col_empty(size_t c) const;
+  bool   valid(size_t r, size_t c) const;
+  bool   free_row(size_t r);
+  bool   free_col(size_t c);
+  size_t find_col(Time_t id) const;
+  size_t claim_col(Time_t id);
+  void   release(size_t r);
+  void   reclaim();
+  void   resize(size_t rows, size_t cols);
+
+public:
+  Wakeup_matrix();
+
+  void add(Dinst* dinst);
+  void wakeup(const Dinst* producer, std::vector<Dinst*>& ready);
+
+  size_t get_nrows() const { return nrows; }
+  size_t get_ncols() const { return ncols; }
+};
+
 class DepWindow {
 private:
-  int src_cluster_id;
+  // Wakeup broadcasts reach every cluster window of the core
+  static inline std::vector<std::vector<DepWindow*>> core_windows;
+
+  uint32_t cpu_id;
+  int      src_cluster_id;
 
   TimeDelta_t inter_cluster_lat;
   TimeDelta_t sched_lat;
@@ -20,8 +115,13 @@ private:
   Stats_cntr inter_cluster_fwd;
 
   std::shared_ptr<PortGeneric> schedPort;
+  Ready_select*                readySelect;  // nullptr unless sched_bitvector
+
+  std::unique_ptr<Wakeup_matrix> wakeupMatrix;  // nullptr unless sched_bitvector
+  std::vector<Dinst*>            woken;
 
   void do_schedule(Time_t when, Dinst* dinst);
+  void wakeup_ready(Dinst* dstReady);
 
 protected:
   void preSelect(Dinst* dinst);
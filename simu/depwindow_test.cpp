@@ -0,0 +1,277 @@
+// This file is distributed under the BSD 3-Clause License. See LICENSE for details.
+
+#include "depwindow.hpp"
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "dinst.hpp"
+#include "gtest/gtest.h"
+#include "port.hpp"
+
+class Ready_select_test : public ::testing::Test {
+protected:
+  void SetUp() override {
+    globalClock = 0;
+    EventScheduler::reset();
+  }
+
+  void TearDown() override { EventScheduler::reset(); }
+
+  using Grants = std::vector<std::pair<Time_t, Time_t>>;  // (ID, when)
+
+  // Wakes up the same instructions, out of ID order and in bursts, on a
+  // PortPipePriority (or PortUnlimitedPriority) and on a Ready_select
+  static void compare(NumUnits_t nunits, uint32_t seed) {
+    auto   prio = PortGeneric::create(fmt::format("prio_{}_{}", nunits, seed), nunits, /*priority_managed=*/true);
+    Grants prio_grants;
+
+    Grants sel_grants;
+    auto   sel = std::make_shared<Ready_select>(fmt::format("sel_{}_{}", nunits, seed),
+                                              nunits,
+                                              [&sel_grants](Time_t when, Dinst* dinst) {
+                                                sel_grants.emplace_back(dinst->getID(), when);
+                                              });
+    EventScheduler::register_drain_port(sel.get());
+
+    std::vector<Dinst*> insts;
+    for (auto i = 0; i < 3000; ++i) {
+      insts.push_back(Dinst::create(
+          Instruction(Opcode::iAALU, RegType::LREG_R1, RegType::LREG_R2, RegType::LREG_R3, RegType::LREG_InvalidOutput),
+          0x1000 + 4 * i,
+          0,
+          0,
+          true));
+    }
+
+    // Wakeups reorder instructions within a window of 24
+    std::mt19937 rng(seed);
+    for (size_t i = 0; i < insts.size(); i += 24) {
+      std::shuffle(insts.begin() + i, insts.begin() + std::min(i + 24, insts.size()), rng);
+    }
+
+    size_t pos = 0;
+    while (prio_grants.size() < insts.size() && globalClock < 100000) {
+      auto burst = rng() % 7;  // 0 to 6 wakeups per cycle
+      for (auto i = 0u; i < burst && pos < insts.size(); ++i, ++pos) {
+        auto* dinst = insts[pos];
+        prio->schedule(true, dinst->getID(), false, [&prio_grants, dinst](Time_t when) {
+          prio_grants.emplace_back(dinst->getID(), when);
+        });
+        sel->add(dinst);
+      }
+      EventScheduler::advanceClock();
+    }
+
+    EXPECT_EQ(prio_grants.size(), insts.size());
+    EXPECT_EQ(prio_grants, sel_grants);
+
+    for (auto* dinst : insts) {
+      dinst->scrap();
+    }
+    EventScheduler::reset();
+  }
+};
+
+TEST_F(Ready_select_test, same_grants_as_priority_port) {
+  for (uint32_t seed = 1; seed <= 3; ++seed) {
+    compare(1, seed);
+    compare(2, seed);
+    compare(4, seed);
+    compare(0, seed);  // unlimited
+  }
+}
+
+TEST_F(Ready_select_test, ring_grows_past_initial_size) {
+  // Wakes up an old instruction after hundreds of younger ones
+  Grants grants;
+  auto   sel = std::make_shared<Ready_select>("sel_grow", 1, [&grants](Time_t when, Dinst* dinst) {
+    grants.emplace_back(dinst->getID(), when);
+  });
+  EventScheduler::register_drain_port(sel.get());
+
+  std::vector<Dinst*> insts;
+  for (auto i = 0; i < 600; ++i) {
+    insts.push_back(Dinst::create(
+        Instruction(Opcode::iAALU, RegType::LREG_R1, RegType::LREG_R2, RegType::LREG_R3, RegType::LREG_InvalidOutput),
+        0x1000 + 4 * i,
+        0,
+        0,
+        true));
+  }
+
+  sel->add(insts.back());
+  sel->add(insts.front());
+  EventScheduler::advanceClock();
+  EventScheduler::advanceClock();
+
+  ASSERT_EQ(grants.size(), 2U);
+  EXPECT_EQ(grants[0].first, insts.front()->getID());
+  EXPECT_EQ(grants[1].first, insts.back()->getID());
+
+  for (auto* dinst : insts) {
+    dinst->scrap();
+  }
+}
+
+class Wakeup_matrix_test : public ::testing::Test {
+protected:
+  static Dinst* create() {
+    return Dinst::create(
+        Instruction(Opcode::iAALU, RegType::LREG_R1, RegType::LREG_R2, RegType::LREG_R3, RegType::LREG_InvalidOutput),
+        0x1000,
+        0,
+        0,
+        true);
+  }
+
+  static std::vector<Time_t> ids(std::vector<Dinst*> insts) {
+    std::vector<Time_t> v;
+    for (auto* d : insts) {
+      v.push_back(d->getID());
+    }
+    std::sort(v.begin(), v.end());
+    return v;
+  }
+
+  // The consumers that getNextPending would leave without dependences
+  static std::vector<Dinst*> dinst_next_ready(const Dinst* producer, std::map<Dinst*, int>& ndeps) {
+    std::vector<Dinst*> ready;
+    for (const auto* n = producer->getFirst(); n; n = n->getNext()) {
+      if (--ndeps[n->getDinst()] == 0) {
+        ready.push_back(n->getDinst());
+      }
+    }
+    return ready;
+  }
+};
+
+TEST_F(Wakeup_matrix_test, same_wakeups_as_dinst_next) {
+  for (uint32_t seed = 1; seed <= 3; ++seed) {
+    Wakeup_matrix cluster[2];  // consumers alternate between two clusters
+    std::mt19937  rng(seed);
+
+    std::vector<Dinst*>   all;
+    std::vector<Dinst*>   inflight;  // renamed and not executed
+    std::vector<Dinst*>   ready;
+    std::map<Dinst*, int> ndeps;
+    size_t                nwakeups = 0;
+
+    while (all.size() < 3000 || !inflight.empty()) {
+      while (all.size() < 3000 && inflight.size() < 48) {
+        auto* d = create();
+        for (auto src = 0; src < 3; ++src) {
+          if (inflight.empty() || rng() % 3 == 0) {
+            continue;
+          }
+          auto* p = inflight[inflight.size() - 1 - rng() % std::min<size_t>(inflight.size(), 40)];
+          ndeps[d]++;
+          if (src == 0) {
+            p->addSrc1(d);
+          } else if (src == 1) {
+            p->addSrc2(d);
+          } else {
+            p->addSrc3(d);
+          }
+        }
+        if (d->hasDeps()) {
+          cluster[all.size() % 2].add(d);
+        } else {
+          ready.push_back(d);
+        }
+        all.push_back(d);
+        inflight.push_back(d);
+      }
+
+      ASSERT_FALSE(ready.empty());
+      auto  pos      = rng() % ready.size();
+      auto* producer = ready[pos];
+      ready.erase(ready.begin() + pos);
+      inflight.erase(std::find(inflight.begin(), inflight.end(), producer));
+
+      auto expected = dinst_next_ready(producer, ndeps);
+
+      std::vector<Dinst*> woken;
+      cluster[0].wakeup(producer, woken);
+      cluster[1].wakeup(producer, woken);
+      producer->flush_first();
+
+      EXPECT_EQ(ids(woken), ids(expected));
+      for (auto* d : woken) {
+        EXPECT_FALSE(d->hasDeps());
+        ready.push_back(d);
+      }
+      nwakeups += woken.size();
+    }
+
+    EXPECT_GT(nwakeups, 1000U);
+    for (auto* d : all) {
+      d->scrap();
+    }
+  }
+}
+
+TEST_F(Wakeup_matrix_test, stale_link_after_flush) {
+  Wakeup_matrix m;
+
+  auto* p1 = create();
+  auto* p2 = create();
+  auto* c  = create();
+  p1->addSrc1(c);
+  p2->addSrc2(c);
+  m.add(c);
+
+  // A transient flush walks p1 without waking anyone
+  while (p1->hasPending()) {
+    p1->getNextPending();
+  }
+
+  std::vector<Dinst*> woken;
+  m.wakeup(p2, woken);
+  p2->flush_first();
+  ASSERT_EQ(woken.size(), 1U);
+  EXPECT_EQ(woken[0], c);
+
+  woken.clear();
+  m.wakeup(p1, woken);
+  EXPECT_TRUE(woken.empty());
+
+  c->scrap();
+  p2->scrap();
+  p1->scrap();
+}
+
+TEST_F(Wakeup_matrix_test, rings_grow_past_initial_size) {
+  Wakeup_matrix m;
+
+  std::vector<Dinst*> producers;
+  std::vector<Dinst*> consumers;
+  for (auto i = 0; i < 400; ++i) {
+    producers.push_back(create());
+  }
+  for (auto* p : producers) {
+    auto* c = create();
+    p->addSrc1(c);
+    m.add(c);
+    consumers.push_back(c);
+  }
+  EXPECT_GT(m.get_nrows(), 256U);
+  EXPECT_GT(m.get_ncols(), 256U);
+
+  for (size_t i = 0; i < producers.size(); ++i) {
+    std::vector<Dinst*> woken;
+    m.wakeup(producers[i], woken);
+    producers[i]->flush_first();
+    ASSERT_EQ(woken.size(), 1U);
+    EXPECT_EQ(woken[0], consumers[i]);
+  }
+
+  for (auto* d : consumers) {
+    d->scrap();
+  }
+  for (auto* d : producers) {
+    d->scrap();
+  }
+}
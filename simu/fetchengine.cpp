@@ -11,6 +11,7 @@
 #include "fmt/format.h"
 #include "gmemory_system.hpp"
 #include "gprocessor.hpp"
+#include "host_profile.hpp"
 #include "memobj.hpp"
 #include "memrequest.hpp"
 #include "pipeline.hpp"
@@ -223,8 +224,15 @@ void FetchEngine::realfetch(IBucket* bucket, std::shared_ptr<Emul_base> eint, Ha
   RegType last_src2 = LREG_R0;
 #endif
 
+  static auto& peekSlot    = Host_profile::get("emul:peek");
+  static auto& executeSlot = Host_profile::get("emul:execute");
+
   do {
-    Dinst* dinst = eint->peek(fid);
+    Dinst* dinst;
+    {
+      Host_scope scope(peekSlot);
+      dinst = eint->peek(fid);
+    }
     if (dinst == nullptr) {  // end of trace
       TaskHandler::simu_pause(fid);
       break;
@@ -292,7 +300,10 @@ void FetchEngine::realfetch(IBucket* bucket, std::shared_ptr<Emul_base> eint, Ha
     lastpc = dinst->getPC();
     I(lastpc);
 
-    eint->execute(fid);
+    {
+      Host_scope scope(executeSlot);
+      eint->execute(fid);
+    }
 
     dinst->setGProc(gproc);
 
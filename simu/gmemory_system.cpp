@@ -92,7 +92,7 @@ void Gmemory_system::build_memory_system() {
   IL1->getRouter()->fillRouteTables();
   IL1->setCoreIL1(coreId);
 
-  if (IL1->get_type() == "tlb") {
+  if (IL1->get_type() == "tlb" || IL1->get_type() == "icb") {
     IL1->getRouter()->getDownNode()->setCoreIL1(coreId);
   }
 
@@ -10,6 +10,7 @@
 #include "fetchengine.hpp"
 #include "fmt/format.h"
 #include "gmemory_system.hpp"
+#include "memobj.hpp"
 #include "port.hpp"
 #include "report.hpp"
 #include "tracer.hpp"
@@ -36,17 +37,37 @@ GProcessor::GProcessor(std::shared_ptr<Gmemory_system> gm, Hartid_t i)
     , pipeQ(i) {
   smt_size = Config::get_integer("soc", "core", i, "smt", 1, 32);
 
+  icb = gm->getIL1() && gm->getIL1()->get_type() == "icb" ? gm->getIL1() : nullptr;
+
   lastReplay = 0;
 
-  nStall[SmallWinStall]     = std::make_unique<Stats_cntr>(fmt::format("P({})_ExeEngine:nSmallWinStall", i));
-  nStall[SmallROBStall]     = std::make_unique<Stats_cntr>(fmt::format("P({})_ExeEngine:nSmallROBStall", i));
-  nStall[SmallREGStall]     = std::make_unique<Stats_cntr>(fmt::format("P({})_ExeEngine:nSmallREGStall", i));
-  nStall[DivergeStall]      = std::make_unique<Stats_cntr>(fmt::format("P({})_ExeEngine:nDivergeStall", i));
-  nStall[OutsLoadsStall]    = std::make_unique<Stats_cntr>(fmt::format("P({})_ExeEngine:nOutsLoadsStall", i));
-  nStall[OutsStoresStall]   = std::make_unique<Stats_cntr>(fmt::format("P({})_ExeEngine:nOutsStoresStall", i));
-  nStall[OutsBranchesStall] = std::make_unique<Stats_cntr>(fmt::format("P({})_ExeEngine:nOutsBranchesStall", i));
-  nStall[ReplaysStall]      = std::make_unique<Stats_cntr>(fmt::format("P({})_ExeEngine:nReplaysStall", i));
-  nStall[SyscallStall]      = std::make_unique<Stats_cntr>(fmt::format("P({})_ExeEngine:nSyscallStall", i));
+  for (auto c = 1; c < MaxStall; ++c) {
+    nStall[c] = std::make_unique<Stats_cntr>(fmt::format("P({})_ExeEngine:n{}", i, stall_names[c]));
+  }
+
+  lastStall      = NoStall;
+  lastStallPC    = 0;
+  lastStallClock = 0;
+  if (Config::has_entry("soc", "core", i, "cycle_profile")) {
+    std::vector<std::string> causes(stall_names.begin(), stall_names.end());
+    causes.emplace_back("Frontend");
+    causes.emplace_back("Execute");
+    causes.emplace_back("Commit");
+
+    cycleProfile     = std::make_unique<Pprof>("retire_slots", "count", causes);
+    cycleProfileFile = fmt::format("{}.P{}.pb", Config::get_string("soc", "core", i, "cycle_profile"), i);
+
+    // Symbols from cycle_profile_elf, or else from the binary that the emul loads
+    if (Config::has_entry("soc", "core", i, "cycle_profile_elf")) {
+      auto elf = Config::get_string("soc", "core", i, "cycle_profile_elf");
+      if (!cycleProfile->load_symbols(elf)) {
+        Config::add_error(fmt::format("core {} cycle_profile_elf {} has no ELF64 function symbols", i, elf));
+      }
+    } else if (Config::has_entry("soc", "emul", i, "bench")) {
+      auto bench = Config::get_string("soc", "emul", i, "bench");
+      cycleProfile->load_symbols(bench.substr(0, bench.find(' ')));
+    }
+  }
 
   I(ROB.size() == 0);
 
@@ -77,6 +98,58 @@ GProcessor::GProcessor(std::shared_ptr<Gmemory_system> gm, Hartid_t i)
 
 GProcessor::~GProcessor() {}
 
+void GProcessor::icb_retire_fetch(Dinst* dinst) { icb->retireFetch(dinst->getPC(), dinst->has_stats()); }
+
+void GProcessor::profile_stalled(int32_t nretired)
+/* charge the retire slots left this cycle {{{1 */
+{
+  if (!cycleProfile || nretired >= RetireWidth) {
+    return;
+  }
+
+  // Blame the oldest instruction, with the rename stall of the cycle as
+  // cause if there was one
+  Dinst* head  = nullptr;
+  size_t cause = prof_frontend;
+  if (!rROB.empty()) {
+    head  = rROB.top();
+    cause = prof_commit;
+  } else if (!ROB.empty()) {
+    head  = ROB.top();
+    cause = prof_execute;
+  }
+
+  bool   stalled = lastStallClock == globalClock && lastStall != NoStall;
+  Addr_t pc      = 0;
+  if (stalled) {
+    cause = lastStall;
+    pc    = lastStallPC;
+  }
+  if (head) {
+    if (!head->has_stats()) {
+      return;
+    }
+    pc = head->getPC();
+  } else if (!use_stats) {
+    return;
+  }
+
+  cycleProfile->add(cause, pc, RetireWidth - nretired);
+}
+/* }}} */
+
+void GProcessor::report() {
+  if (!cycleProfile) {
+    return;
+  }
+
+  if (!cycleProfile->write(cycleProfileFile)) {
+    fmt::print(stderr, "could not write cycle profile {}\n", cycleProfileFile);
+    return;
+  }
+  Report::field(fmt::format("P({})_cycle_profile={}", hid, cycleProfileFile));
+}
+
 void GProcessor::buildInstStats(const std::string& txt) {
   for (const auto t : Opcodes) {
     nInst[t] = std::make_unique<Stats_cntr>(fmt::format("P({})_{}_{}:n", hid, txt, t));
@@ -182,10 +255,12 @@ void GProcessor::flush_transient_inst_on_fetch_ready() {
   flushing_last_transientid =last_transientid;
   pipeQ.pipeLine.set_flushing_from_last_transientid(flushing_last_transientid);
 
+  bool restored = restore_rat_checkpoint();
+
   flush_transient_inst_from_inst_queue();
   pipeQ.pipeLine.flush_transient_inst_from_buffer();
   pipeQ.pipeLine.flush_transient_inst_from_received_bucket();
-  flush_transient_from_rob();
+  flush_transient_from_rob(!restored);
   flush_transient_from_scb();
   // Do NOT flush_transient_ports(): cbQ still holds Resource::executingCB /
   // executedCB pointing at these dinsts. If retire destroys them first, the
@@ -220,7 +295,14 @@ void GProcessor::dump_rob()
   }
 }
 
-void GProcessor::flush_transient_from_rob() {
+void GProcessor::flush_transient_from_rob(bool walk_rat) {
+  // A restored checkpoint already removed the transient rename table entries
+  auto clear_rat = [walk_rat](Dinst* d) {
+    if (walk_rat) {
+      d->clearRATEntry();
+    }
+  };
+
   // try the for loop scan
   //printf("gprocessor::flush_transient_rob on before new fetch!!!\n");
   while (!ROB.empty()) {
@@ -236,7 +318,7 @@ void GProcessor::flush_transient_from_rob() {
       continue;
     }*/
 
-    dinst->clearRATEntry();
+    clear_rat(dinst);
 
     // if(dinst)
     dinst->mark_destroy_transient();
@@ -250,7 +332,7 @@ void GProcessor::flush_transient_from_rob() {
       if (hasDest && !dinst->is_try_flush_transient()) {
         dinst->getCluster()->add_reg_pool();
       }
-      dinst->clearRATEntry();
+      clear_rat(dinst);
       dinst->getCluster()->try_flushed(dinst);
       try_flush(dinst);
       // dinst->getCluster()->delEntry();:: happens automatically in cluster::ExecutedCluster ::delEntry()
@@ -262,7 +344,7 @@ void GProcessor::flush_transient_from_rob() {
         continue;
       }
       dinst->mark_flush_transient();
-      dinst->clearRATEntry();
+      clear_rat(dinst);
       dinst->getCluster()->try_flushed(dinst);
       // limasep2024dinst->mark_del_entry();
       dinst->getCluster()->del_entry_flush(dinst);
@@ -282,7 +364,7 @@ void GProcessor::flush_transient_from_rob() {
         ROB.pop_from_back();
         continue;
       }
-      dinst->clearRATEntry();
+      clear_rat(dinst);
       dinst->getCluster()->try_flushed(dinst);
       // lima2024sepdinst->mark_del_entry();
       dinst->getCluster()->del_entry_flush(dinst);
@@ -310,7 +392,7 @@ void GProcessor::flush_transient_from_rob() {
         }
 
         dinst->markExecutedTransient();
-        dinst->clearRATEntry();
+        clear_rat(dinst);
         dinst->getCluster()->try_flushed(dinst);
         try_flush(dinst);
         // 2024_sep//
@@ -486,6 +568,7 @@ int32_t GProcessor::issue() {
       StallCause c = add_inst(dinst);
       //printf("gprocessor::issue inst  %llu at @clockcycle %llu\n", dinst->getID(), globalClock);
       if (c != NoStall) {
+        set_last_stall(c, dinst->getPC());
         if (i < RealisticWidth) {
           nStall[c]->add(RealisticWidth - i, dinst->has_stats());
         }
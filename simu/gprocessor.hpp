@@ -24,6 +24,7 @@
 #include "instruction.hpp"
 #include "lsq.hpp"
 #include "pipeline.hpp"
+#include "pprof.hpp"
 #include "prefetcher.hpp"
 #include "resource.hpp"
 #include "simu_base.hpp"
@@ -68,6 +69,7 @@ protected:
 
   size_t                          smt_size;
   std::shared_ptr<Gmemory_system> memorySystem;
+  MemObj*                         icb;  // IL1 when it is an Icb, told about the non-transient pre-retires
 
   std::shared_ptr<StoreSet>     storeset;
   std::shared_ptr<Prefetcher>   prefetcher;
@@ -96,6 +98,41 @@ protected:
 
   // END Statistics
 
+  // Cycle accounting: each retire slot is charged to a PC and a cause. The
+  // causes are the StallCause ones (NoStall is a slot that retired) and the
+  // prof_* ones past MaxStall
+  static constexpr std::array<const char*, MaxStall> stall_names
+      = {"Retire", "SmallWinStall", "SmallROBStall", "SmallREGStall", "DivergeStall", "OutsLoadsStall",
+         "OutsStoresStall", "OutsBranchesStall", "ReplaysStall", "SyscallStall", "CheckpointStall"};
+  static constexpr size_t prof_frontend = MaxStall;      // nothing to retire
+  static constexpr size_t prof_execute  = MaxStall + 1;  // oldest not executed yet
+  static constexpr size_t prof_commit   = MaxStall + 2;  // oldest executed, waiting to retire
+
+  std::unique_ptr<Pprof> cycleProfile;
+  std::string            cycleProfileFile;
+  StallCause             lastStall;
+  Addr_t                 lastStallPC;
+  Time_t                 lastStallClock;
+
+  void set_last_stall(StallCause c, Addr_t pc) {
+    lastStall      = c;
+    lastStallPC    = pc;
+    lastStallClock = globalClock;
+  }
+  void profile_retired(Dinst* dinst, StallCause c = NoStall) {
+    if (cycleProfile && dinst->has_stats()) {
+      cycleProfile->add(c, dinst->getPC(), 1);
+    }
+  }
+  void profile_stalled(int32_t nretired);
+
+  void icb_preretire(Dinst* dinst) {
+    if (icb && !dinst->isTransient()) {
+      icb_retire_fetch(dinst);
+    }
+  }
+  void icb_retire_fetch(Dinst* dinst);
+
   uint64_t lastReplay;
 
   // Construction
@@ -155,13 +192,18 @@ public:
   void flush_transient_inst_from_inst_queue();
   void flush_remaining_transient_inst_from_inst_queue();
 
-  void flush_transient_from_rob();
+  // Restore the rename tables of the resolved mispredicted branch before a
+  // transient flush. False when the flush has to repair them walking the ROB.
+  virtual bool restore_rat_checkpoint() { return false; }
+
+  void flush_transient_from_rob(bool walk_rat = true);
   void flush_transient_from_scb();
   void flush_transient_ports();
 
   void register_owned_port(std::shared_ptr<PortGeneric> p) { owned_ports.push_back(std::move(p)); }
   void dump_rob();
   void report(const std::string& str);
+  void report() override;
 
   // Addr_t   random_addr_gen();
   uint64_t random_reg_gen(bool reg);
@@ -8,6 +8,7 @@
 
 #include "callback.hpp"
 #include "dinst.hpp"
+#include "host_profile.hpp"
 #include "iassert.hpp"
 #include "mrouter.hpp"
 #include "port.hpp"
@@ -23,6 +24,8 @@ class MemRequest;
 #define PSIGN_INDIRECT   5
 #define PSIGN_CHASE      6
 #define PSIGN_MEGA       7
+#define PSIGN_BOP        8
+#define PSIGN_REGION     9
 #define LDBUFF_SIZE      512
 #define CIR_QUEUE_WINDOW 512  // FIXME: need to change this to a conf variable
 
@@ -48,6 +51,8 @@ protected:
 
   const uint16_t  id;
   static uint16_t id_counter;
+
+  Host_profile::Slot* hostSlot;  // host time of the entry points (see MemRequest)
   int16_t         coreid;
   bool            firstLevelIL1;
   bool            firstLevelDL1;
@@ -66,6 +71,7 @@ public:
   const std::string& getName() const { return name; }
   const std::string& get_type() const { return mem_type; }
   uint16_t           getID() const { return id; }
+  Host_profile::Slot& get_host_slot() const { return *hostSlot; }
   int16_t            getCoreID() const { return coreid; }
   void               setCoreDL1(int16_t cid) {
     coreid        = cid;
@@ -81,7 +87,7 @@ public:
 
   MRouter* getRouter() { return router; }
 
-  virtual void tryPrefetch(Addr_t addr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb = 0) = 0;
+  virtual void tryPrefetch(Addr_t addr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb = 0, Time_t age = 0) = 0;
 
   // Interface for fast-forward (no BW, just warmup caches)
   virtual TimeDelta_t ffread(Addr_t addr)  = 0;
@@ -115,6 +121,7 @@ public:
   virtual void updateXCoreStores(Addr_t addr);
   virtual void replayflush();
   virtual void plug();
+  virtual void retireFetch(Addr_t pc, bool doStats);  // non-transient pre-retire of pc (Icb)
 
   virtual void setNeedsCoherence();
   virtual void clearNeedsCoherence();
@@ -146,7 +153,7 @@ public:
   TimeDelta_t ffread(Addr_t addr);
   TimeDelta_t ffwrite(Addr_t addr);
 
-  void tryPrefetch(Addr_t addr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb = 0);
+  void tryPrefetch(Addr_t addr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb = 0, Time_t age = 0);
 
   bool isBusy(Addr_t addr) const;
 };
@@ -6,6 +6,7 @@
 
 #include "cluster.hpp"
 #include "config.hpp"
+#include "host_profile.hpp"
 #include "memobj.hpp"
 #include "memstruct.hpp"
 #include "pipeline.hpp"
@@ -28,36 +29,44 @@ MemRequest::~MemRequest()
 
 void MemRequest::redoReq() {
   upce();
+  Host_scope scope(currMemObj->get_host_slot());
   currMemObj->doReq(this);
 }
 void MemRequest::redoReqAck() {
   upce();
+  Host_scope scope(currMemObj->get_host_slot());
   currMemObj->doReqAck(this);
 }
 void MemRequest::redoSetState() {
   upce();
+  Host_scope scope(currMemObj->get_host_slot());
   currMemObj->doSetState(this);
 }
 void MemRequest::redoSetStateAck() {
   upce();
+  Host_scope scope(currMemObj->get_host_slot());
   currMemObj->doSetStateAck(this);
 }
 void MemRequest::redoDisp() {
   upce();
+  Host_scope scope(currMemObj->get_host_slot());
   currMemObj->doDisp(this);
 }
 
 void MemRequest::startReq() {
   I(mt == mt_req);
+  Host_scope scope(currMemObj->get_host_slot());
   currMemObj->req(this);
 }
 void MemRequest::startReqAck() {
   I(mt == mt_reqAck || prefetch);
+  Host_scope scope(currMemObj->get_host_slot());
   currMemObj->reqAck(this);
 }
 void MemRequest::startSetState() {
   I(mt == mt_setState);
   I(!prefetch);
+  Host_scope scope(currMemObj->get_host_slot());
   currMemObj->setState(this);
 }
 void MemRequest::startSetStateAck() {
@@ -66,6 +75,7 @@ void MemRequest::startSetStateAck() {
     I(!prefetch);
   }
 
+  Host_scope scope(currMemObj->get_host_slot());
   currMemObj->setStateAck(this);
 }
 void MemRequest::startDisp() {
@@ -138,6 +148,7 @@ MemRequest* MemRequest::create(MemObj* mobj, Addr_t addr, bool keep_stats, Callb
   r->cb                 = cb;
   r->startClock         = globalClock;
   r->prefetch           = false;
+  r->age                = 0;
   r->notifyScbDirectly  = false;
   r->spec               = false;
   r->dropped            = false;
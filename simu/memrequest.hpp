@@ -94,6 +94,7 @@ private:
   Dinst*  dinst;      // WARNING: valid IFF demand DL1
   Addr_t  pref_sign;  // WARNING: valid IFF prefetch is true
   int32_t degree;     // WARNING: valid IFF prefetch is true
+  Time_t  age;        // WARNING: valid IFF prefetch is true. 0 untagged, else smaller is older
   /* }}} */
 
   MemRequest();
@@ -217,7 +218,7 @@ public:
     m->req(mreq);
   }
   static MemRequest* createReqReadPrefetch(MemObj* m, bool keep_stats, Addr_t addr, Addr_t pref_sign, int32_t degree, Addr_t pc,
-                                           CallbackBase* cb = 0) {
+                                           CallbackBase* cb = 0, Time_t age = 0) {
     MemRequest* mreq      = create(m, addr, keep_stats, cb);
     mreq->prefetch        = true;
     mreq->topCoherentNode = 0;
@@ -227,10 +228,12 @@ public:
     mreq->pc              = pc;
     mreq->degree          = degree;
     mreq->pref_sign       = pref_sign;
+    mreq->age             = age;
     return mreq;
   }
   [[nodiscard]] int32_t getDegree() const { return degree; }
   [[nodiscard]] Addr_t  getSign() const { return pref_sign; }
+  [[nodiscard]] Time_t  getAge() const { return age; }
 
   static void sendNCReqRead(MemObj* m, bool keep_stats, Addr_t addr, CallbackBase* cb = nullptr) {
     MemRequest* mreq   = create(m, addr, keep_stats, cb);
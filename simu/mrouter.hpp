@@ -84,8 +84,8 @@ public:
   int32_t sendSetStateOthersPos(uint32_t pos, MemRequest* mreq, MsgAction ma, TimeDelta_t lat = 0);
   int32_t sendSetStateAll(MemRequest* mreq, MsgAction ma, TimeDelta_t lat = 0);
 
-  void tryPrefetch(Addr_t addr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb = 0);
-  void tryPrefetchPos(uint32_t pos, Addr_t addr, int degree, bool doStats, Addr_t pref_sign, Addr_t pc, CallbackBase* cb = 0);
+  void tryPrefetch(Addr_t addr, bool doStats, int degree, Addr_t pref_sign, Addr_t pc, CallbackBase* cb = 0, Time_t age = 0);
+  void tryPrefetchPos(uint32_t pos, Addr_t addr, int degree, bool doStats, Addr_t pref_sign, Addr_t pc, CallbackBase* cb = 0, Time_t age = 0);
 
   TimeDelta_t ffread(Addr_t addr);
   TimeDelta_t ffwrite(Addr_t addr);
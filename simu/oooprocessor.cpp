@@ -32,6 +32,11 @@ OoOProcessor::OoOProcessor(std::shared_ptr<Gmemory_system> gm, CPU_t i)
     , MemoryReplay(Config::get_bool("soc", "core", i, "memory_replay"))
     , RetireDelay(Config::get_integer("soc", "core", i, "commit_delay"))
     , lsq(i, Config::get_integer("soc", "core", i, "ldq_size", 1))
+    , nCheckpointTaken(fmt::format("P({})_rat_ckpt_taken", i))
+    , nCheckpointExhausted(fmt::format("P({})_rat_ckpt_exhausted", i))
+    , nCheckpointRestore(fmt::format("P({})_rat_ckpt_restore", i))
+    , nCheckpointWalk(fmt::format("P({})_rat_ckpt_walk", i))
+    , avgCheckpointUsed(fmt::format("P({})_rat_ckpt_used", i))
     , retire_lock_checkCB(this)
     , clusterManager(gm, i, this)
 #ifdef TRACK_TIMELEAK
@@ -71,6 +76,22 @@ OoOProcessor::OoOProcessor(std::shared_ptr<Gmemory_system> gm, CPU_t i)
   forwardProg_threshold = 200;
 
   scooreMemory = Config::get_bool("soc", "core", gm->getCoreId(), "scoore_serialize");
+
+  nCheckpoints = Config::get_integer("soc", "core", i, "max_branches");
+  if (Config::has_entry("soc", "core", i, "rat_checkpoints")) {
+    nCheckpoints = Config::get_integer("soc", "core", i, "rat_checkpoints", 1, 65536);
+  }
+  if (nCheckpoints == 0) {
+    nCheckpoints = MaxROBSize;  // max_branches = 0 has no limit
+  }
+  checkpointStall = false;
+  if (Config::has_entry("soc", "core", i, "rat_checkpoint_stall")) {
+    checkpointStall = Config::get_bool("soc", "core", i, "rat_checkpoint_stall");
+  }
+
+  nFreeCheckpoints      = nCheckpoints;
+  restorePending        = false;
+  missWithoutCheckpoint = false;
 }
 /* }}} */
 
@@ -120,6 +141,7 @@ bool OoOProcessor::advance_clock_drain() {
       lastReplay = replayID;
     } else {
       nStall[ReplaysStall]->add(RealisticWidth, use_stats);
+      set_last_stall(ReplaysStall, 0);
       retire();
       //printf("OOOProc::advance_clock_drain :: ::ROB !empty():recovering:: return true at @Clockcyle %lu\n", globalClock);
       return true;
@@ -223,6 +245,73 @@ void OoOProcessor::executing(Dinst* dinst)
 }
 // 1}}}
 //
+void OoOProcessor::take_checkpoint(Dinst* dinst)
+/* allocate a rename checkpoint to a renamed branch {{{1 */
+{
+  if (nFreeCheckpoints == 0) {
+    nCheckpointExhausted.inc(dinst->has_stats());
+    return;
+  }
+
+  nFreeCheckpoints--;
+  branchCheckpoint.insert(dinst->getID());
+  nCheckpointTaken.inc(dinst->has_stats());
+  avgCheckpointUsed.sample(nCheckpoints - nFreeCheckpoints, dinst->has_stats());
+}
+/* }}} */
+
+void OoOProcessor::release_checkpoint(Dinst* dinst)
+/* free the checkpoint of a resolved branch, or keep it to recover the miss {{{1 */
+{
+  bool has = branchCheckpoint.erase(dinst->getID()) != 0;
+
+  if (dinst->isBranchMiss() && do_random_transients) {
+    if (has) {
+      I(!restorePending);
+      restorePending = true;
+    } else {
+      missWithoutCheckpoint = true;
+    }
+  } else if (has) {
+    nFreeCheckpoints++;
+  }
+}
+/* }}} */
+
+void OoOProcessor::drop_transient_producers(RegType_array<Dinst*>& rat) {
+  for (auto& d : rat) {
+    if (d && d->isTransient()) {
+      d = nullptr;
+    }
+  }
+}
+
+bool OoOProcessor::restore_rat_checkpoint()
+/* recover the tables of the resolved mispredicted branch {{{1 */
+{
+  if (missWithoutCheckpoint) {
+    missWithoutCheckpoint = false;
+    nCheckpointWalk.inc(use_stats);
+    return false;
+  }
+  if (!restorePending) {
+    return false;
+  }
+
+  // Every transient in the ROB is flushed, so this leaves the tables as the
+  // clearRATEntry calls of the walk would. The ROB walk still runs to free
+  // the wrong path registers and window entries
+  drop_transient_producers(TRAT);
+  drop_transient_producers(serializeRAT);
+
+  nFreeCheckpoints++;
+  restorePending = false;
+  nCheckpointRestore.inc(use_stats);
+
+  return true;
+}
+/* }}} */
+
 void OoOProcessor::executed([[maybe_unused]] Dinst* dinst) {
   // printf("OOOProc::Executed::dump_rat is called\n");
   // dump_rat();
@@ -236,6 +325,10 @@ void OoOProcessor::executed([[maybe_unused]] Dinst* dinst) {
   fwdDone[dinst->getInst()->getDst1()] = globalClock;
   fwdDone[dinst->getInst()->getDst2()] = globalClock;
 #endif
+
+  if (!dinst->isTransient() && dinst->getInst()->isControl()) {
+    release_checkpoint(dinst);
+  }
 }
 void OoOProcessor::flushed(Dinst* dinst)
 // {{{1 Called when the instruction is flushed
@@ -275,11 +368,17 @@ StallCause OoOProcessor::add_inst(Dinst* dinst) {
     return SmallREGStall;
   }
 
-  auto cluster = dinst->getCluster();
+  bool checkpoint = !dinst->isTransient() && inst->isControl();
+  if (checkpoint && checkpointStall && nFreeCheckpoints == 0) {
+    Tracer::stage(dinst, "Wckp");
+    return CheckpointStall;
+  }
+
+  auto* cluster = dinst->getCluster();
   if (!cluster) {
     auto res = clusterManager.getResource(dinst);
-    cluster  = res->getCluster();
-    dinst->set(cluster, res);
+    cluster  = res->getCluster().get();
+    dinst->set(cluster, res.get());
   }
 
   StallCause sc = cluster->canIssue(dinst);
@@ -295,6 +394,10 @@ StallCause OoOProcessor::add_inst(Dinst* dinst) {
   // BEGIN INSERTION (note that cluster already inserted in the window)
   // dinst->dump("");
 
+  if (checkpoint) {
+    take_checkpoint(dinst);
+  }
+
 #ifndef LATE_ALLOC_REGISTER
   if (inst->hasDstRegister()) {
     nTotalRegs--;
@@ -479,19 +582,6 @@ StallCause OoOProcessor::add_inst(Dinst* dinst) {
   // printf("OOOProc::add_inst and dumprat after adding in RAT%ld\n", dinst->getID());
   // dump_rat();
 
-#ifdef WAVESNAP_EN
-  // add instruction to wavesnap
-  if (!SINGLE_WINDOW) {
-    if (WITH_SAMPLING) {
-      if (dinst->has_stats()) {
-        snap->add_instruction(dinst);
-      }
-    } else {
-      snap->add_instruction(dinst);
-    }
-  }
-#endif
-
   // if(!dinst->is_in_cluster()) {
   // dinst->getCluster()->add_inst_retry(dinst);
   // lima}
@@ -611,6 +701,7 @@ void OoOProcessor::retire() {
       continue;
     } else {
       Tracer::event(dinst, "PNR");
+      icb_preretire(dinst);
       rROB.push(dinst);
       ROB.pop();
       //printf("OOOProcessor::retire::poping from ROB Inst %lu and ROB size is %zu and rROB size is %zu\n",
@@ -693,6 +784,7 @@ void OoOProcessor::retire() {
   }  // rROB_empty ends here
 
   // Real  rROB_loop_starts
+  int32_t nretired = 0;
   for (uint16_t i = 0; i < RetireWidth && !rROB.empty(); i++) {
     Dinst* dinst = rROB.top();
     dinst->mark_rrob();
@@ -747,6 +839,8 @@ void OoOProcessor::retire() {
     }
 
     nCommitted.inc(!flushing && dinst->has_stats());
+    profile_retired(dinst, flushing ? ReplaysStall : NoStall);
+    nretired++;
 
 #ifdef ESESC_BRANCHPROFILE
     if (dinst->getInst()->isBranch() && dinst->has_stats()) {
@@ -841,6 +935,8 @@ void OoOProcessor::retire() {
     //printf("OOOProcessor::retire::After rROB.pop  rROB size is %ld and rROB size is %ld\n", ROB.size(), rROB.size());
     // dumpROB();
   }  // !rROB.empty()_loop_ends
+
+  profile_stalled(nretired);
 }
 
 void OoOProcessor::replay(Dinst* target)
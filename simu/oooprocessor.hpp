@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <vector>
 
+#include "absl/container/flat_hash_set.h"
 #include "callback.hpp"
 #include "fastqueue.hpp"
 #include "fetchengine.hpp"
@@ -65,6 +66,28 @@ private:
   Time_t replayID;
   bool   flushing;
 
+  // Budget of rename checkpoints at renamed branches (rat_checkpoints,
+  // max_branches by default). No copy of the tables is taken: wrong path
+  // instructions only rename into TRAT (and serializeRAT), so a miss with a
+  // checkpoint drops their entries in one pass, with the same result as the
+  // walk. The ROB is walked either way. Without a free checkpoint rename
+  // stalls when rat_checkpoint_stall is set.
+  uint32_t                    nCheckpoints;
+  uint32_t                    nFreeCheckpoints;
+  absl::flat_hash_set<Time_t> branchCheckpoint;  // IDs of the branches with a checkpoint
+  bool                        restorePending;
+  bool                        missWithoutCheckpoint;
+  bool                        checkpointStall;
+
+  Stats_cntr nCheckpointTaken;
+  Stats_cntr nCheckpointExhausted;
+  Stats_cntr nCheckpointRestore;
+  Stats_cntr nCheckpointWalk;
+  Stats_avg  avgCheckpointUsed;
+
+  void take_checkpoint(Dinst* dinst);
+  void release_checkpoint(Dinst* dinst);
+
   Hartid_t flushing_fid;
 
   RetireState                                                           last_state;
@@ -101,10 +124,14 @@ public:
   void   try_flush(Dinst* dinst) override final;
   LSQ*   getLSQ() override final { return &lsq; }
   void   replay(Dinst* target) override final;
+  bool   restore_rat_checkpoint() override final;
   bool   is_nuking() override final { return flushing; }
   bool   isReplayRecovering() override final { return replayRecovering; }
   Time_t getReplayID() override final { return replayID; }
 
+  // Clears the entries of wrong path (transient) producers, as the ROB walk does
+  static void drop_transient_producers(RegType_array<Dinst*>& rat);
+
   void dump_rat() {
     // auto rat_max= static_cast <int> ( RegType::LREG_MAX);
 
@@ -25,8 +25,6 @@ void IBucket::markFetched() {
   pipeLine->readyItem(this);
 }
 
-bool PipeIBucketLess::operator()(const IBucket* x, const IBucket* y) const { return x->getPipelineId() > y->getPipelineId(); }
-
 Pipeline::Pipeline(size_t s, size_t fetch, int32_t maxReqs)
     : PipeLength(s)
     , bucketPoolMaxSize(s + 2 + maxReqs)
@@ -35,10 +33,19 @@ Pipeline::Pipeline(size_t s, size_t fetch, int32_t maxReqs)
     , nIRequests(maxReqs)
     , buffer(s + 1 + maxReqs)
     , transient_buffer(s + 2 + maxReqs)
+    , nReceived(0)
 
 {
+  size_t ring_size = 64;
+  while (ring_size < bucketPoolMaxSize) {
+    ring_size <<= 1;
+  }
+  ring.resize(ring_size, nullptr);
+  ringReady.resize(ring_size / 64, 0);
+  ringMask = ring_size - 1;
+
   maxItemCntr = 0;
-  minItemCntr = 0;  // next ticket number to serve; should be the lowerest inorder; the outoforder are kept in received.
+  minItemCntr = 0;  // next ticket number to serve; should be the lowerest inorder; the outoforder are kept in ring.
 
   bucketPool.reserve(bucketPoolMaxSize);
   I(bucketPool.empty());
@@ -62,12 +69,59 @@ Pipeline::~Pipeline() {
     delete buffer.top();
     buffer.pop();
   }
-  while (!received.empty()) {
-    delete received.top();
-    received.pop();
+  for (auto id = minItemCntr; id < maxItemCntr; ++id) {
+    if (is_ring_ready(id)) {
+      delete take_ring(id);  // nullptr for flushed IDs
+    }
   }
 }
 
+void Pipeline::grow_ring(Time_t id) {
+  if (id - minItemCntr <= ringMask) {
+    return;
+  }
+
+  auto old_ring  = std::move(ring);
+  auto old_ready = std::move(ringReady);
+  auto old_mask  = ringMask;
+
+  auto ring_size = old_ring.size();
+  while (id - minItemCntr >= ring_size) {
+    ring_size <<= 1;
+  }
+  ring.assign(ring_size, nullptr);
+  ringReady.assign(ring_size / 64, 0);
+  ringMask = ring_size - 1;
+
+  for (auto i = minItemCntr; i < maxItemCntr; ++i) {
+    auto pos = i & old_mask;
+    if ((old_ready[pos >> 6] >> (pos & 63)) & 1) {
+      set_ring_ready(i, old_ring[pos]);
+    }
+  }
+}
+
+void Pipeline::set_ring_ready(Time_t id, IBucket* b) {
+  I(id >= minItemCntr);
+  I(id - minItemCntr <= ringMask);
+  I(!is_ring_ready(id));
+
+  auto pos = id & ringMask;
+  ring[pos] = b;
+  ringReady[pos >> 6] |= (1ULL << (pos & 63));
+}
+
+IBucket* Pipeline::take_ring(Time_t id) {
+  I(is_ring_ready(id));
+
+  auto pos = id & ringMask;
+  ringReady[pos >> 6] &= ~(1ULL << (pos & 63));
+
+  IBucket* b = ring[pos];
+  ring[pos]  = nullptr;
+  return b;
+}
+
 // push fetched Inst(IF->PipelineQ) into PipelineQ
 // Buffer is the biggest one: buckets resides inside buffer
 void Pipeline::readyItem(IBucket* b) {
@@ -114,7 +168,8 @@ void Pipeline::readyItem(IBucket* b) {
     // printf("Pipeline::readyitem::recived.push(bucket)::not actual !buffer.push() inst  %llu at @clockcycle %llu\n",
            // b->top()->getID(),
            // globalClock);
-    received.push(b);
+    set_ring_ready(b->getPipelineId(), b);
+    nReceived++;
     return;
   }
 
@@ -149,29 +204,17 @@ void Pipeline::clearItems() {
   //flushedPipelineIDs={4,5,10}
   //mintitemcnt=3 :waiting for pipeiD=3
   
-  while (true) {
-      // Check if minItemCntr was already freed during transient flush
-    auto it = std::find(flushedPipelineIDs.begin(), flushedPipelineIDs.end(), minItemCntr);
-    if (it != flushedPipelineIDs.end()) {
-      //printf("Pipeline::clearitem::skipping flushed pipelineId %ld minItemCntr now %ld\n",
-               //minItemCntr, minItemCntr + 1);
-      flushedPipelineIDs.erase(it);
-      minItemCntr++;
-      continue;  // keep looping — next ID might also be in flushedPipelineIDs
-    }
-    
-    if (received.empty()) {
-      break;
-    }
-    IBucket* b = received.top();
-    if (b->getPipelineId() != minItemCntr) {
-      break;
-    }
-    //if(b->getPipelineId() == minItemCntr) starts herei!!!
-    received.pop();
+  while (minItemCntr < maxItemCntr && is_ring_ready(minItemCntr)) {
+    IBucket* b = take_ring(minItemCntr);
     minItemCntr++;
     //printf("Pipeline::clearitem::minItemCntr++ now %ld\n", minItemCntr);
-      
+
+    if (b == nullptr) {
+      continue;  // freed during transient flush, skip its pipelineId
+    }
+    I(nReceived > 0);
+    nReceived--;
+
     if (b->empty()) {
       doneItem(b);
     } else {
@@ -269,62 +312,47 @@ void Pipeline::flush_transient_inst_from_buffer() {
 void Pipeline::flush_transient_inst_from_received_bucket() {
   //printf("Pipeline::flush_transient_int_from_received_bucket Entering !!!\n");
   //printf("Pipeline::flush_transient_int_from_received_bucket Stocked bucketPool.Size is %ld\n", bucketPool.size());
-  std::vector<IBucket*> to_return;  // non-empty buckets go back into received
+  size_t pending = nReceived;
 
-  if(received.empty()) {
-    //printf("Pipeline::flush_transient_int_from_Received_bucket OH!!! Received empty return!!!\n");
-    return;
-  }
-
-  while (!received.empty()) {
-    IBucket* bucket = received.top();
-    received.pop();
-     //printf("Pipeline::flush_transient_int_from_Received_bucket New Bucket Started!!! \n");
+  for (auto id = minItemCntr; pending && id < maxItemCntr; ++id) {
+    if (ringReady[(id & ringMask) >> 6] == 0) {
+      id |= 63;  // nothing received in this word
+      continue;
+    }
+    if (!is_ring_ready(id)) {
+      continue;
+    }
 
-    if (bucket) {
-      while (!bucket->empty()) {
-       //printf("Pipeline::flush_transient_int_from_Received_bucket Bucket:: bucket->PipelineID is %lu and minItemCntr is %lu \n",
-               //bucket->getPipelineId(),
-               //minItemCntr);
-        auto* dinst = bucket->end_data();
-        I(dinst);
-        I(!dinst->is_present_in_rob());
-        if (dinst->isTransient()) {
-          //printf("Pipeline::flush_transient_int_from_received_bucket destroy instID %lu\n", dinst->getID());
-          dinst->destroyTransientInst();
-          bucket->pop_from_back();
-        } else {
-          //printf("Pipeline::flush_transient_int_from_received_bucket Not Transient so BREAK!!!instID %lu\n", dinst->getID());
-          break;// stop at first non-transient
-        }
-      }  // bucket_empty_while_loop_end
+    IBucket* bucket = ring[id & ringMask];
+    if (bucket == nullptr) {
+      continue;  // already flushed
+    }
+    pending--;
 
-      
-      if (bucket->empty()) {
-        // Save this pipelineId so clearItems() can advance minItemCntr past it
-        flushedPipelineIDs.push_back(bucket->getPipelineId());
-        // Free the bucket directly — doneItem's assert (pipelineId < minItemCntr)
-        // does not hold yet; clearItems() will advance minItemCntr when it sees
-        // this ID in flushedPipelineIDs
-        bucket->clock = 0;
-        bucket->reset_transient();
-        bucketPool.push_back(bucket);
-        //printf("Pipeline::flush_transient_int_from_Received_bucket Yahoo!!! bucket==empty!!! \n");
-        //printf("Pipeline::flush_received freed pipelineId %ld to pushing to bucketpool\n", bucket->getPipelineId());
-        //printf("Pipeline::flush_transient_int_from_received_bucket Stocked bucketPool.Size is %ld\n", bucketPool.size());
+    while (!bucket->empty()) {
+      auto* dinst = bucket->end_data();
+      I(dinst);
+      I(!dinst->is_present_in_rob());
+      if (dinst->isTransient()) {
+        //printf("Pipeline::flush_transient_int_from_received_bucket destroy instID %lu\n", dinst->getID());
+        dinst->destroyTransientInst();
+        bucket->pop_from_back();
       } else {
-        // Still has non-transient instructions — put back
-        to_return.push_back(bucket);
-        //printf("Pipeline::flush_transient_int_from_Received_bucket Yahoo!!! bucket!=empty!!! \n");
-        //printf("Pipeline::flush_received freed pipelineId %ld has Non Transient Inst :to_return\n", bucket->getPipelineId());
+        break;  // stop at first non-transient
       }
-    
-    
-    }//if_bucket_end
-}//received_empty_loop_end
-    for (auto* b : to_return) {
-      received.push(b);
     }
+
+    if (bucket->empty()) {
+      // Keep the pipelineId ready with no bucket so clearItems() can advance
+      // minItemCntr past it. Free the bucket directly: doneItem's assert
+      // (pipelineId < minItemCntr) does not hold yet
+      ring[id & ringMask] = nullptr;
+      nReceived--;
+      bucket->clock = 0;
+      bucket->reset_transient();
+      bucketPool.push_back(bucket);
+    }
+  }
   //printf("Pipeline::flush_transient_int_from_received_bucket Leaving !!!\n");
 }
       
@@ -493,6 +521,7 @@ IBucket* Pipeline::newItem() {
          //bucketPool.size(),
          //bucketPoolMaxSize);
 
+  grow_ring(maxItemCntr);
   b->setPipelineId(maxItemCntr);
 
   //printf("Pipeline::Newitem:: new item ::at bucket->PipelineId is %lu at @clockcycle %lu\n", maxItemCntr, globalClock);
@@ -506,4 +535,4 @@ IBucket* Pipeline::newItem() {
   return b;
 }
 
-bool Pipeline::hasOutstandingItems() const { return !buffer.empty() || !received.empty() || nIRequests < MaxIRequests; }
+bool Pipeline::hasOutstandingItems() const { return !buffer.empty() || nReceived > 0 || nIRequests < MaxIRequests; }
@@ -2,7 +2,6 @@
 
 #pragma once
 
-#include <queue>
 #include <set>
 #include <vector>
 
@@ -13,11 +12,6 @@
 using CPU_t = uint32_t;
 class IBucket;
 
-class PipeIBucketLess {
-public:
-  bool operator()(const IBucket* x, const IBucket* y) const;
-};
-
 class Pipeline {
 private:
   const size_t        PipeLength;
@@ -30,14 +24,24 @@ private:
   using IBucketCont = std::vector<IBucket*>;
   IBucketCont bucketPool;
 
-  // using ReceivedType = boost::heap::priority_queue<IBucket *,boost::heap::compare<PipeIBucketLess> >;
-  using ReceivedType = std::priority_queue<IBucket*, std::vector<IBucket*>, PipeIBucketLess>;
-  // std::priority_queue<IBucket *, std::vector<IBucket*>, PipeIBucketLess> received;
-  ReceivedType received;
+  // Pipeline IDs between minItemCntr and maxItemCntr, indexed by
+  // pipelineId & ringMask. A set ringReady bit means the ID is resolved:
+  // ring has the bucket fetched out-of-order (a cache can respond out of
+  // order), or nullptr if the bucket was flushed before its turn. The ring
+  // doubles when the IDs in flight do not fit.
+  std::vector<IBucket*> ring;
+  std::vector<uint64_t> ringReady;
+  Time_t                ringMask;
+  size_t                nReceived;
 
   Time_t maxItemCntr;
   Time_t minItemCntr;
 
+  [[nodiscard]] bool is_ring_ready(Time_t id) const { return (ringReady[(id & ringMask) >> 6] >> (id & 63)) & 1; }
+  void               set_ring_ready(Time_t id, IBucket* b);
+  IBucket*           take_ring(Time_t id);
+  void               grow_ring(Time_t id);
+
 protected:
   void clearItems();
 
@@ -49,8 +53,6 @@ public:
   Time_t flushing_from_last_transientid;
   void set_flushing_from_last_transientid(Time_t flushing_transientid) { flushing_from_last_transientid =  flushing_transientid; } 
   
-  std::vector<Time_t> flushedPipelineIDs;  // pipelineIds freed during transient flush
-
   // FastQueue<Dinst *>   transient_buffer;
   [[nodiscard]] IBucket* newItem();
   [[nodiscard]] bool     hasOutstandingItems() const;
@@ -76,7 +78,6 @@ protected:
   bool   transient;
 
   friend class Pipeline;
-  friend class PipeIBucketLess;
 
   Pipeline* const pipeLine;
 #ifndef NDEBUG
@@ -2,47 +2,110 @@
 
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include "addresspredictor.hpp"
 #include "cachecore.hpp"
 #include "callback.hpp"
 #include "port.hpp"
 #include "stats.hpp"
 
-#pragma once
-#include <memory>  
-
 class MemObj;
 
+// L1 prefetch engine with num_streams independent streams. A confident load
+// allocates (or refreshes) the stream of its PC; the LRU stream is replaced
+// when the table is full. Every cycle up to issue_width active streams issue
+// one prefetch each, and a stream issues at most once every issue_interval
+// cycles. Each stream has its own confidence, distance and degree.
+//
+// Feedback: every feedback_epoch issued prefetches, the DL1 nPrefetchUseful
+// and nPrefetchWasteful counters set the degree given to new streams (more
+// aggressive over 75% accuracy, less under 40%).
+//
+// train = "retire": the loads do not update the address predictor at execute.
+// Their training waits in a queue of train_queue entries and it is applied at
+// the (non-transient) pre-retire of the load, or discarded if the load was
+// transient. Any load, transient or not, can still start a stream with the
+// current tables. The prefetches carry the ID of the load that started the
+// stream as age, for the DL1 prefetch_queue priority.
 class Prefetcher {
 private:
-  MemObj* DL1;  // L1 cache
-  std::shared_ptr<Store_buffer> scb;  //NEW -- shared ownership matches gprocessor pattern
+  class Stream {
+  public:
+    Addr_t       pc;
+    Addr_t       last_addr;
+    Addr_t       spec_addr;  // address of the speculative load that induced the stream
+    FetchEngine* chain_fetch;
+    Time_t       age;          // ID of the load that started the stream
+    Time_t       last_use;     // LRU
+    Time_t       next_issue;   // issue throttling
+    int32_t      cur;
+    int32_t      degree;
+    int32_t      distance;
+    uint16_t     conf;
+    bool         active;
+    bool         statsFlag;
+    bool         spec;
+  };
+
+  class Train {
+  public:
+    Time_t id;
+    Addr_t pc;
+    Addr_t addr;
+    Data_t data;
+  };
+
+  MemObj*                       DL1;  // L1 cache
+  std::shared_ptr<Store_buffer> scb;
 
   Stats_avg  avgPrefetchNum;
   Stats_avg  avgPrefetchConf;
   Stats_hist histPrefetchDelta;
+  Stats_cntr nStreamAlloc;
+  Stats_cntr nStreamReplaced;  // active stream evicted by a new one
+  Stats_avg  avgActiveStreams;
+  Stats_avg  avgFeedbackDegree;
+  Stats_cntr nTrainCommit;
+  Stats_cntr nTrainSquash;  // transient loads
+  Stats_cntr nTrainFull;    // loads not trained, train_queue full
 
   std::unique_ptr<AddressPredictor> apred;
 
   int32_t degree;
   int32_t distance;
+  int32_t feedbackDegree;  // degree for new streams, adjusted by feedback
 
-  int32_t  curPrefetch;
   uint32_t lineSizeBits;
+  uint32_t issueWidth;
+  uint32_t issueInterval;
 
   Addr_t pref_sign;
 
-  bool         pending_prefetch;
-  Addr_t       pending_preq_pc;
-  uint16_t     pending_preq_conf;
-  bool         pending_statsFlag;
-  FetchEngine* pending_chain_fetch;
-  bool         inducing_spec_load;  //NEW -- was the load that induce this prefetch a spec load?
-  
-  uint16_t conf = 0;
-  Addr_t   pending_preq_addr;
-  Addr_t   inducing_spec_load_addr;  //NEW -- snapshot of the spec load's own address, stable across
-                                         // the whole prefetch chain. 
+  bool               retireTrain;
+  size_t             trainQueueSize;
+  std::vector<Train> trainQueue;
+
+  std::vector<Stream> streams;
+  size_t              rrStream;
+  bool                scheduled;
+
+  // Feedback
+  uint32_t    feedbackEpoch;
+  uint32_t    epochIssued;
+  std::string usefulName;
+  std::string wastefulName;
+  double      lastUseful;
+  double      lastWasteful;
+
+  [[nodiscard]] Stream* find_stream(Addr_t pc);
+  [[nodiscard]] Stream* alloc_stream();
+
+  void stop(Stream& s);
+  void issue(Stream& s);
+  void retire_train(Dinst* dinst);
+  void feedback();
 
   void nextPrefetch();
 
@@ -0,0 +1,85 @@
+// This file is distributed under the BSD 3-Clause License. See LICENSE for details.
+
+#include <vector>
+
+#include "dinst.hpp"
+#include "gtest/gtest.h"
+#include "oooprocessor.hpp"
+
+// The checkpoint recovery must leave the rename tables as the clearRATEntry
+// walk of flush_transient_from_rob does
+class Rename_checkpoint_test : public ::testing::Test {
+protected:
+  std::vector<Dinst*> insts;
+
+  void TearDown() override {
+    for (auto* dinst : insts) {
+      dinst->scrap();
+    }
+  }
+
+  Dinst* create(RegType dst, bool transient) {
+    auto* dinst = Dinst::create(Instruction(Opcode::iAALU, RegType::LREG_R1, RegType::LREG_R2, dst, RegType::LREG_InvalidOutput),
+                                0x1000 + 4 * insts.size(),
+                                0,
+                                0,
+                                true);
+    if (transient) {
+      dinst->setTransient();
+    }
+    insts.push_back(dinst);
+    return dinst;
+  }
+
+  // What OoOProcessor::add_inst does with the destination of a transient
+  static void rename(RegType_array<Dinst*>& trat, Dinst* dinst) {
+    auto dst = dinst->getInst()->getDst1();
+    dinst->setRAT1Entry(&trat[dst]);
+    dinst->setRAT2Entry(&trat[RegType::LREG_InvalidOutput]);
+    trat[dst] = dinst;
+  }
+};
+
+TEST_F(Rename_checkpoint_test, same_tables_as_the_walk) {
+  RegType_array<Dinst*> trat;
+  RegType_array<Dinst*> serialize;
+
+  // Older correct path memory producers in the serialize table
+  auto* p5 = create(RegType::LREG_R5, false);
+  auto* p6 = create(RegType::LREG_R6, false);
+  serialize[RegType::LREG_R5] = p5;
+  serialize[RegType::LREG_R6] = p6;
+
+  // Wrong path after the branch: registers renamed twice, and a serialize
+  // entry overwritten by a transient memory access
+  std::vector<Dinst*> wrong_path;
+  for (auto dst : {RegType::LREG_R3, RegType::LREG_R4, RegType::LREG_R3, RegType::LREG_R7}) {
+    auto* t = create(dst, true);
+    rename(trat, t);
+    wrong_path.push_back(t);
+  }
+  auto* t6 = create(RegType::LREG_R8, true);
+  t6->setRAT1Entry(&trat[RegType::LREG_InvalidOutput]);
+  t6->setRAT2Entry(&trat[RegType::LREG_InvalidOutput]);
+  t6->setSerializeEntry(&serialize[RegType::LREG_R6]);
+  serialize[RegType::LREG_R6] = t6;
+  wrong_path.push_back(t6);
+
+  auto ckpt_trat      = trat;
+  auto ckpt_serialize = serialize;
+  OoOProcessor::drop_transient_producers(ckpt_trat);
+  OoOProcessor::drop_transient_producers(ckpt_serialize);
+
+  // The ROB walk, youngest first
+  for (auto it = wrong_path.rbegin(); it != wrong_path.rend(); ++it) {
+    (*it)->clearRATEntry();
+  }
+
+  EXPECT_EQ(ckpt_trat, trat);
+  EXPECT_EQ(ckpt_serialize, serialize);
+
+  // Flushed producers are gone, not replaced by the older ones they renamed over
+  EXPECT_EQ(trat[RegType::LREG_R3], nullptr);
+  EXPECT_EQ(serialize[RegType::LREG_R5], p5);
+  EXPECT_EQ(serialize[RegType::LREG_R6], nullptr);
+}
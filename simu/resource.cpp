@@ -113,7 +113,13 @@ MemResource::MemResource(Opcode type, std::shared_ptr<Cluster> cls, std::shared_
 
 MemReplay::MemReplay(Opcode type, std::shared_ptr<Cluster> cls, std::shared_ptr<PortGeneric> _gen, std::shared_ptr<StoreSet> ss,
                      TimeDelta_t l, uint32_t cpuid)
-    : Resource(type, cls, _gen, l, cpuid), lfSize(8), storeset(ss) {
+    : Resource(type, cls, _gen, l, cpuid)
+    , lfSize(Config::has_entry("soc", "core", cpuid, "lf_size") ? Config::get_power2("soc", "core", cpuid, "lf_size", 1, 65536) : 8)
+    , lfAssoc(Config::has_entry("soc", "core", cpuid, "lf_assoc") ? Config::get_power2("soc", "core", cpuid, "lf_assoc", 1, lfSize)
+                                                                   : lfSize)
+    , lfSetMask(lfSize / lfAssoc - 1)
+    , storeset(ss)
+    , lfRand(cpuid) {
   lf.resize(lfSize);
 }
 
@@ -123,13 +129,15 @@ void MemReplay::replayManage(Dinst* dinst) {
   }
 
   int  pos     = -1;
-  int  pos2    = 0;
+  int  pos2    = -1;
   bool updated = false;
 
   SSID_t did = dinst->getSSID();
 
-  for (uint32_t i = 0; i < lfSize; i++) {
-    if (lf[pos2].id < lf[i].id && lf[i].ssid != did) {
+  auto set = ((dinst->getAddr() >> 2) & lfSetMask) * lfAssoc;
+
+  for (uint32_t i = set; i < set + lfAssoc; i++) {
+    if (lf[i].ssid != did && (pos2 == -1 || lf[pos2].id < lf[i].id)) {
       pos2 = i;
     }
 
@@ -168,23 +176,19 @@ void MemReplay::replayManage(Dinst* dinst) {
       continue;
     }
 
-    if (pos != -3) {
-      pos = -2;
-
-      SSID_t newid = storeset->mergeset(lf[i].ssid, did);
-      did          = newid;
-      lf[i].ssid   = newid;
-      lf[i].id     = dinst->getID();
-      lf[i].pc     = dinst->getPC();
-      lf[i].addr   = dinst->getAddr();
-      lf[i].op     = dinst->getInst()->getOpcode();
-      updated      = true;
-    }
+    pos = -2;
+
+    SSID_t newid = storeset->mergeset(lf[i].ssid, did);
+    did          = newid;
+    lf[i].ssid   = newid;
+    lf[i].id     = dinst->getID();
+    lf[i].pc     = dinst->getPC();
+    lf[i].addr   = dinst->getAddr();
+    lf[i].op     = dinst->getInst()->getOpcode();
+    updated      = true;
   }
 
-  static int rand = 0;
-  rand++;
-  if (pos >= 0 && (rand & 7) == 0) {
+  if (pos >= 0 && (lfRand() & 7) == 0) {
     int    i     = pos;
     SSID_t newid = storeset->mergeset(lf[i].ssid, dinst->getSSID());
     lf[i].ssid   = newid;
@@ -194,9 +198,9 @@ void MemReplay::replayManage(Dinst* dinst) {
     updated      = true;
   }
 
-  if (!updated) {
+  if (!updated && pos2 >= 0) {
     int i = pos2;
-    if (dinst->getID() > lf[i].id && dinst->getSSID() != lf[i].ssid) {
+    if (dinst->getID() > lf[i].id) {
 #ifndef NDEBUG
       fmt::print("3.merging {} and {} : pc {} and {} : addr {} and {} : id {} and {} ({})\n",
                  lf[i].ssid,
@@ -210,9 +214,6 @@ void MemReplay::replayManage(Dinst* dinst) {
                  dinst->getID() - lf[i].id);
 #endif
       storeset->mergeset(lf[i].ssid, dinst->getSSID());
-      if (lf[i].ssid > dinst->getSSID()) {
-        lf[i].ssid = dinst->getSSID();
-      }
 
       lf[i].ssid = dinst->getSSID();
       lf[i].id   = dinst->getID();
@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include <random>
+
 #include "bloomfilter.hpp"
 #include "callback.hpp"
 #include "fastqueue.hpp"
@@ -28,6 +30,7 @@ enum StallCause {
   OutsBranchesStall,
   ReplaysStall,
   SyscallStall,
+  CheckpointStall,
   MaxStall,
   Suspend
 };
@@ -102,12 +105,19 @@ public:
   void                 setUsedTime() { usedTime = globalClock; }
 };
 
+// Load forward table to train the store sets: lf_size entries (core
+// section, default 8) in sets of lf_assoc ways (default fully associative)
+// indexed by the access address, so each access only looks at one set.
 class MemReplay : public Resource {
 protected:
   const uint32_t lfSize;
+  const uint32_t lfAssoc;
+  const uint32_t lfSetMask;
 
   std::shared_ptr<StoreSet> storeset;
-  void                      replayManage(Dinst* dinst);
+  std::mt19937              lfRand;  // seeded per core, runs are reproducible
+
+  void replayManage(Dinst* dinst);
   struct FailType {
     FailType() { ssid = -1; }
     SSID_t ssid;
@@ -62,5 +62,8 @@ public:
   virtual bool        advance_clock()       = 0;
   virtual std::string get_type() const      = 0;
 
+  // Called once per core at report time
+  virtual void report() {}
+
   virtual size_t get_smt_size() const { return 1; }
 };
@@ -9,7 +9,9 @@
 #include "cluster.hpp"
 #include "config.hpp"
 #include "emul_base.hpp"
+#include "host_profile.hpp"
 #include "report.hpp"
+#include "stats_mirror.hpp"
 #include "tracer.hpp"
 
 void TaskHandler::report() {
@@ -22,6 +24,12 @@ void TaskHandler::report() {
     Report::field(fmt::format("OSSim:P({})simu_type={}", i, simus[i]->get_type()));
   }
 
+  for (size_t i = 0; i < simus.size(); i++) {
+    if (i == 0 || simus[i] != simus[i - 1]) {  // SMT harts share the simu
+      simus[i]->report();
+    }
+  }
+
   Report::field(fmt::format("OSSim:global_clock={}", globalClock));
 }
 /* }}} */
@@ -135,11 +143,20 @@ void TaskHandler::boot() {
     }
   }
 
+  std::vector<Host_profile::Slot*> simuSlot;
+  for (const auto& m : allmaps) {
+    simuSlot.push_back(&Host_profile::get(fmt::format("simu:P({})", m.fid)));
+  }
+  auto& eventSlot = Host_profile::get("event:advanceClock");
+  Host_profile::start();
+  Stats_mirror::start();
+
   EventScheduler::advanceClock();
 
   while (!running.empty()) {
     // advance cores & check for deactivate
     for (auto hid : running) {
+      Host_scope scope(*simuSlot[hid]);
       if (likely(!allmaps[hid].deactivating)) {
         allmaps[hid].simu->advance_clock();
         continue;
@@ -155,8 +172,31 @@ void TaskHandler::boot() {
       }
     }
 
-    EventScheduler::advanceClock();
+    {
+      Host_scope scope(eventSlot);
+      EventScheduler::advanceClock();
+    }
+
+    if ((globalClock & 0xFFFF) == 0) {
+      Host_profile::heartbeat(globalClock, get_insts_left());
+      Stats_mirror::update(globalClock, Host_profile::get_insts());
+    }
+  }
+
+  Stats_mirror::update(globalClock, Host_profile::get_insts());
+  Stats_mirror::close();
+}
+
+uint64_t TaskHandler::get_insts_left() {
+  absl::flat_hash_set<const Emul_base*> seen;  // several harts can share one emul
+
+  uint64_t left = 0;
+  for (const auto& e : emuls) {
+    if (e && seen.insert(e.get()).second) {
+      left += e->get_insts_left();
+    }
   }
+  return left;
 }
 
 void TaskHandler::unboot()
@@ -229,6 +269,7 @@ void TaskHandler::unplug()
       } else {
         simus[i]->snap->calculate_ipc();
         simus[i]->snap->window_frequency();
+        simus[i]->snap->save();
       }
     }
   }
@@ -63,4 +63,6 @@ public:
   static void unplug();
 
   static void syncStats();
+
+  static uint64_t get_insts_left();  // 0 when unknown
 };
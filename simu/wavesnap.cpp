@@ -2,175 +2,188 @@
 
 #include "wavesnap.hpp"
 
+#include <algorithm>
 #include <cmath>
-
-static const std::string opcode_mapping{"0123456789abcdefghijklmnopqrstuvwxyzABCDEFHIJKLMNPQRSTUVWXYZ"};
+#include <cstring>
+#include <fstream>
+#include <iostream>
 
 Wavesnap::Wavesnap() {
-  this->window_pointer         = 0;
-  this->update_count           = 0;
-  this->first_window_completed = false;
-  this->signature_count        = 0;
-  this->current_encoding       = "";
-#ifdef RECORD_ONCE
-  for (uint64_t i = 0; i < HASH_SIZE; i++) {
-    this->signature_hit.push_back(false);
+  this->ring.resize(MAX_MOVING_GRAPH_NODES);
+  this->ncommitted      = 0;
+  this->rolling         = 0;
+  this->signature_count = 0;
+  this->table_used      = 0;
+  this->dropped         = 0;
+  this->table.resize(SIGNATURE_MIN_SIZE, Signature{0, 0, no_cycles});
+
+  this->base_pow = 1;
+  for (uint32_t i = 1; i < MAX_MOVING_GRAPH_NODES; i++) {
+    this->base_pow *= HASH_BASE;
   }
-#endif
 }
 
-uint64_t Wavesnap::hash(std::string signature, uint64_t more) {
-  uint64_t hash = HASH_SEED + more;
-  for (uint32_t i = 0; i < signature.length(); i++) {
-    hash = (hash * 101 + (uint32_t)signature[i]) % HASH_SIZE;
-  }
+uint64_t Wavesnap::mix(uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return x ? x : 1;  // 0 marks the empty slots
+}
 
-  return hash;
+size_t Wavesnap::memory_used() const {
+  return table.size() * sizeof(Signature) + cycle_pool.size() * sizeof(Stage_cycles);
 }
 
-void Wavesnap::record_pipe(pipeline_info* next) {
-#ifdef HASHED_RECORD
-  uint64_t index = this->current_hash;
-#else
-  std::string index = this->current_encoding;
-#endif
-
-  this->signature_count++;
-
-  this->window_sign_info[index];
-  pipeline_info* pipe_info = &(this->window_sign_info[index]);
-  if (pipe_info->execute_cycles.size() == 0) {
-#ifdef RECORD_ONCE
-    if (pipe_info->count == 0) {
-      pipe_info->count = 2;
-    } else {
-      pipe_info->count++;
+Wavesnap::Signature* Wavesnap::lookup(uint64_t sign, bool insert) {
+  auto mask = table.size() - 1;
+  for (auto i = sign & mask;; i = (i + 1) & mask) {
+    auto& s = table[i];
+    if (s.sign == sign) {
+      return &s;
     }
+    if (s.sign == 0) {
+      if (!insert) {
+        return nullptr;
+      }
+      if (2 * (table_used + 1) > table.size()) {
+        if (memory_used() + table.size() * sizeof(Signature) > SIGNATURE_MEM_CAP) {
+          dropped++;
+          return nullptr;
+        }
+        grow();
+        return lookup(sign, true);
+      }
+      s.sign   = sign;
+      s.count  = 0;
+      s.cycles = no_cycles;
+      table_used++;
+      return &s;
+    }
+  }
+}
 
-    if (pipe_info->count > COUNT_ALLOW) {
-      *pipe_info = *next;
+const Wavesnap::Signature* Wavesnap::find(uint64_t sign) const {
+  auto mask = table.size() - 1;
+  for (auto i = sign & mask;; i = (i + 1) & mask) {
+    if (table[i].sign == sign) {
+      return &table[i];
     }
-#else
-    *pipe_info = *next;
-#endif
-  } else {
-    pipe_info->count++;
-#ifndef RECORD_ONCE
-    for (uint32_t j = 0; j < pipe_info->execute_cycles.size(); j++) {
-      pipe_info->wait_cycles[j] += next->wait_cycles[j];
-      pipe_info->rename_cycles[j] += next->rename_cycles[j];
-      pipe_info->issue_cycles[j] += next->issue_cycles[j];
-      pipe_info->execute_cycles[j] += next->execute_cycles[j];
-      pipe_info->commit_cycles[j] += next->commit_cycles[j];
+    if (table[i].sign == 0) {
+      return nullptr;
     }
-#endif
   }
 }
 
-void Wavesnap::add_pipeline_info(pipeline_info* pipe_info, Instruction_info* d) {
-  uint64_t min_time = this->dinst_info[wait_buffer[0]].fetched_time;
+const Wavesnap::Stage_cycles* Wavesnap::get_cycles(const Signature& s) const {
+  if (s.cycles == no_cycles) {
+    return nullptr;
+  }
+  return &cycle_pool[s.cycles];
+}
+
+void Wavesnap::grow() {
+  std::vector<Signature> old(table.size() * 2, Signature{0, 0, no_cycles});
+  old.swap(table);
 
-  pipe_info->wait_cycles.push_back(d->fetched_time - min_time);
-  pipe_info->rename_cycles.push_back(d->renamed_time - d->fetched_time);
-  pipe_info->issue_cycles.push_back(d->issued_time - d->renamed_time);
-  pipe_info->execute_cycles.push_back(d->executed_time - d->issued_time);
-  pipe_info->commit_cycles.push_back(d->committed_time - d->executed_time);
+  auto mask = table.size() - 1;
+  for (const auto& s : old) {
+    if (s.sign == 0) {
+      continue;
+    }
+    auto i = s.sign & mask;
+    while (table[i].sign != 0) {
+      i = (i + 1) & mask;
+    }
+    table[i] = s;
+  }
 }
 
-void Wavesnap::add_instruction(Dinst* dinst) {
-  wait_buffer.push_back(dinst->getID());
-  completed.push_back(false);
+void Wavesnap::record(Signature* s) {
+  if (memory_used() + MAX_MOVING_GRAPH_NODES * sizeof(Stage_cycles) > SIGNATURE_MEM_CAP) {
+    return;
+  }
+
+  s->cycles = cycle_pool.size();
+
+  // the window starts at the oldest instruction in the ring
+  const auto& first    = ring[ncommitted % MAX_MOVING_GRAPH_NODES];
+  uint64_t    min_time = first.fetched_time;
+  for (uint32_t j = 0; j < MAX_MOVING_GRAPH_NODES; j++) {
+    const auto& d = ring[(ncommitted + j) % MAX_MOVING_GRAPH_NODES];
+
+    Stage_cycles c;
+    c.wait    = d.fetched_time - min_time;
+    c.rename  = d.renamed_time - d.fetched_time;
+    c.issue   = d.issued_time - d.renamed_time;
+    c.execute = d.executed_time - d.issued_time;
+    c.commit  = d.committed_time - d.executed_time;
+    cycle_pool.push_back(c);
+  }
 }
 
-Instruction_info Wavesnap::extract_inst_info(Dinst* dinst, uint64_t committed) {
+Instruction_info Wavesnap::extract_inst_info(Dinst* dinst, uint64_t committed_time) {
   Instruction_info result;
 
   result.fetched_time   = dinst->getFetchedTime();
   result.renamed_time   = dinst->getRenamedTime();
   result.issued_time    = dinst->getIssuedTime();
   result.executed_time  = dinst->getExecutedTime();
-  result.committed_time = committed;
+  result.committed_time = committed_time;
   result.opcode         = dinst->getInst()->getOpcode();
   result.pc             = dinst->getPC();
+  result.id             = dinst->getID();
   return result;
 }
 
-void Wavesnap::update_window(Dinst* dinst, uint64_t committed) {
-  // update instruction as completed
-  bool     found = false;
-  uint64_t i     = dinst->getID();
-  uint64_t id    = i;
-  if (i > this->wait_buffer.size()) {
-    i = this->wait_buffer.size() - 1;
+void Wavesnap::update_window(Dinst* dinst, uint64_t committed_time) { commit(extract_inst_info(dinst, committed_time)); }
+
+void Wavesnap::commit(const Instruction_info& d) {
+  auto  pos  = ncommitted % MAX_MOVING_GRAPH_NODES;
+  auto& slot = ring[pos];
+
+  // slide the rolling hash: drop the oldest opcode, add the new one
+  if (ncommitted >= MAX_MOVING_GRAPH_NODES) {
+    rolling -= (static_cast<uint64_t>(slot.opcode) + 1) * base_pow;
   }
-  while (!found) {
-    if (this->wait_buffer[i] == id) {
-      this->completed[i] = true;
-      found              = true;
+  rolling = rolling * HASH_BASE + static_cast<uint64_t>(d.opcode) + 1;
 
-      dinst_info[id] = extract_inst_info(dinst, committed);
-    }
-    i--;
+  slot = d;
+  ncommitted++;
+
+  if (ncommitted < MAX_MOVING_GRAPH_NODES) {
+    return;  // first window not completed yet
   }
 
-  // poll the very first window, wait until completed
-  if (!this->first_window_completed) {
-    this->first_window_completed = true;
-    for (uint32_t j = 0; j < MAX_MOVING_GRAPH_NODES; j++) {
-      if (!this->completed[j]) {
-        this->first_window_completed = false;
-        this->current_encoding       = "";
-        break;
-      } else {
-        const auto& d = (dinst_info[wait_buffer[j]]);
-        if (i < MAX_MOVING_GRAPH_NODES - 1) {
-          this->current_encoding += opcode_mapping[static_cast<int>(d.opcode)];
-        }
-      }
-    }
-  } else {
-    // after the first window completed, just check the last element
-    // of the window.
-    while (completed[MAX_MOVING_GRAPH_NODES - 1] && completed.size() >= MAX_MOVING_GRAPH_NODES) {
-      // add last instruction of the window
-      const auto& d = (dinst_info[wait_buffer[MAX_MOVING_GRAPH_NODES - 1]]);
-      this->current_encoding += opcode_mapping[static_cast<int>(d.opcode)];
-      this->current_hash = this->hash(this->current_encoding, d.pc);
-#ifndef RECORD_ONCE
-      pipeline_info next;
-      next.count = 1;
-      for (uint32_t i = 0; i < MAX_MOVING_GRAPH_NODES; i++) {
-        add_pipeline_info(&next, &(dinst_info[wait_buffer[i]]));
-      }
+  signature_count++;
 
-      // record
-      record_pipe(&next);
-#else
-#ifdef HASHED_RECORD
-      if (!signature_hit[this->current_hash]) {
-        signature_hit[this->current_hash] = true;
-      } else {
-        pipeline_info next;
-        for (uint32_t j = 0; j < MAX_MOVING_GRAPH_NODES; j++) {
-          add_pipeline_info(&next, &(dinst_info[wait_buffer[j]]));
-        }
+  auto* s = lookup(mix(rolling + d.pc), true);
+  if (s == nullptr) {
+    return;
+  }
+  s->count++;
+  if (s->count > COUNT_ALLOW && s->cycles == no_cycles) {
+    record(s);
+  }
+}
 
-        // record
-        record_pipe(&next);
-      }
-#else
-      std::cout << "RECORD_ONCE must be used with HASHED_RECORD defined" << std::endl;
-#endif
-#endif
-
-      // remove first instruction in the window and update stats
-      window_pointer++;
-      this->dinst_info.erase(this->wait_buffer[0]);
-      this->wait_buffer.erase(this->wait_buffer.begin());
-      this->completed.erase(this->completed.begin());
-      this->current_encoding.erase(this->current_encoding.begin());
+float Wavesnap::stage_ipc(const std::map<uint32_t, uint32_t>& c) {
+  bool     first_iter = true;
+  uint32_t f          = 0;
+  uint32_t total      = 0;
+  uint32_t zeros      = 0;
+  for (const auto& kv : c) {
+    uint32_t s = kv.first;
+    if (!first_iter && (s - f - 1) < INSTRUCTION_GAP) {
+      zeros += s - f - 1;
     }
+    f          = s;
+    first_iter = false;
+
+    total += kv.second;
   }
+  return 1.0 * total / (c.size() + zeros);
 }
 
 void Wavesnap::calculate_ipc() {
@@ -186,148 +199,42 @@ void Wavesnap::calculate_ipc() {
   float    total_commit_diff  = 0;
   uint64_t total_count        = 0;
 
-  for (auto& sign_kv : window_sign_info) {
-    pipeline_info pipe_info = sign_kv.second;
-    uint64_t      count     = pipe_info.count;
-    if (count <= COUNT_ALLOW) {
+  for (const auto& sign : table) {
+    if (sign.sign == 0 || sign.count <= COUNT_ALLOW || sign.cycles == no_cycles) {
       continue;
     }
+    uint64_t count = sign.count;
 
     total_count += count;
-    // average the cycles
+
+    // count cycles at each stage
     std::map<uint32_t, uint32_t> w_c;
     std::map<uint32_t, uint32_t> r_c;
     std::map<uint32_t, uint32_t> i_c;
     std::map<uint32_t, uint32_t> e_c;
     std::map<uint32_t, uint32_t> c_c;
-    w_c.clear();
-    r_c.clear();
-    i_c.clear();
-    e_c.clear();
-    c_c.clear();
-
-    for (uint32_t j = 0; j < pipe_info.execute_cycles.size(); j++) {
-      // average
-      uint32_t w, r, i, e, c;
-#ifdef RECORD_ONCE
-      w = pipe_info.wait_cycles[j];
-      r = pipe_info.rename_cycles[j];
-      i = pipe_info.issue_cycles[j];
-      e = pipe_info.execute_cycles[j];
-      c = pipe_info.commit_cycles[j];
-#else
-      w = pipe_info.wait_cycles[j] / count;
-      r = pipe_info.rename_cycles[j] / count;
-      i = pipe_info.issue_cycles[j] / count;
-      e = pipe_info.execute_cycles[j] / count;
-      c = pipe_info.commit_cycles[j] / count;
-#endif
-
-      // count cycles at each stage
-      // wait cycles
-      uint32_t f = w;
-      w_c[f];
+
+    const auto* cycles = get_cycles(sign);
+    for (uint32_t j = 0; j < MAX_MOVING_GRAPH_NODES; j++) {
+      const auto& c = cycles[j];
+
+      uint32_t f = c.wait;
       w_c[f]++;
-      // rename
-      f += r;
-      r_c[f];
+      f += c.rename;
       r_c[f]++;
-      // issue
-      f += i;
-      i_c[f];
+      f += c.issue;
       i_c[f]++;
-      // execute
-      f += e;
-      e_c[f];
+      f += c.execute;
       e_c[f]++;
-      // commit
-      f += c;
-      c_c[f];
+      f += c.commit;
       c_c[f]++;
     }
 
-    // calculate ipc at each stage
-    bool     first_iter;
-    uint32_t f, s, total, zeros;
-    // fetch:
-    total      = 0;
-    zeros      = 0;
-    first_iter = true;
-    for (auto& kv : w_c) {
-      s = kv.first;
-      if (!first_iter && (s - f - 1) < INSTRUCTION_GAP) {
-        zeros += s - f - 1;
-      }
-      f          = s;
-      first_iter = false;
-
-      total += kv.second;
-    }
-    float fetch_ipc = 1.0 * total / (w_c.size() + zeros);
-
-    // rename:
-    total      = 0;
-    zeros      = 0;
-    first_iter = true;
-    for (auto& kv : r_c) {
-      s = kv.first;
-      if (!first_iter && (s - f - 1) < INSTRUCTION_GAP) {
-        zeros += s - f - 1;
-      }
-      f          = s;
-      first_iter = false;
-
-      total += kv.second;
-    }
-    float rename_ipc = 1.0 * total / (r_c.size() + zeros);
-
-    // issue
-    total      = 0;
-    zeros      = 0;
-    first_iter = true;
-    for (auto& kv : i_c) {
-      s = kv.first;
-      if (!first_iter && (s - f - 1) < INSTRUCTION_GAP) {
-        zeros += s - f - 1;
-      }
-      f          = s;
-      first_iter = false;
-
-      total += kv.second;
-    }
-    float issue_ipc = 1.0 * total / (i_c.size() + zeros);
-
-    // execute
-    total      = 0;
-    zeros      = 0;
-    first_iter = true;
-    for (auto& kv : e_c) {
-      s = kv.first;
-      if (!first_iter && (s - f - 1) < INSTRUCTION_GAP) {
-        zeros += s - f - 1;
-      }
-      f          = s;
-      first_iter = false;
-
-      total += kv.second;
-    }
-    float execute_ipc = 1.0 * total / (e_c.size() + zeros);
-
-    // commit
-    total      = 0;
-    zeros      = 0;
-    first_iter = true;
-    for (auto& kv : c_c) {
-      s = kv.first;
-      if (!first_iter && (s - f - 1) < INSTRUCTION_GAP) {
-        zeros += s - f - 1;
-      }
-      f          = s;
-      first_iter = false;
-
-      total += kv.second;
-    }
-    float commit_ipc = 1.0 * total / (c_c.size() + zeros);
+    float fetch_ipc   = stage_ipc(w_c);
+    float rename_ipc  = stage_ipc(r_c);
+    float issue_ipc   = stage_ipc(i_c);
+    float execute_ipc = stage_ipc(e_c);
+    float commit_ipc  = stage_ipc(c_c);
 
     // determine how much this signature contributes to the overall ipc
     // 1.accumulate diffs
@@ -352,6 +259,7 @@ void Wavesnap::calculate_ipc() {
   std::cout << "issue:   " << (1.0 * total_issue_ipc - total_issue_diff) / total_count << std::endl;
   std::cout << "execute: " << (1.0 * total_execute_ipc - total_execute_diff) / total_count << std::endl;
   std::cout << "commit:  " << (1.0 * total_commit_ipc - total_commit_diff) / total_count << std::endl;
+  std::cout << "signatures: " << table_used << " dropped: " << dropped << " bytes: " << memory_used() << std::endl;
   std::cout << "------------------------------------------" << std::endl;
 }
 // WINDOW BASED IPC END
@@ -467,72 +375,15 @@ void Wavesnap::calculate_single_window_ipc() {
   std::cout << "--------------------" << std::endl;
 }
 // FULL IPC END
-/////////////////////////////////
-
-void Wavesnap::test_uncompleted() {
-  std::cout << "testing uncompleted instructions... wait buffer size = " << this->wait_buffer.size() << std::endl;
-  uint32_t count = 0;
-  for (uint64_t i = 0; i < completed.size(); i++) {
-    if (!completed[i]) {
-      std::cout << wait_buffer[i] << std::endl;
-      count++;
-    }
-  }
-  std::cout << "uncomleted instruction = " << count << std::endl;
-}
-
-void Wavesnap::add_to_RAT(Dinst* dinst) {
-  uint64_t dst, src1, src2;
-  if (dinst->getInst()->isStore()) {
-    // dst =  ((uint64_t)dinst->getAddr()%HASH_SIZE)+REGISTER_NUM;
-    dst  = ((uint64_t)dinst->getAddr()) + REGISTER_NUM;
-    src1 = (uint32_t)dinst->getInst()->getSrc1();
-    src2 = (uint32_t)dinst->getInst()->getSrc2();
-  } else if (dinst->getInst()->isLoad()) {
-    dst  = (uint32_t)dinst->getInst()->getDst1();
-    src1 = (uint32_t)dinst->getInst()->getSrc1();
-    src2 = ((uint64_t)dinst->getAddr()) + REGISTER_NUM;
-  } else if (dinst->getInst()->isControl()) {
-    // todo
-    dst  = (uint32_t)dinst->getInst()->getDst1();
-    src1 = (uint32_t)dinst->getInst()->getSrc1();
-    src2 = (uint32_t)dinst->getInst()->getSrc2();
-    /*
-    std::cout << dinst->getInst()->getOpcodeName() << " ";
-    std::cout << dst << ",";
-    std::cout << src1 << ",";
-    std::cout << src2 << "," << std::endl;*/
-  } else {
-    dst  = (uint32_t)dinst->getInst()->getDst1();
-    src1 = (uint32_t)dinst->getInst()->getSrc1();
-    src2 = (uint32_t)dinst->getInst()->getSrc2();
-  }
-
-  if (true) {
-    RAT[dst];
-    RAT[dst].valid       = true;
-    RAT[dst].id          = (uint32_t)dinst->getID() + 1;
-    RAT[dst].dst         = dst;
-    RAT[dst].src1        = src1;
-    RAT[dst].src2        = src2;
-    RAT[dst].opcode_name = dinst->getInst()->getOpcodeName();
-    RAT[dst].opcode      = (uint32_t)dinst->getInst()->getOpcode();
-    RAT[dst].time_stamp  = (uint64_t)globalClock;
-  }
-}
-
-void Wavesnap::merge() {
-  // TODO
-}
 
 void Wavesnap::window_frequency() {
   uint8_t threshold = 80;
 
   std::vector<uint64_t> counts;
-  for (auto& sign_kv : window_sign_info) {
-    pipeline_info pipe_info = sign_kv.second;
-    uint64_t      count     = pipe_info.count;
-    counts.push_back(count);
+  for (const auto& sign : table) {
+    if (sign.sign) {
+      counts.push_back(sign.count);
+    }
   }
 
   std::sort(counts.rbegin(), counts.rend());
@@ -561,32 +412,86 @@ void Wavesnap::window_frequency() {
   std::cout << "********************" << std::endl;
 }
 
-std::string Wavesnap::break_into_bytes(uint64_t n, uint8_t byte_num) {
-  std::string result = "";
-  while (byte_num > 0) {
-    result = (char)(n & 0x00FF) + result;
-    n      = n >> 8;
-    byte_num--;
+bool Wavesnap::save(const std::string& path) const {
+  std::ofstream out(path, std::ios::binary);
+  if (!out) {
+    return false;
   }
 
-  return result;
-}
+  uint32_t window = MAX_MOVING_GRAPH_NODES;
+  uint64_t nsign  = table_used;
+  out.write("WSNP", 4);
+  out.write(reinterpret_cast<const char*>(&version), sizeof(version));
+  out.write(reinterpret_cast<const char*>(&window), sizeof(window));
+  out.write(reinterpret_cast<const char*>(&nsign), sizeof(nsign));
+  out.write(reinterpret_cast<const char*>(&signature_count), sizeof(signature_count));
 
-void Wavesnap::save() {
-  std::ofstream outfile;
-  outfile.open(DUMP_PATH);
-  for (auto& sign_kv : window_sign_info) {
-    outfile << sign_kv.first;
-    outfile << break_into_bytes(sign_kv.second.count, 4);
-    for (uint32_t i = 0; i < MAX_MOVING_GRAPH_NODES; i++) {
-      outfile << break_into_bytes(sign_kv.second.wait_cycles[i], 4);
-      outfile << break_into_bytes(sign_kv.second.rename_cycles[i], 4);
-      outfile << break_into_bytes(sign_kv.second.issue_cycles[i], 4);
-      outfile << break_into_bytes(sign_kv.second.execute_cycles[i], 4);
-      outfile << break_into_bytes(sign_kv.second.commit_cycles[i], 4);
+  for (const auto& s : table) {
+    if (s.sign == 0) {
+      continue;
+    }
+    uint32_t recorded = s.cycles != no_cycles;
+    out.write(reinterpret_cast<const char*>(&s.sign), sizeof(s.sign));
+    out.write(reinterpret_cast<const char*>(&s.count), sizeof(s.count));
+    out.write(reinterpret_cast<const char*>(&recorded), sizeof(recorded));
+    if (recorded) {
+      out.write(reinterpret_cast<const char*>(&cycle_pool[s.cycles]), MAX_MOVING_GRAPH_NODES * sizeof(Stage_cycles));
     }
   }
-  outfile.close();
+
+  return static_cast<bool>(out);
 }
 
-void Wavesnap::load() {}
+bool Wavesnap::load(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    return false;
+  }
+
+  char     magic[4];
+  uint32_t ver    = 0;
+  uint32_t window = 0;
+  uint64_t nsign  = 0;
+  uint64_t nwin   = 0;
+  in.read(magic, 4);
+  in.read(reinterpret_cast<char*>(&ver), sizeof(ver));
+  in.read(reinterpret_cast<char*>(&window), sizeof(window));
+  in.read(reinterpret_cast<char*>(&nsign), sizeof(nsign));
+  in.read(reinterpret_cast<char*>(&nwin), sizeof(nwin));
+  if (!in || std::memcmp(magic, "WSNP", 4) != 0 || ver != version || window != MAX_MOVING_GRAPH_NODES) {
+    std::cerr << "wavesnap: " << path << " is not a version " << version << " dump with " << MAX_MOVING_GRAPH_NODES
+              << " instruction windows" << std::endl;
+    return false;
+  }
+
+  table.assign(SIGNATURE_MIN_SIZE, Signature{0, 0, no_cycles});
+  table_used      = 0;
+  dropped         = 0;
+  signature_count = nwin;
+  cycle_pool.clear();
+
+  for (uint64_t n = 0; n < nsign; n++) {
+    uint64_t sign;
+    uint32_t count;
+    uint32_t recorded;
+    in.read(reinterpret_cast<char*>(&sign), sizeof(sign));
+    in.read(reinterpret_cast<char*>(&count), sizeof(count));
+    in.read(reinterpret_cast<char*>(&recorded), sizeof(recorded));
+    if (!in) {
+      return false;
+    }
+
+    auto* s = lookup(sign, true);
+    if (s == nullptr) {
+      return false;
+    }
+    s->count = count;
+    if (recorded) {
+      s->cycles = cycle_pool.size();
+      cycle_pool.resize(cycle_pool.size() + MAX_MOVING_GRAPH_NODES);
+      in.read(reinterpret_cast<char*>(&cycle_pool[s->cycles]), MAX_MOVING_GRAPH_NODES * sizeof(Stage_cycles));
+    }
+  }
+
+  return static_cast<bool>(in);
+}
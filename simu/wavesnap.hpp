@@ -6,49 +6,33 @@
 // general Wavesnap defines
 #define SINGLE_WINDOW false
 #define WITH_SAMPLING true
-#define RECORD_ONCE
-#define HASHED_RECORD
-
-// signature defines
-#define REGISTER_NUM 32
 
 // instruction window defines
-#define MAX_NODE_NUM           1000
-#define MAX_EDGE_NUM           1000000
 #define MAX_MOVING_GRAPH_NODES 512
 
 // ipc calculation defines
 #define COUNT_ALLOW     10
 #define INSTRUCTION_GAP 100
 
-// dump path
-#define DUMP_PATH "dump.txt"
+// dump paths
+#define DUMP_PATH      "dump.txt"
+#define SIGNATURE_PATH "wavesnap.bin"
 
-// encode instructions
-#define HASH_SEED 0x2345
-#define HASH_SIZE 0XFFFF
+// signature table defines
+#define HASH_BASE          0x100000001b3ULL
+#define SIGNATURE_MEM_CAP  (256ULL << 20)  // bytes of signatures and recorded windows
+#define SIGNATURE_MIN_SIZE 4096
 
 #include <stdint.h>
 #include <stdio.h>
 
-#include <fstream>
-#include <iomanip>
-#include <iostream>
 #include <map>
-#include <sstream>
 #include <string>
 #include <vector>
 
 #include "dinst.hpp"
 #include "opcode.hpp"
 
-/*
-#include <boost/archive/text_iarchive.hpp>
-#include <boost/archive/text_oarchive.hpp>
-#include <boost/serialization/map.hpp>
-#include <boost/serialization/string.hpp>
-#include <boost/serialization/vector.hpp>
-*/
 class Instruction_info {
 public:
   uint64_t pc;
@@ -72,110 +56,69 @@ public:
   }
 };
 
+// Window signatures of the committed instructions. The last
+// MAX_MOVING_GRAPH_NODES committed instructions sit in a flat ring, and the
+// opcodes of the window are folded in a 64 bit rolling hash (plus the PC of
+// the youngest instruction) that slides with each commit. Signatures live in
+// an open addressing table; the COUNT_ALLOW+1th time a signature is seen, the
+// stage cycles of its window are recorded. Once the table and the recorded
+// windows reach SIGNATURE_MEM_CAP bytes, new signatures are dropped.
+//
+// save() writes the table in a binary file (little endian):
+//
+//   header:    "WSNP", uint32 version, uint32 window, uint64 nsignatures,
+//              uint64 windows
+//   signature: uint64 signature, uint32 count, uint32 recorded, and when
+//              recorded window * 5 uint32 (wait, rename, issue, execute,
+//              commit cycles of each instruction)
+//
+// and load() reads it back.
 class Wavesnap {
-private:
-  class dependence_info {
+public:
+  class Stage_cycles {
   public:
-    uint32_t    id;
-    uint32_t    dst;
-    uint32_t    src1;
-    uint32_t    src2;
-    uint32_t    parent1_id;
-    uint32_t    parent2_id;
-    uint32_t    depth;
-    bool        valid;
-    std::string opcode_name;
-    uint32_t    opcode;
-    uint64_t    time_stamp;
-
-    dependence_info() {
-      this->id         = 0;
-      this->dst        = 0;
-      this->src1       = 0;
-      this->src2       = 0;
-      this->parent1_id = 0;
-      this->parent2_id = 0;
-      this->depth      = 0;
-      this->valid      = false;
-      this->time_stamp = 0;
-    }
-
-    std::string dump() {
-      std::stringstream result;
-
-      result << "(";
-      result << id << ", ";
-      result << dst << ", ";
-      result << src1 << ", ";
-      result << src2 << ", ";
-      result << parent1_id << ", ";
-      result << parent2_id << ", ";
-      result << depth << ")";
-
-      return result.str();
-    }
+    uint32_t wait;
+    uint32_t rename;
+    uint32_t issue;
+    uint32_t execute;
+    uint32_t commit;
   };
 
-  class pipeline_info {
-  private:
-    /*
-    friend class boost::serialization::access;
-    template<class Archive>
-    void serialize(Archive & ar, const unsigned int version) {
-      ar & this->wait_cycles;
-      ar & this->rename_cycles;
-      ar & this->issue_cycles;
-      ar & this->execute_cycles;
-      ar & this->commit_cycles;
-      ar & encode;
-      ar & count;
-    }
-    */
+  class Signature {
   public:
-    std::vector<uint32_t> wait_cycles;
-    std::vector<uint32_t> rename_cycles;
-    std::vector<uint32_t> issue_cycles;
-    std::vector<uint32_t> execute_cycles;
-    std::vector<uint32_t> commit_cycles;
-    std::string           encode;
-    uint32_t              count;
-
-    pipeline_info() {
-      this->count  = 0;
-      this->encode = "";
-      this->wait_cycles.clear();
-      this->rename_cycles.clear();
-      this->issue_cycles.clear();
-      this->execute_cycles.clear();
-    }
+    uint64_t sign;    // 0 is an empty slot
+    uint32_t count;   // windows with this signature
+    uint32_t cycles;  // first entry in cycle_pool, no_cycles if not recorded
   };
 
-  // private methods and member variables
-  void     record_pipe(pipeline_info* next);
-  void     add_pipeline_info(pipeline_info* pipe_info, Instruction_info* dinst);
-  uint64_t hash(std::string signature, uint64_t more);
-#ifdef RECORD_ONCE
-  std::vector<bool> signature_hit;
-#endif
+  static constexpr uint32_t no_cycles = UINT32_MAX;
+  static constexpr uint32_t version   = 1;
+
+private:
+  std::vector<Instruction_info> ring;
+  uint64_t                      ncommitted;  // instructions in the ring so far
+  uint64_t                      rolling;     // hash of the opcodes in the ring
+  uint64_t                      base_pow;    // HASH_BASE^(MAX_MOVING_GRAPH_NODES-1)
+
+  std::vector<Signature>    table;
+  size_t                    table_used;
+  std::vector<Stage_cycles> cycle_pool;
+  uint64_t                  dropped;
+
+  static uint64_t mix(uint64_t x);
+  static float    stage_ipc(const std::map<uint32_t, uint32_t>& c);
+
+  [[nodiscard]] size_t memory_used() const;
+  Signature*           lookup(uint64_t sign, bool insert);
+  void                 grow();
+  void                 record(Signature* s);
 
 public:
   Wavesnap();
 
   // many windows
-  void                                 update_window(Dinst* dinst, uint64_t committed);
-  void                                 add_instruction(Dinst* dinst);
-  bool                                 first_window_completed;
-  uint64_t                             last_removed_id;
-  uint64_t                             update_count;
-  std::vector<uint64_t>                wait_buffer;
-  std::vector<bool>                    completed;
-  pipeline_info                        working_window;
-  std::map<uint64_t, Instruction_info> dinst_info;
-  uint64_t                             window_pointer;
-  std::string                          current_encoding;
-#ifdef HASHED_RECORD
-  uint64_t current_hash;
-#endif
+  void update_window(Dinst* dinst, uint64_t committed);
+  void commit(const Instruction_info& d);
 
   // single huge window, good for debeging
   void                         update_single_window(Dinst* dinst, uint64_t committed);
@@ -188,23 +131,18 @@ public:
   // stats methods
   void calculate_single_window_ipc();
   void calculate_ipc();
-  void test_uncompleted();
   void window_frequency();
 
   // other
   Instruction_info extract_inst_info(Dinst* dinst, uint64_t committed);
-  void             add_to_RAT(Dinst* dinst);
-  void             merge();
-#ifdef HASHED_RECORD
-  std::map<uint64_t, pipeline_info> window_sign_info;
-#elif
-  std::map<std::string, pipeline_info> window_sign_info;
-#endif
-  uint64_t                            signature_count;
-  std::map<uint64_t, dependence_info> RAT;
+  uint64_t         signature_count;  // windows seen
+
+  [[nodiscard]] const Signature*    find(uint64_t sign) const;
+  [[nodiscard]] const Stage_cycles* get_cycles(const Signature& s) const;
+  [[nodiscard]] size_t              get_num_signatures() const { return table_used; }
+  [[nodiscard]] uint64_t            get_dropped() const { return dropped; }
 
   // dumping and reading
-  std::string break_into_bytes(uint64_t n, uint8_t byte_num);
-  void        save();
-  void        load();
+  bool save(const std::string& path = SIGNATURE_PATH) const;
+  bool load(const std::string& path = SIGNATURE_PATH);
 };
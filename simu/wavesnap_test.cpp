@@ -0,0 +1,137 @@
+// This file is distributed under the BSD 3-Clause License. See LICENSE for details.
+
+#include "wavesnap.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+class Wavesnap_test : public ::testing::Test {
+protected:
+  class Record {
+  public:
+    uint32_t              count;
+    std::vector<uint32_t> cycles;  // window * 5 stage cycles, empty if not recorded
+
+    bool operator==(const Record&) const = default;
+  };
+  using Dump = std::map<uint64_t, Record>;
+
+  // A loop of period instructions committed n times, with stage cycles that
+  // depend on the position in the loop
+  static void run(Wavesnap& w, uint32_t period, uint32_t n) {
+    static constexpr Opcode ops[] = {Opcode::iAALU, Opcode::iLALU_LD, Opcode::iSALU_ST, Opcode::iBALU_LBRANCH, Opcode::iCALU_MULT};
+
+    uint64_t clock = 1000;
+    for (uint32_t i = 0; i < n; i++) {
+      auto             pos = i % period;
+      Instruction_info d;
+      d.pc             = 0x1000 + 4 * pos;
+      d.opcode         = ops[(pos * 7) % std::size(ops)];
+      d.id             = i;
+      d.fetched_time   = clock;
+      d.renamed_time   = clock + 2;
+      d.issued_time    = clock + 3 + pos % 3;
+      d.executed_time  = d.issued_time + 1 + pos % 5;
+      d.committed_time = d.executed_time + 4;
+      w.commit(d);
+      clock += 1 + (pos % 4 == 0);
+    }
+  }
+
+  // Parses the documented file format
+  static Dump parse(const std::string& path, uint64_t& nwin) {
+    std::ifstream in(path, std::ios::binary);
+
+    char     magic[4];
+    uint32_t ver;
+    uint32_t window;
+    uint64_t nsign;
+    in.read(magic, 4);
+    in.read(reinterpret_cast<char*>(&ver), sizeof(ver));
+    in.read(reinterpret_cast<char*>(&window), sizeof(window));
+    in.read(reinterpret_cast<char*>(&nsign), sizeof(nsign));
+    in.read(reinterpret_cast<char*>(&nwin), sizeof(nwin));
+    EXPECT_EQ(std::memcmp(magic, "WSNP", 4), 0);
+    EXPECT_EQ(ver, Wavesnap::version);
+    EXPECT_EQ(window, MAX_MOVING_GRAPH_NODES);
+
+    Dump dump;
+    for (uint64_t n = 0; n < nsign; n++) {
+      uint64_t sign;
+      uint32_t recorded;
+      Record   r;
+      in.read(reinterpret_cast<char*>(&sign), sizeof(sign));
+      in.read(reinterpret_cast<char*>(&r.count), sizeof(r.count));
+      in.read(reinterpret_cast<char*>(&recorded), sizeof(recorded));
+      if (recorded) {
+        r.cycles.resize(MAX_MOVING_GRAPH_NODES * 5);
+        in.read(reinterpret_cast<char*>(r.cycles.data()), r.cycles.size() * sizeof(uint32_t));
+      }
+      dump[sign] = r;
+    }
+    EXPECT_TRUE(static_cast<bool>(in));
+    EXPECT_EQ(in.peek(), EOF);
+    return dump;
+  }
+};
+
+TEST_F(Wavesnap_test, save_load_round_trip) {
+  static constexpr uint32_t period = 37;
+
+  Wavesnap w;
+  run(w, period, MAX_MOVING_GRAPH_NODES + period * 30);
+
+  // Every loop position starts a window seen 30 times, recorded after COUNT_ALLOW
+  EXPECT_EQ(w.get_num_signatures(), period);
+  EXPECT_EQ(w.signature_count, period * 30 + 1);
+  EXPECT_EQ(w.get_dropped(), 0U);
+  ASSERT_TRUE(w.save("wavesnap_test_a.bin"));
+
+  uint64_t nwin_a = 0;
+  auto     a      = parse("wavesnap_test_a.bin", nwin_a);
+  ASSERT_EQ(a.size(), period);
+  EXPECT_EQ(nwin_a, w.signature_count);
+  for (const auto& [sign, r] : a) {
+    EXPECT_GT(r.count, COUNT_ALLOW);
+    EXPECT_FALSE(r.cycles.empty());
+  }
+
+  Wavesnap l;
+  ASSERT_TRUE(l.load("wavesnap_test_a.bin"));
+  EXPECT_EQ(l.get_num_signatures(), w.get_num_signatures());
+  EXPECT_EQ(l.signature_count, w.signature_count);
+  for (const auto& [sign, r] : a) {
+    const auto* s = l.find(sign);
+    ASSERT_NE(s, nullptr);
+    EXPECT_EQ(s->count, r.count);
+
+    const auto* c = l.get_cycles(*s);
+    ASSERT_NE(c, nullptr);
+    EXPECT_EQ(std::memcmp(c, r.cycles.data(), r.cycles.size() * sizeof(uint32_t)), 0);
+  }
+
+  // Saving what was loaded gives the same signatures and windows
+  ASSERT_TRUE(l.save("wavesnap_test_b.bin"));
+  uint64_t nwin_b = 0;
+  EXPECT_EQ(parse("wavesnap_test_b.bin", nwin_b), a);
+  EXPECT_EQ(nwin_b, nwin_a);
+
+  // Loading keeps counting on the restored table
+  run(l, period, period);
+  EXPECT_EQ(l.get_num_signatures(), period);
+}
+
+TEST_F(Wavesnap_test, load_rejects_other_files) {
+  {
+    std::ofstream out("wavesnap_test_bad.bin", std::ios::binary);
+    out << "not a wavesnap dump";
+  }
+
+  Wavesnap w;
+  EXPECT_FALSE(w.load("wavesnap_test_bad.bin"));
+  EXPECT_FALSE(w.load("wavesnap_test_missing.bin"));
+}